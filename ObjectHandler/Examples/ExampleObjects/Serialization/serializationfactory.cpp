@@ -36,6 +36,8 @@
 #include <boost/filesystem.hpp>
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/archive/xml_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
 #include <boost/serialization/variant.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/shared_ptr.hpp>
@@ -72,4 +74,20 @@ namespace AccountExample {
         ar >> boost::serialization::make_nvp("object_list", valueObjects);
     }
 
+    void SerializationFactory::register_out(boost::archive::binary_oarchive &ar,
+        std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects) {
+        ar.register_type<ObjectHandler::ValueObjects::ohRange>();
+        ar.register_type<AccountExample::AccountValueObject>();
+        ar.register_type<AccountExample::CustomerValueObject>();
+        ar << boost::serialization::make_nvp("object_list", valueObjects);
+    }
+
+    void SerializationFactory::register_in(boost::archive::binary_iarchive &ar,
+        std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects) {
+        ar.register_type<ObjectHandler::ValueObjects::ohRange>();
+        ar.register_type<AccountExample::AccountValueObject>();
+        ar.register_type<AccountExample::CustomerValueObject>();
+        ar >> boost::serialization::make_nvp("object_list", valueObjects);
+    }
+
 }
@@ -175,56 +175,65 @@ code65 = '''\
 ##########################################################################
 
 code66 = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            return %(name)s_;\n'''
+            case %(propertyIndex)s:
+                return %(name)s_;\n'''
 
 code66a = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            return %(name)s_;\n'''
+            case %(propertyIndex)s:
+                return %(name)s_;\n'''
 
 code67a = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = value;\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = value;
+                break;\n'''
 
 code67b = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::convert2<std::string>(value);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::convert2<std::string>(value);
+                break;\n'''
 
 code67c = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::convert2<%(nativeType)s>(value);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::convert2<%(nativeType)s>(value);
+                break;\n'''
 
 code67d = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::vector::convert2<ObjectHandler::property_t>(value, nameUpper);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::vector::convert2<ObjectHandler::property_t>(value, "%(nameUpper)s");
+                break;\n'''
 
 code67e = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::vector::convert2<std::string>(value, nameUpper);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::vector::convert2<std::string>(value, "%(nameUpper)s");
+                break;\n'''
 
 code67f = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::vector::convert2<%(nativeType)s>(value, nameUpper);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::vector::convert2<%(nativeType)s>(value, "%(nameUpper)s");
+                break;\n'''
 
 code67g = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::matrix::convert2<ObjectHandler::property_t>(value, nameUpper);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::matrix::convert2<ObjectHandler::property_t>(value, "%(nameUpper)s");
+                break;\n'''
 
 code67h = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::matrix::convert2<std::string>(value, nameUpper);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::matrix::convert2<std::string>(value, "%(nameUpper)s");
+                break;\n'''
 
 code67i = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::matrix::convert2<%(nativeType)s>(value, nameUpper);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::matrix::convert2<%(nativeType)s>(value, "%(nameUpper)s");
+                break;\n'''
 
 code69 = '''\
-            processPrecedentID(%(name)s);'''
+        processPrecedentID(%(name)s_);'''
 
 code70 = '''\
-            for (std::vector<std::string>::const_iterator i = %(name)s.begin();
-                    i != %(name)s.end(); ++i)
-                processPrecedentID(*i);'''
+        for (std::vector<std::string>::const_iterator i = %(name)s_->begin();
+                i != %(name)s_->end(); ++i)
+            processPrecedentID(*i);'''
 
 ##########################################################################
 # code common to mutiple addins
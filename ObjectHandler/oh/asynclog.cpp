@@ -0,0 +1,245 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <oh/config.hpp>
+#endif
+
+#include <oh/asynclog.hpp>
+#include <oh/exception.hpp>
+#include <vector>
+#include <algorithm>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread_time.hpp>
+#endif
+
+using boost::uint64_t;
+using std::string;
+
+namespace ObjectHandler {
+
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+
+    class AsyncLog::Impl {
+    public:
+        Impl(const Sink &sink, const Options &options)
+        : sink_(sink), options_(options), queue_(options.queueSize),
+          head_(0), count_(0), flushRequested_(false), stop_(false) {
+            thread_ = boost::thread(boost::bind(&Impl::run, this));
+        }
+
+        void stop() {
+            {
+                Lock lock(mutex_);
+                stop_ = true;
+            }
+            ready_.notify_one();
+            // the background thread writes what is queued before it returns
+            boost::lock_guard<boost::mutex> lock(stopMutex_);
+            if (thread_.joinable())
+                thread_.join();
+        }
+
+        void push(int level, const string &message) {
+            Lock lock(mutex_);
+            if (!stop_ && count_ == queue_.size()) {
+                if (options_.dropWhenFull) {
+                    ++statistics_.dropped;
+                    return;
+                }
+                ++statistics_.waits;
+                while (!stop_ && count_ == queue_.size())
+                    space_.wait(lock);
+            }
+            if (stop_) {
+                // the background thread is gone, or going, write the
+                // message here rather than leave it in the queue
+                lock.unlock();
+                try {
+                    sink_(level, message);
+                } catch (...) {}
+                return;
+            }
+            Entry &entry = queue_[(head_ + count_) % queue_.size()];
+            entry.level = level;
+            entry.message = message;
+            ++count_;
+            ++statistics_.queued;
+            statistics_.highWater = std::max<uint64_t>(statistics_.highWater, count_);
+            if (count_ == static_cast<std::size_t>(options_.batchSize))
+                ready_.notify_one();
+        }
+
+        void flush() {
+            Lock lock(mutex_);
+            uint64_t target = statistics_.queued;
+            flushRequested_ = true;
+            ready_.notify_one();
+            while (statistics_.written < target)
+                space_.wait(lock);
+        }
+
+        Statistics statistics() const {
+            Lock lock(mutex_);
+            return statistics_;
+        }
+
+    private:
+        typedef boost::unique_lock<boost::mutex> Lock;
+
+        struct Entry {
+            int level;
+            string message;
+        };
+
+        // The body of the background thread.
+        void run() {
+            std::vector<Entry> batch;
+            Lock lock(mutex_);
+            for (;;) {
+                boost::system_time deadline = boost::get_system_time()
+                    + boost::posix_time::milliseconds(options_.flushInterval);
+                while (!stop_ && !flushRequested_
+                       && count_ < static_cast<std::size_t>(options_.batchSize)) {
+                    if (!ready_.timed_wait(lock, deadline))
+                        break;
+                }
+                flushRequested_ = false;
+                if (count_ == 0) {
+                    if (stop_)
+                        return;
+                    continue;
+                }
+
+                // Take every queued message, swapping the strings out of
+                // the queue rather than copying them.
+                std::size_t n = count_;
+                batch.resize(n);
+                for (std::size_t i = 0; i < n; ++i) {
+                    Entry &entry = queue_[(head_ + i) % queue_.size()];
+                    batch[i].level = entry.level;
+                    batch[i].message.swap(entry.message);
+                }
+                head_ = (head_ + n) % queue_.size();
+                count_ = 0;
+                space_.notify_all();
+
+                lock.unlock();
+                for (std::size_t i = 0; i < n; ++i) {
+                    try {
+                        sink_(batch[i].level, batch[i].message);
+                    } catch (...) {}
+                    batch[i].message.clear();
+                }
+                lock.lock();
+
+                statistics_.written += n;
+                ++statistics_.batches;
+                space_.notify_all();
+            }
+        }
+
+        Sink sink_;
+        Options options_;
+        mutable boost::mutex mutex_;
+        // Serializes the calls to stop(), which join the background thread.
+        boost::mutex stopMutex_;
+        // Signals the background thread that a batch is ready.
+        boost::condition_variable ready_;
+        // Signals callers that space is available or that a batch was written.
+        boost::condition_variable space_;
+        std::vector<Entry> queue_;
+        std::size_t head_;
+        std::size_t count_;
+        bool flushRequested_;
+        bool stop_;
+        Statistics statistics_;
+        boost::thread thread_;
+    };
+
+    AsyncLog::AsyncLog(const Sink &sink, const Options &options) {
+        validate(options);
+        impl_.reset(new Impl(sink, options));
+    }
+
+    AsyncLog::~AsyncLog() {
+        try {
+            impl_->stop();
+        } catch (...) {}
+    }
+
+    void AsyncLog::push(int level, const string &message) {
+        // client applications log from within their catch() clauses so
+        // this function must not throw.
+        try {
+            impl_->push(level, message);
+        } catch (...) {}
+    }
+
+    void AsyncLog::flush() {
+        impl_->flush();
+    }
+
+    void AsyncLog::stop() {
+        impl_->stop();
+    }
+
+    AsyncLog::Statistics AsyncLog::statistics() const {
+        return impl_->statistics();
+    }
+
+#else
+
+    AsyncLog::AsyncLog(const Sink &, const Options &options) {
+        validate(options);
+        OH_FAIL("AsyncLog: asynchronous logging requires "
+                "ObjectHandler to be compiled with OH_ENABLE_THREAD_SAFE_REPOSITORY");
+    }
+
+    // No AsyncLog can be constructed in this build, the functions below
+    // exist only so that Logger links.
+
+    AsyncLog::~AsyncLog() {}
+
+    void AsyncLog::push(int, const string &) {}
+
+    void AsyncLog::flush() {}
+
+    void AsyncLog::stop() {}
+
+    AsyncLog::Statistics AsyncLog::statistics() const {
+        return Statistics();
+    }
+
+#endif
+
+    void AsyncLog::validate(const Options &options) {
+        OH_REQUIRE(options.queueSize > 0,
+                   "AsyncLog: queue size must be positive: " << options.queueSize);
+        OH_REQUIRE(options.batchSize > 0 && options.batchSize <= options.queueSize,
+                   "AsyncLog: batch size must be between 1 and the queue size: "
+                   << options.batchSize);
+        OH_REQUIRE(options.flushInterval > 0,
+                   "AsyncLog: flush interval must be positive: " << options.flushInterval);
+    }
+
+}
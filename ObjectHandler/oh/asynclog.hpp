@@ -0,0 +1,115 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Class AsyncLog - Hand log messages to a background thread
+*/
+
+#ifndef oh_asynclog_hpp
+#define oh_asynclog_hpp
+
+#include <oh/ohdefines.hpp>
+#include <boost/function.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/cstdint.hpp>
+#include <string>
+
+namespace ObjectHandler {
+
+    //! Hand log messages to a background thread.
+    /*! Messages are copied into a bounded queue on the calling thread and
+        written to the sink by a background thread, so that the caller
+        does not wait for the disk.  The background thread waits until at
+        least batchSize messages are queued, or until flushInterval
+        milliseconds have passed since it last wrote, and then writes all
+        of the queued messages in one batch.
+
+        When the queue is full, a message is either discarded or the
+        calling thread waits for space, according to dropWhenFull.  Either
+        event is counted.
+
+        stop() writes the remaining messages and then joins the background
+        thread, after which messages are written on the calling thread.
+        The destructor calls stop() if it has not been called.  An owner
+        which may be destroyed during static destruction, or while a DLL
+        unloads, must call stop() beforehand, as a thread must not be
+        joined under the loader lock.
+
+        Requires OH_ENABLE_THREAD_SAFE_REPOSITORY, without which the
+        constructor throws.
+    */
+    class AsyncLog {
+    public:
+        //! Write one message at the given level.  Called on the background thread.
+        typedef boost::function<void (int, const std::string &)> Sink;
+
+        struct Options {
+            Options()
+            : queueSize(4096), batchSize(64), flushInterval(500), dropWhenFull(false) {}
+            //! The largest number of messages which may wait to be written.
+            long queueSize;
+            //! The number of queued messages which wakes the background thread.
+            long batchSize;
+            //! The longest time in milliseconds that a message may wait to be written.
+            long flushInterval;
+            //! Discard messages when the queue is full rather than wait for space.
+            bool dropWhenFull;
+        };
+
+        struct Statistics {
+            Statistics()
+            : queued(0), written(0), dropped(0), waits(0), batches(0), highWater(0) {}
+            //! Messages accepted into the queue.
+            boost::uint64_t queued;
+            //! Messages passed to the sink.
+            boost::uint64_t written;
+            //! Messages discarded because the queue was full.
+            boost::uint64_t dropped;
+            //! Calls which waited for space in the queue.
+            boost::uint64_t waits;
+            //! Batches written.
+            boost::uint64_t batches;
+            //! The largest number of messages in the queue at one time.
+            boost::uint64_t highWater;
+        };
+
+        AsyncLog(const Sink &sink, const Options &options);
+        //! Throw if the given options are out of range.
+        static void validate(const Options &options);
+        ~AsyncLog();
+
+        //! Queue a message.  Does not throw.
+        void push(int level, const std::string &message);
+        //! Wait until all of the messages queued so far have been written.
+        void flush();
+        //! Write the queued messages and stop the background thread.
+        void stop();
+        Statistics statistics() const;
+
+    private:
+        AsyncLog(const AsyncLog &);
+        AsyncLog &operator=(const AsyncLog &);
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        class Impl;
+        boost::scoped_ptr<Impl> impl_;
+#endif
+    };
+
+}
+
+#endif
+
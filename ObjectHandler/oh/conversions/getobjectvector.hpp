@@ -45,56 +45,142 @@ namespace ObjectHandler {
     //    return ret;
     //}
 
+    namespace detail {
+
+        // A list of Object IDs in the course of being flattened.
+        struct ObjectListFrame {
+            ObjectListFrame() : objectIDs(0), next(0), nestingLevel(0) {}
+            // The Group whose list is being flattened, null for the list
+            // supplied by the caller.  Holding the Group keeps objectIDs valid.
+            boost::shared_ptr<Group> group;
+            std::string groupID;
+            boost::shared_ptr<ObjectWrapper> groupWrapper;
+            const std::vector<std::string> *objectIDs;
+            std::vector<boost::shared_ptr<ObjectWrapper> > objectWrappers;
+            std::size_t next;
+            int nestingLevel;
+        };
+
+        // Retrieve the Objects with the given IDs and pass each to the visitor,
+        // replacing each Group with the Objects in its list.  The visitor is
+        // also passed each Group, after the Objects in its list.  Each list is
+        // retrieved in a single call to Repository::retrieveObjectWrappers(),
+        // and nested Groups are expanded using an explicit stack.  Empty IDs
+        // are silently ignored.
+        template <class Visitor>
+        void visitObjects(const std::vector<std::string> &objectIDs,
+                          int nestingLevel,
+                          const char *function,
+                          Visitor &visitor) {
+
+            OH_REQUIRE(nestingLevel < 10, function << " - nesting level exceeds 10. "
+                "(Possible infinite recursion?)");
+
+            std::vector<ObjectListFrame> stack(1);
+            stack.back().objectIDs = &objectIDs;
+            stack.back().objectWrappers =
+                Repository::instance().retrieveObjectWrappers(objectIDs);
+            stack.back().nestingLevel = nestingLevel;
+
+            while (!stack.empty()) {
+                ObjectListFrame &frame = stack.back();
+                if (frame.next == frame.objectIDs->size()) {
+                    if (frame.group)
+                        visitor.group(frame.groupID, frame.groupWrapper);
+                    stack.pop_back();
+                    continue;
+                }
+                std::size_t i = frame.next++;
+                boost::shared_ptr<ObjectWrapper> objectWrapper = frame.objectWrappers[i];
+                if (!objectWrapper)
+                    continue;
+                boost::shared_ptr<Group> group = objectWrapper->typedObject<Group>();
+                if (!group) {
+                    visitor.object((*frame.objectIDs)[i], objectWrapper);
+                    continue;
+                }
+                OH_REQUIRE(frame.nestingLevel + 1 < 10, function << " - nesting level exceeds 10. "
+                    "(Possible infinite recursion?)");
+                ObjectListFrame child;
+                child.group = group;
+                child.groupID = (*frame.objectIDs)[i];
+                child.groupWrapper = objectWrapper;
+                child.objectIDs = &group->list();
+                child.nestingLevel = frame.nestingLevel + 1;
+                // frame is invalidated by push_back.
+                stack.push_back(child);
+                stack.back().objectWrappers =
+                    Repository::instance().retrieveObjectWrappers(group->list());
+            }
+        }
+
+        template <class ObjectClass>
+        struct ObjectVectorBuilder {
+            ObjectVectorBuilder(std::vector<boost::shared_ptr<ObjectClass> > &ret,
+                                bool includeGroups)
+            : ret_(ret), includeGroups_(includeGroups) {}
+            void object(const std::string &objectId,
+                        const boost::shared_ptr<ObjectWrapper> &objectWrapper) {
+                boost::shared_ptr<ObjectClass> objectDerived =
+                    objectWrapper->typedObject<ObjectClass>();
+                OH_REQUIRE(objectDerived, "Error retrieving object with id '"
+                    << objectId << "' - unable to convert reference to type '"
+                    << typeid(ObjectClass).name() << "'");
+                ret_.push_back(objectDerived);
+            }
+            void group(const std::string &objectId,
+                       const boost::shared_ptr<ObjectWrapper> &objectWrapper) {
+                if (!includeGroups_)
+                    return;
+                boost::shared_ptr<ObjectClass> objectDerived =
+                    objectWrapper->typedObject<ObjectClass>();
+                OH_REQUIRE(objectDerived, "Error converting Group with id '"
+                    << objectId << "' - unable to convert to type '"
+                    << typeid(ObjectClass).name() << "'");
+                ret_.push_back(objectDerived);
+            }
+            std::vector<boost::shared_ptr<ObjectClass> > &ret_;
+            bool includeGroups_;
+        };
+
+        template <class ObjectClass, class LibraryClass>
+        struct LibraryObjectVectorBuilder {
+            explicit LibraryObjectVectorBuilder(
+                std::vector<boost::shared_ptr<LibraryClass> > &ret) : ret_(ret) {}
+            void object(const std::string &objectId,
+                        const boost::shared_ptr<ObjectWrapper> &objectWrapper) {
+                boost::shared_ptr<ObjectClass> objectDerived =
+                    objectWrapper->typedObject<ObjectClass>();
+                OH_REQUIRE(objectDerived, "Error retrieving object with id '"
+                    << objectId << "' - unable to convert reference to type '"
+                    << typeid(ObjectClass).name() << "'");
+                boost::shared_ptr<LibraryClass> libraryObject;
+                objectDerived->getLibraryObject(libraryObject);
+                ret_.push_back(libraryObject);
+            }
+            void group(const std::string &,
+                       const boost::shared_ptr<ObjectWrapper> &) {}
+            std::vector<boost::shared_ptr<LibraryClass> > &ret_;
+        };
+
+    }
+
     //! Convert a vector of Object IDs to a vector of objects.
+    /*! Groups are replaced by the Objects in their lists, followed by the
+        Group itself if includeGroups is true.  The IDs are looked up in the
+        Repository one list at a time, and the downcast of each Object is
+        cached by its ObjectWrapper, see Repository::retrieveObjectWrappers().
+    */
     template <class ObjectClass>
     std::vector<boost::shared_ptr<ObjectClass> > getObjectVector(
             const std::vector<std::string> &objectIDs,
             const int &nestingLevel = 0,
 			bool includeGroups = false) {
 
-        OH_REQUIRE(nestingLevel < 10, "getObjectVector - nesting level exceeds 10. "
-            "(Possible infinite recursion?)");
-
         std::vector<boost::shared_ptr<ObjectClass> > ret;
-
-        for (std::vector<std::string>::const_iterator i = objectIDs.begin();
-                i != objectIDs.end(); ++i) {
-
-            std::string objectId = *i;
-
-            // If the object ID is a null string then silently ignore.
-            // This will be revised to raise an exception in the absence of explicit
-            // indication from the user to do otherwise.
-            if (objectId.empty())
-                continue;
-
-            boost::shared_ptr<Object> object;
-            Repository::instance().retrieveObject(object, objectId);
-
-            boost::shared_ptr<Group> group =
-                boost::dynamic_pointer_cast<Group>(object);
-            if (group) {
-                std::vector<boost::shared_ptr<ObjectClass> > ret2 =
-                    getObjectVector<ObjectClass>(group->list(), nestingLevel + 1, includeGroups);
-                ret.insert(ret.end(), ret2.begin(), ret2.end());
-				if(includeGroups) {
-					boost::shared_ptr<ObjectClass> objectDerived =
-						boost::dynamic_pointer_cast<ObjectClass>(object);
-					OH_REQUIRE(objectDerived, "Error converting Group with id '"
-						<< objectId << "' - unable to convert to type '"
-						<< typeid(ObjectClass).name() << "'");
-					ret.push_back(objectDerived);				
-				}
-            } else {
-                boost::shared_ptr<ObjectClass> objectDerived =
-                    boost::dynamic_pointer_cast<ObjectClass>(object);
-                OH_REQUIRE(objectDerived, "Error retrieving object with id '"
-                    << objectId << "' - unable to convert reference to type '"
-                    << typeid(ObjectClass).name() << "'");
-                ret.push_back(objectDerived);
-            }
-
-        }
+        ret.reserve(objectIDs.size());
+        detail::ObjectVectorBuilder<ObjectClass> builder(ret, includeGroups);
+        detail::visitObjects(objectIDs, nestingLevel, "getObjectVector", builder);
         return ret;
     }
 
@@ -115,53 +201,62 @@ namespace ObjectHandler {
     //}
 
     //! Convert a vector of Object IDs to a vector of library objects.
+    /*! Groups are replaced by the library objects of the Objects in their
+        lists, as for getObjectVector().
+    */
     template <class ObjectClass, class LibraryClass>
     std::vector<boost::shared_ptr<LibraryClass> > getLibraryObjectVector(
             const std::vector<std::string> &objectIDs,
             const int &nestingLevel = 0) {
 
-        OH_REQUIRE(nestingLevel < 10, "getLibraryObjectVector - nesting level exceeds 10. "
-            "(Possible infinite recursion?)");
-
         std::vector<boost::shared_ptr<LibraryClass> > ret;
+        ret.reserve(objectIDs.size());
+        detail::LibraryObjectVectorBuilder<ObjectClass, LibraryClass> builder(ret);
+        detail::visitObjects(objectIDs, nestingLevel, "getLibraryObjectVector", builder);
+        return ret;
+    }
 
-        for (std::vector<std::string>::const_iterator i = objectIDs.begin();
-                i != objectIDs.end(); ++i) {
-
-            std::string objectId = *i;
-
-            // If the object ID is a null string then silently ignore.
-            // This will be revised to raise an exception in the absence
-            // of explicit indication from the user to do otherwise.
-            if (objectId.empty())
-                continue;
-
-            boost::shared_ptr<Object> object;
-            Repository::instance().retrieveObject(object, objectId);
-
-            boost::shared_ptr<Group> group =
-                boost::dynamic_pointer_cast<Group>(object);
-            if (group) {
-                std::vector<boost::shared_ptr<LibraryClass> > ret2 =
-                    getLibraryObjectVector<ObjectClass, LibraryClass>(
-                        group->list(), nestingLevel + 1);
-                ret.insert(ret.end(), ret2.begin(), ret2.end());
-            } else {
-                boost::shared_ptr<ObjectClass> objectDerived =
-                    boost::dynamic_pointer_cast<ObjectClass>(object);
-                OH_REQUIRE(objectDerived, "Error retrieving object with id '"
-                    << objectId << "' - unable to convert reference to type '"
-                    << typeid(ObjectClass).name() << "'");
-
-                boost::shared_ptr<LibraryClass> libraryObject;
-                objectDerived->getLibraryObject(libraryObject);
-                ret.push_back(libraryObject);
-            }
+    //! Retrieve the Objects with the given IDs, one for each ID.
+    /*! Unlike getObjectVector(), Groups are not expanded and empty IDs are
+        an error, so that the result corresponds element by element to the
+        input.  Used by the batch variants of addin Member functions.
+    */
+    template <class ObjectClass>
+    std::vector<boost::shared_ptr<ObjectClass> > getObjects(
+            const std::vector<std::string> &objectIDs) {
 
+        std::vector<boost::shared_ptr<ObjectWrapper> > objectWrappers =
+            Repository::instance().retrieveObjectWrappers(objectIDs);
+        std::vector<boost::shared_ptr<ObjectClass> > ret;
+        ret.reserve(objectWrappers.size());
+        for (std::size_t i = 0; i < objectWrappers.size(); ++i) {
+            OH_REQUIRE(objectWrappers[i], "Error retrieving object at position "
+                << i << " - object ID is empty");
+            boost::shared_ptr<ObjectClass> objectDerived =
+                objectWrappers[i]->typedObject<ObjectClass>();
+            OH_REQUIRE(objectDerived, "Error retrieving object with id '"
+                << objectIDs[i] << "' - unable to convert reference to type '"
+                << typeid(ObjectClass).name() << "'");
+            ret.push_back(objectDerived);
         }
         return ret;
     }
 
+    //! Retrieve the library objects of the Objects with the given IDs, one for each ID.
+    /*! As getObjects().
+    */
+    template <class ObjectClass, class LibraryClass>
+    std::vector<boost::shared_ptr<LibraryClass> > getLibraryObjects(
+            const std::vector<std::string> &objectIDs) {
+
+        std::vector<boost::shared_ptr<ObjectClass> > objects =
+            getObjects<ObjectClass>(objectIDs);
+        std::vector<boost::shared_ptr<LibraryClass> > ret(objects.size());
+        for (std::size_t i = 0; i < objects.size(); ++i)
+            objects[i]->getLibraryObject(ret[i]);
+        return ret;
+    }
+
 }
 
 #endif
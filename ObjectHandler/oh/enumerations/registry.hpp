@@ -27,6 +27,7 @@
 
 #include <oh/ohdefines.hpp>
 #include <oh/exception.hpp>
+#include <oh/iless.hpp>
 #include <string>
 #include <vector>
 #include <map>
@@ -41,6 +42,136 @@ namespace ObjectHandler {
     */
     typedef std::pair<std::string, std::string> KeyPair;
 
+    //! A mapping of keys to type instances.
+    /*! The entries are held in a std::map, ordered by key, for iteration.
+        Alongside the map is a case-insensitive hash index, an
+        open-addressing table with linear probing in which each slot holds
+        the case-folded key, computed once when the entry is inserted.  A
+        lookup hashes the requested key once and compares it character by
+        character against the folded keys, so it runs in constant time and
+        does not allocate.
+
+        If two keys differing only in case are inserted, lookup returns the
+        type inserted last.
+    */
+    template <typename KeyClass>
+    class TypeMap {
+    public:
+        typedef typename std::map<KeyClass, void*>::const_iterator const_iterator;
+        TypeMap() : size_(0), version_(0) {}
+
+        //! \name Iteration
+        //@{
+        const_iterator begin() const { return map_.begin(); }
+        const_iterator end() const { return map_.end(); }
+        std::size_t size() const { return map_.size(); }
+        //! Number of insertions so far, so that callers may tell when a key might resolve differently.
+        std::size_t version() const { return version_; }
+        //@}
+
+        //! \name Management of Types
+        //@{
+        //! Store a type, replacing any existing type with the same key.
+        void insert(const KeyClass &key, void *type) {
+            map_[key] = type;
+            // Keep the load factor at or below one half.
+            if (2 * (size_ + 1) > slots_.size())
+                rehash(slots_.empty() ? 16 : 2 * slots_.size());
+            std::size_t h = hash(key);
+            Slot &slot = slots_[locate(key, h)];
+            if (!slot.used) {
+                slot.used = true;
+                slot.hash = h;
+                slot.key = fold(key);
+                ++size_;
+            }
+            slot.type = type;
+            ++version_;
+        }
+        //! Retrieve the type for the given key, ignoring case, or 0 if there is none.
+        void *find(const KeyClass &key) const {
+            if (slots_.empty())
+                return 0;
+            return slots_[locate(key, hash(key))].type;
+        }
+        //! Retrieve the type for the given pair of strings, for a TypeMap keyed by KeyPair.
+        /*! As find() above but without constructing a KeyPair.
+        */
+        void *find(const std::string &first, const std::string &second) const {
+            if (slots_.empty())
+                return 0;
+            std::size_t h = foldedHash(second, foldedHash(first) * 16777619U);
+            std::size_t mask = slots_.size() - 1;
+            std::size_t i = h & mask;
+            while (slots_[i].used && !(slots_[i].hash == h
+                    && foldedEqual(first, slots_[i].key.first)
+                    && foldedEqual(second, slots_[i].key.second)))
+                i = (i + 1) & mask;
+            return slots_[i].type;
+        }
+        //@}
+
+    private:
+        struct Slot {
+            Slot() : used(false), hash(0), type(0) {}
+            bool used;
+            std::size_t hash;
+            KeyClass key;
+            void *type;
+        };
+
+        static std::size_t hash(const std::string &key) {
+            return foldedHash(key);
+        }
+        static std::size_t hash(const KeyPair &key) {
+            return foldedHash(key.second, foldedHash(key.first) * 16777619U);
+        }
+        static std::string fold(const std::string &key) {
+            std::string ret(key);
+            std::transform(ret.begin(), ret.end(), ret.begin(), foldCase);
+            return ret;
+        }
+        static KeyPair fold(const KeyPair &key) {
+            return KeyPair(fold(key.first), fold(key.second));
+        }
+        static bool equal(const std::string &key, const std::string &folded) {
+            return foldedEqual(key, folded);
+        }
+        static bool equal(const KeyPair &key, const KeyPair &folded) {
+            return foldedEqual(key.first, folded.first)
+                && foldedEqual(key.second, folded.second);
+        }
+
+        // Index of the slot holding the given key, or of the empty slot
+        // at which it would be inserted.
+        std::size_t locate(const KeyClass &key, std::size_t h) const {
+            std::size_t mask = slots_.size() - 1;
+            std::size_t i = h & mask;
+            while (slots_[i].used && !(slots_[i].hash == h && equal(key, slots_[i].key)))
+                i = (i + 1) & mask;
+            return i;
+        }
+
+        void rehash(std::size_t capacity) {
+            std::vector<Slot> old(capacity);
+            old.swap(slots_);
+            std::size_t mask = capacity - 1;
+            for (typename std::vector<Slot>::iterator s = old.begin(); s != old.end(); ++s) {
+                if (!s->used)
+                    continue;
+                std::size_t i = s->hash & mask;
+                while (slots_[i].used)
+                    i = (i + 1) & mask;
+                slots_[i] = *s;
+            }
+        }
+
+        std::map<KeyClass, void*> map_;
+        std::vector<Slot> slots_;
+        std::size_t size_;
+        std::size_t version_;
+    };
+
     //! A registry of enumerated types and classes.
     /*! Maintain a mapping of text strings to datatypes.
     */
@@ -48,7 +179,7 @@ namespace ObjectHandler {
     class Registry {
     public:
         //! A mapping of keys to type instances.
-        typedef std::map<KeyClass, void*> TypeMap;
+        typedef ObjectHandler::TypeMap<KeyClass> TypeMap;
         //! Shared pointer to a type map.
         typedef boost::shared_ptr<TypeMap> TypeMapPtr;
         //! A store of type maps indexed by type.
@@ -104,7 +235,7 @@ namespace ObjectHandler {
         } else {
             typeMapPtr = i->second;
         }
-        (*typeMapPtr)[typeID] = type;
+        typeMapPtr->insert(typeID, type);
     }
 
     template <typename KeyClass>
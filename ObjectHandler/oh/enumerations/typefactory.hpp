@@ -28,6 +28,10 @@
 #include <oh/enumerations/enumregistry.hpp>
 #include <oh/exception.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#endif
 
 namespace ObjectHandler {
 
@@ -46,6 +50,64 @@ namespace ObjectHandler {
         return left;
     }
 
+    //! Memo for a single Create<> call site.
+    /*! Declare one at namespace scope next to the call and pass it as the
+        first argument of the factory, e.g.
+        \code
+        namespace { ObjectHandler::CreateCache accountTypeCache; }
+        ...
+        Account::Type accountTypeEnumeration =
+            ObjectHandler::Create<Account::Type>()(accountTypeCache, id);
+        \endcode
+        The cache holds the last key resolved at that site together with the
+        type it resolved to.  A call with the same key, compared exactly, is
+        answered without consulting the type map.  Any other key, or a change
+        to the type map since the key was resolved, is a miss and replaces
+        the cached entry.
+    */
+    class CreateCache {
+    public:
+        CreateCache() : type_(0), version_(0), hits_(0), misses_(0) {}
+        //! Number of calls answered from the cache.
+        unsigned long hits() const { Lock lock(mutex_); return hits_; }
+        //! Number of calls which had to consult the type map.
+        unsigned long misses() const { Lock lock(mutex_); return misses_; }
+
+    private:
+        template<typename T, typename RegistryClass> friend class RegistryManager;
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        typedef boost::mutex Mutex;
+        typedef boost::lock_guard<Mutex> Lock;
+#else
+        struct Mutex {};
+        struct Lock { explicit Lock(Mutex &) {} };
+#endif
+        CreateCache(const CreateCache&);
+        CreateCache &operator=(const CreateCache&);
+
+        template<typename TypeMapPtr>
+        bool fresh(const TypeMapPtr &typeMap) const {
+            return type_ && typeMap == typeMap_ && typeMap->version() == version_;
+        }
+        template<typename TypeMapPtr>
+        void store(const TypeMapPtr &typeMap, void *type) {
+            typeMap_ = typeMap;
+            version_ = typeMap->version();
+            type_ = type;
+            ++misses_;
+        }
+
+        mutable Mutex mutex_;
+        std::string first_;
+        std::string second_;
+        void *type_;
+        // Held so that the address cannot be reused by a later type map.
+        boost::shared_ptr<const void> typeMap_;
+        std::size_t version_;
+        unsigned long hits_;
+        unsigned long misses_;
+    };
+
     //! Manage access to an Enumeration Registry.
     /*! This template class manages the intersection between the given
         template parameters:
@@ -61,33 +123,63 @@ namespace ObjectHandler {
         //@{
         //! Retrieve an enumerated type.
         /*! If no type corresponds to the given ID then an exception is thrown.
+            The lookup ignores case, see class TypeMap.
         */
         template<typename KeyClass>
         void *getType(const KeyClass& id) {
-            typename RegistryClass::TypeMapPtr typeMap = getTypeMap();
-            KeyClass idUpper = uppercase(id);
-            typename RegistryClass::TypeMap::iterator i;
-            for (i = typeMap->begin(); i != typeMap->end(); ++i)
-                if (uppercase(i->first) == idUpper)
-                    return i->second;
-            OH_FAIL("Unknown id for Type: " << id);
+            void *type = getTypeMap()->find(id);
+            OH_REQUIRE(type, "Unknown id for Type: " << id);
+            return type;
+        }
+
+        //! Retrieve an enumerated type keyed by a pair of strings.
+        /*! As getType() above, for registries keyed by KeyPair, but without
+            constructing a KeyPair.
+        */
+        void *getType(const std::string& first, const std::string& second) {
+            void *type = getTypeMap()->find(first, second);
+            OH_REQUIRE(type, "Unknown id for Type: " << first << ":" << second);
+            return type;
+        }
+
+        //! Retrieve an enumerated type through the memo of a call site.
+        /*! As getType() above, but a repeat of the key last resolved at the
+            call site is answered from the given cache.
+        */
+        void *getType(CreateCache& cache, const std::string& id) {
+            const typename RegistryClass::TypeMapPtr &typeMap = getTypeMap();
+            CreateCache::Lock lock(cache.mutex_);
+            if (cache.fresh(typeMap) && id == cache.first_) {
+                ++cache.hits_;
+                return cache.type_;
+            }
+            void *type = typeMap->find(id);
+            OH_REQUIRE(type, "Unknown id for Type: " << id);
+            cache.first_ = id;
+            cache.store(typeMap, type);
+            return type;
+        }
+
+        //! Retrieve an enumerated type keyed by a pair of strings through the memo of a call site.
+        void *getType(CreateCache& cache, const std::string& first, const std::string& second) {
+            const typename RegistryClass::TypeMapPtr &typeMap = getTypeMap();
+            CreateCache::Lock lock(cache.mutex_);
+            if (cache.fresh(typeMap) && first == cache.first_ && second == cache.second_) {
+                ++cache.hits_;
+                return cache.type_;
+            }
+            void *type = typeMap->find(first, second);
+            OH_REQUIRE(type, "Unknown id for Type: " << first << ":" << second);
+            cache.first_ = first;
+            cache.second_ = second;
+            cache.store(typeMap, type);
+            return type;
         }
 
         //! Determine whether a given type has been registered.
         bool checkType(const std::string& id) {
-            typename RegistryClass::TypeMapPtr type_map;
-            typename RegistryClass::AllTypeMap::const_iterator i =
-                RegistryClass::instance().getAllTypesMap().find(typeid(T).name());
-            if (i == RegistryClass::instance().getAllTypesMap().end()) {
-                return false;
-            } else {
-                type_map = i->second;
-            }
-            std::string idUpper = boost::algorithm::to_upper_copy(id);
-            for (typename RegistryClass::TypeMap::iterator i = type_map->begin(); i != type_map->end(); ++i)
-                if (boost::algorithm::to_upper_copy(i->first) == idUpper)
-                    return true;
-            return false;
+            const typename RegistryClass::TypeMapPtr &typeMap = findTypeMap();
+            return typeMap && typeMap->find(id);
         }
 
         //! Register an enumerated type.
@@ -101,26 +193,41 @@ namespace ObjectHandler {
         */
         void unregisterTypes() {
             typename RegistryClass::TypeMapPtr typeMap = getTypeMap();
-            typename RegistryClass::TypeMap::iterator i;
+            typename RegistryClass::TypeMap::const_iterator i;
             for (i = typeMap->begin(); i != typeMap->end(); ++i)
                 delete static_cast<T*>(i->second);
             RegistryClass::instance().deleteTypeMap(typeid(T).name());
+            cachedTypeMap().reset();
         }
         //@}
 
     protected:
         const typename RegistryClass::TypeMapPtr &getTypeMap() {
-            static typename RegistryClass::TypeMapPtr typeMap;
+            const typename RegistryClass::TypeMapPtr &typeMap = findTypeMap();
+            OH_REQUIRE(typeMap,
+                "Error retrieving Enumeration from Registry - the type '"
+                << typeid(T).name() << "' is not available!");
+            return typeMap;
+        }
+
+        // Return the type map for T, or a null pointer if no type has been
+        // registered for T.  Once found, the type map is cached until
+        // unregisterTypes() deletes it.
+        const typename RegistryClass::TypeMapPtr &findTypeMap() {
+            typename RegistryClass::TypeMapPtr &typeMap = cachedTypeMap();
             if(!typeMap) {
                 typename RegistryClass::AllTypeMap::const_iterator i =
                     RegistryClass::instance().getAllTypesMap().find(typeid(T).name());
-                OH_REQUIRE(i != RegistryClass::instance().getAllTypesMap().end(),
-                    "Error retrieving Enumeration from Registry - the type '"
-                    << typeid(T).name() << "' is not available!");
-                typeMap = i->second;
+                if (i != RegistryClass::instance().getAllTypesMap().end())
+                    typeMap = i->second;
             }
             return typeMap;
         }
+
+        static typename RegistryClass::TypeMapPtr &cachedTypeMap() {
+            static typename RegistryClass::TypeMapPtr typeMap;
+            return typeMap;
+        }
     };
 
     //! %Create the enumerated type associated with a string.
@@ -139,6 +246,11 @@ namespace ObjectHandler {
             return *(static_cast<T*>(this->getType(id)));
         }
 
+        //! As above, through the memo of the call site.
+        T operator()(CreateCache& cache, const std::string& id) {
+            return *(static_cast<T*>(this->getType(cache, id)));
+        }
+
         using RegistryManager<T, EnumTypeRegistry>::registerType;
         using RegistryManager<T, EnumTypeRegistry>::unregisterTypes;
     };
@@ -0,0 +1,185 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <oh/config.hpp>
+#endif
+
+#include <oh/functionstatistics.hpp>
+#include <algorithm>
+
+using boost::shared_ptr;
+using boost::uint64_t;
+using std::string;
+
+namespace ObjectHandler {
+
+    namespace {
+
+        // Order samples by total time, busiest first.
+        struct SampleGreater {
+            bool operator()(const FunctionCounters::Sample &a,
+                            const FunctionCounters::Sample &b) const {
+                return a.total > b.total;
+            }
+        };
+
+        double microseconds(uint64_t nanoseconds) {
+            return static_cast<double>(nanoseconds) / 1000.0;
+        }
+
+        double mean(uint64_t nanoseconds, uint64_t calls) {
+            return microseconds(nanoseconds) / static_cast<double>(calls);
+        }
+
+        // The upper bound in microseconds of the bucket which holds the
+        // given fraction of the calls, or the longest call if that is lower.
+        double percentile(const FunctionCounters::Sample &s, double fraction) {
+            uint64_t target = static_cast<uint64_t>(fraction * s.calls);
+            if (target < 1)
+                target = 1;
+            uint64_t count = 0;
+            for (int i = 0; i < FunctionCounters::BucketCount - 1; ++i) {
+                count += s.histogram[i];
+                if (count >= target)
+                    return std::min(static_cast<double>(uint64_t(1) << i),
+                                    microseconds(s.maximum));
+            }
+            return microseconds(s.maximum);
+        }
+
+    }
+
+    FunctionCounters::FunctionCounters(const string &name) {
+        sample_.name = name;
+        reset();
+    }
+
+    void FunctionCounters::record(const uint64_t elapsed[StageCount], bool failed) {
+        uint64_t total = 0;
+        for (int i = 0; i < StageCount; ++i)
+            total += elapsed[i];
+        int bucket = 0;
+        for (uint64_t us = total / 1000; us && bucket < BucketCount - 1; us >>= 1)
+            ++bucket;
+
+        Lock lock(mutex_);
+        ++sample_.calls;
+        if (failed)
+            ++sample_.failures;
+        for (int i = 0; i < StageCount; ++i)
+            sample_.stageTotal[i] += elapsed[i];
+        sample_.total += total;
+        sample_.maximum = std::max(sample_.maximum, total);
+        ++sample_.histogram[bucket];
+    }
+
+    void FunctionCounters::reset() {
+        Lock lock(mutex_);
+        sample_.calls = 0;
+        sample_.failures = 0;
+        std::fill(sample_.stageTotal, sample_.stageTotal + StageCount, 0);
+        sample_.total = 0;
+        sample_.maximum = 0;
+        std::fill(sample_.histogram, sample_.histogram + BucketCount, 0);
+    }
+
+    FunctionCounters::Sample FunctionCounters::sample() const {
+        Lock lock(mutex_);
+        return sample_;
+    }
+
+    FunctionStatistics &FunctionStatistics::instance() {
+        // Never destroyed, the generated code of each function holds a
+        // reference to its counters for the lifetime of the addin.
+        static FunctionStatistics *instance_ = new FunctionStatistics;
+        return *instance_;
+    }
+
+    FunctionCounters &FunctionStatistics::counters(const string &name) {
+        Lock lock(mutex_);
+        shared_ptr<FunctionCounters> &ret = countersMap_[name];
+        if (!ret)
+            ret = shared_ptr<FunctionCounters>(new FunctionCounters(name));
+        return *ret;
+    }
+
+    std::vector<std::vector<property_t> > FunctionStatistics::report() const {
+        std::vector<FunctionCounters::Sample> samples;
+        {
+            Lock lock(mutex_);
+            samples.reserve(countersMap_.size());
+            for (CountersMap::const_iterator i = countersMap_.begin();
+                 i != countersMap_.end(); ++i) {
+                FunctionCounters::Sample s = i->second->sample();
+                if (s.calls)
+                    samples.push_back(s);
+            }
+        }
+        std::stable_sort(samples.begin(), samples.end(), SampleGreater());
+
+        static const char *headings[] = {
+            "Function", "Calls", "Failures", "Conversion", "Lookup",
+            "Library", "Return", "Mean", "Median", "99th Percentile",
+            "Maximum" };
+        const std::size_t columns = sizeof(headings) / sizeof(headings[0]);
+
+        std::vector<std::vector<property_t> > ret;
+        ret.reserve(samples.size() + 1);
+        ret.push_back(std::vector<property_t>());
+        for (std::size_t i = 0; i < columns; ++i)
+            ret.back().push_back(string(headings[i]));
+        for (std::vector<FunctionCounters::Sample>::const_iterator s = samples.begin();
+             s != samples.end(); ++s) {
+            std::vector<property_t> row;
+            row.reserve(columns);
+            row.push_back(s->name);
+            row.push_back(static_cast<long>(s->calls));
+            row.push_back(static_cast<long>(s->failures));
+            for (int i = 0; i < FunctionCounters::StageCount; ++i)
+                row.push_back(mean(s->stageTotal[i], s->calls));
+            row.push_back(mean(s->total, s->calls));
+            row.push_back(percentile(*s, 0.5));
+            row.push_back(percentile(*s, 0.99));
+            row.push_back(microseconds(s->maximum));
+            ret.push_back(row);
+        }
+        return ret;
+    }
+
+    void FunctionStatistics::reset() {
+        Lock lock(mutex_);
+        for (CountersMap::const_iterator i = countersMap_.begin();
+             i != countersMap_.end(); ++i)
+            i->second->reset();
+    }
+
+    std::vector<std::vector<property_t> > functionStatistics() {
+#ifdef OH_ENABLE_FUNCTION_STATISTICS
+        return FunctionStatistics::instance().report();
+#else
+        OH_FAIL("function statistics are not available, "
+                "ObjectHandler was compiled without OH_ENABLE_FUNCTION_STATISTICS");
+#endif
+    }
+
+    void resetFunctionStatistics() {
+        FunctionStatistics::instance().reset();
+    }
+
+}
+
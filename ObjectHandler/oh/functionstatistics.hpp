@@ -0,0 +1,241 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Call counts and latency histograms of addin functions
+*/
+
+#ifndef oh_functionstatistics_hpp
+#define oh_functionstatistics_hpp
+
+#include <oh/ohdefines.hpp>
+#include <oh/property.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#ifdef OH_ENABLE_FUNCTION_STATISTICS
+#include <boost/chrono.hpp>
+#include <exception>
+#endif
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#endif
+#if defined(OH_ENABLE_FUNCTION_STATISTICS) && defined(OH_ENABLE_THREAD_SAFE_REPOSITORY)
+#include <boost/thread/once.hpp>
+#endif
+
+namespace ObjectHandler {
+
+    //! Call count, failure count and latencies of one addin function.
+    /*! The time spent in each call is divided into the stages of the
+        generated function body: the conversion of the inputs, the
+        retrieval of Objects from the Repository, the call to the library,
+        and the conversion of the return value.  The total time of each
+        call is also recorded in a histogram whose buckets double in width,
+        from which percentiles are estimated.
+    */
+    class DLL_API FunctionCounters {
+    public:
+        enum Stage { Conversion, Lookup, Library, Return, StageCount };
+        //! Bucket n > 0 counts calls of [2^(n-1), 2^n) microseconds, bucket 0 calls of under 1us.
+        enum { BucketCount = 32 };
+
+        explicit FunctionCounters(const std::string &name);
+
+        //! Add one call, given the nanoseconds spent in each stage.
+        void record(const boost::uint64_t elapsed[StageCount], bool failed);
+        //! Discard all of the calls recorded so far.
+        void reset();
+
+        //! The counters at a point in time.
+        struct Sample {
+            std::string name;
+            boost::uint64_t calls;
+            boost::uint64_t failures;
+            boost::uint64_t stageTotal[StageCount];
+            boost::uint64_t total;
+            boost::uint64_t maximum;
+            boost::uint64_t histogram[BucketCount];
+        };
+        //! Copy the counters, under the lock.
+        Sample sample() const;
+
+    private:
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        typedef boost::mutex Mutex;
+        typedef boost::lock_guard<Mutex> Lock;
+#else
+        struct Mutex {};
+        struct Lock { explicit Lock(Mutex &) {} };
+#endif
+        mutable Mutex mutex_;
+        Sample sample_;
+    };
+
+    //! The counters of all of the addin functions which have been called.
+    /*! Counters are created on the first call to each function and are
+        never destroyed, the generated code of each function keeps a
+        reference to its own counters.  Counters are only created if
+        OH_ENABLE_FUNCTION_STATISTICS is defined when the addin is compiled.
+    */
+    class DLL_API FunctionStatistics {
+    public:
+        static FunctionStatistics &instance();
+
+        //! Return the counters of the function with the given name, creating them if necessary.
+        FunctionCounters &counters(const std::string &name);
+
+        //! A table with one row per function, busiest first.
+        /*! The first row holds the column headings.  Times are in
+            microseconds.  The columns are the name of the function, the
+            number of calls and of failed calls, the mean time of each
+            stage and of the whole call, the estimated median and 99th
+            percentile of the time of a call, and the longest call.
+            Functions which have not been called since the last reset are
+            omitted.
+        */
+        std::vector<std::vector<property_t> > report() const;
+        //! Discard all of the calls recorded so far.
+        void reset();
+
+    private:
+        FunctionStatistics() {}
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        typedef boost::mutex Mutex;
+        typedef boost::lock_guard<Mutex> Lock;
+#else
+        struct Mutex {};
+        struct Lock { explicit Lock(Mutex &) {} };
+#endif
+        typedef std::map<std::string, boost::shared_ptr<FunctionCounters> > CountersMap;
+        mutable Mutex mutex_;
+        CountersMap countersMap_;
+    };
+
+    //! \name Function statistics
+    //@{
+    //! Wraps function FunctionStatistics::instance().report().
+    std::vector<std::vector<property_t> > functionStatistics();
+    //! Wraps function FunctionStatistics::instance().reset().
+    void resetFunctionStatistics();
+    //@}
+
+#ifdef OH_ENABLE_FUNCTION_STATISTICS
+
+    //! Time the stages of one call to an addin function.
+    /*! Declared at the top of the generated function body by
+        OH_FUNCTION_TIMER.  The time up to each OH_FUNCTION_STAGE is
+        charged to the previous stage, and the counters are updated when
+        the timer goes out of scope.  A call which is left by an exception
+        is counted as failed.
+    */
+    class FunctionTimer {
+    public:
+        explicit FunctionTimer(FunctionCounters &counters)
+        : counters_(counters), stage_(FunctionCounters::Conversion),
+          uncaught_(uncaughtExceptions()), mark_(Clock::now()) {
+            for (int i = 0; i < FunctionCounters::StageCount; ++i)
+                elapsed_[i] = 0;
+        }
+        ~FunctionTimer() {
+            stage(FunctionCounters::StageCount);
+            counters_.record(elapsed_, uncaughtExceptions() > uncaught_);
+        }
+        //! Charge the time since the last stage began to that stage, and begin the next.
+        void stage(int next) {
+            Clock::time_point now = Clock::now();
+            elapsed_[stage_] += boost::chrono::duration_cast<
+                boost::chrono::nanoseconds>(now - mark_).count();
+            stage_ = next;
+            mark_ = now;
+        }
+    private:
+        // The number of exceptions being propagated, a call fails if it
+        // is left by one more than were in flight when it began.
+        static int uncaughtExceptions() {
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+            return std::uncaught_exceptions();
+#else
+            return std::uncaught_exception() ? 1 : 0;
+#endif
+        }
+        typedef boost::chrono::high_resolution_clock Clock;
+        FunctionCounters &counters_;
+        int stage_;
+        int uncaught_;
+        Clock::time_point mark_;
+        boost::uint64_t elapsed_[FunctionCounters::StageCount];
+    };
+
+    //! Look up the counters of an addin function into the given pointer.
+    /*! Run by OH_FUNCTION_TIMER on the first call to each function.
+    */
+    class FunctionCountersLookup {
+    public:
+        FunctionCountersLookup(FunctionCounters *&counters, const char *name)
+        : counters_(counters), name_(name) {}
+        void operator()() const {
+            counters_ = &FunctionStatistics::instance().counters(name_);
+        }
+    private:
+        FunctionCounters *&counters_;
+        const char *name_;
+    };
+
+#endif
+
+}
+
+/*! \def OH_FUNCTION_TIMER
+    Begin timing a call to the addin function of the given name.  The
+    counters of the function are looked up once, on its first call.  The
+    statics which the macro declares are initialized statically, rather
+    than on first use, which compilers before VS2015 do not synchronize.
+    Expands to nothing unless OH_ENABLE_FUNCTION_STATISTICS is defined.
+*/
+/*! \def OH_FUNCTION_STAGE
+    Begin the given stage of the current call, one of Conversion, Lookup,
+    Library and Return.  Must follow OH_FUNCTION_TIMER in the same scope.
+    Expands to nothing unless OH_ENABLE_FUNCTION_STATISTICS is defined.
+*/
+#ifdef OH_ENABLE_FUNCTION_STATISTICS
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#define OH_FUNCTION_TIMER(NAME) \
+    static boost::once_flag ohFunctionCountersOnce = BOOST_ONCE_INIT; \
+    static ObjectHandler::FunctionCounters *ohFunctionCounters = 0; \
+    boost::call_once(ohFunctionCountersOnce, \
+        ObjectHandler::FunctionCountersLookup(ohFunctionCounters, NAME)); \
+    ObjectHandler::FunctionTimer ohFunctionTimer(*ohFunctionCounters);
+#else
+#define OH_FUNCTION_TIMER(NAME) \
+    static ObjectHandler::FunctionCounters *ohFunctionCounters = 0; \
+    if (!ohFunctionCounters) \
+        ObjectHandler::FunctionCountersLookup(ohFunctionCounters, NAME)(); \
+    ObjectHandler::FunctionTimer ohFunctionTimer(*ohFunctionCounters);
+#endif
+#define OH_FUNCTION_STAGE(STAGE) \
+    ohFunctionTimer.stage(ObjectHandler::FunctionCounters::STAGE);
+#else
+#define OH_FUNCTION_TIMER(NAME)
+#define OH_FUNCTION_STAGE(STAGE)
+#endif
+
+#endif
+
@@ -27,10 +27,57 @@
 #include <boost/algorithm/string/compare.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
+#include <boost/cstdint.hpp>
 #include <algorithm>
 
 namespace ObjectHandler {
 
+    //! Upper-case an ASCII character without reference to a std::locale.
+    inline char foldCase(char c) {
+        return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+
+    //! Case-insensitive hash of a string.
+    /*! FNV-1a over the case-folded characters, so that two strings which
+        differ only in case have the same hash.  The hash of a sequence of
+        strings may be computed by passing the hash of the preceding
+        strings as the seed.
+    */
+    inline std::size_t foldedHash(const std::string &s,
+                                  std::size_t seed = 2166136261U) {
+        std::size_t h = seed;
+        for (std::string::const_iterator i = s.begin(); i != s.end(); ++i) {
+            h ^= static_cast<unsigned char>(foldCase(*i));
+            h *= 16777619U;
+        }
+        return h;
+    }
+
+    //! Case-insensitive 32-bit hash of a string.
+    /*! As foldedHash() but with the same value on every platform, so that
+        gensrc can compute the hash of each property name when it generates
+        a ValueObject class and use it as a case label.
+    */
+    inline boost::uint32_t foldedHash32(const std::string &s) {
+        boost::uint32_t h = 2166136261U;
+        for (std::string::const_iterator i = s.begin(); i != s.end(); ++i) {
+            h ^= static_cast<unsigned char>(foldCase(*i));
+            h *= 16777619U;
+        }
+        return h;
+    }
+
+    //! Test whether a string equals an already case-folded string, ignoring case.
+    inline bool foldedEqual(const std::string &s, const std::string &folded) {
+        if (s.size() != folded.size())
+            return false;
+        std::string::const_iterator i = s.begin(), j = folded.begin();
+        for (; i != s.end(); ++i, ++j)
+            if (foldCase(*i) != *j)
+                return false;
+        return true;
+    }
+
     //! std::string specialized case insensitive version of less
     /*!
         Case insensitive comparison predicate.
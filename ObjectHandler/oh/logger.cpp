@@ -63,6 +63,14 @@ namespace ObjectHandler {
 
     }
 
+    Logger::~Logger() {
+        // The background thread of an asynchronous log must not be joined
+        // during static destruction or while a DLL unloads, a log which was
+        // not stopped by stopAsync() is abandoned rather than destroyed.
+        if (asyncLog_)
+            new boost::shared_ptr<AsyncLog>(asyncLog_);
+    }
+
     log4cxx::LayoutPtr Logger::getLayout(){
         //static log4cxx::LayoutPtr _layout = NULL;
         //if(_layout == NULL){
@@ -75,7 +83,8 @@ namespace ObjectHandler {
     }
 
     void Logger::setFile(const std::string &logFileName,
-                         const int &logLevel) {
+                         const int &logLevel,
+                         const bool &asynchronous) {
 
             // Create a boost path object from the std::string.
             boost::filesystem::path path(logFileName);
@@ -88,6 +97,9 @@ namespace ObjectHandler {
             // deprecated branch_path() observer has been used above for boost 1.35
             // backward compatibility. It should be replaced by parent_path()
 
+            // Write any messages queued for the previous logfile.
+            stopAsync();
+
             try {
 
                 log4cxx::LoggerPtr _logger = log4cxx::Logger::getRootLogger();
@@ -110,7 +122,8 @@ namespace ObjectHandler {
                 OH_FAIL(str);
             }
 
-
+            if (asynchronous)
+                startAsync();
     }
 
     void Logger::setConsole(
@@ -177,6 +190,31 @@ namespace ObjectHandler {
                               const int &level) {
             // client applications call this function from within their
             // catch() clauses so this function must not throw.
+            boost::shared_ptr<AsyncLog> asyncLog;
+            try {
+                asyncLog = this->asyncLog();
+            } catch (...) {}
+            if (asyncLog) {
+                // Don't queue messages below the threshold.
+                try {
+                    LevelPtr levelPtr;
+                    switch (level) {
+                    case 1: levelPtr = Level::getFatal(); break;
+                    case 2: levelPtr = Level::getError(); break;
+                    case 3: levelPtr = Level::getWarn(); break;
+                    case 4: levelPtr = Level::getInfo(); break;
+                    case 5: levelPtr = Level::getDebug(); break;
+                    default: return;
+                    }
+                    if (log4cxx::Logger::getRootLogger()->isEnabledFor(levelPtr))
+                        asyncLog->push(level, message);
+                } catch (...) {}
+            } else {
+                write(level, message);
+            }
+    }
+
+    void Logger::write(int level, const std::string &message) {
             try {
                 log4cxx::LoggerPtr _logger = log4cxx::Logger::getRootLogger();
                 
@@ -200,6 +238,66 @@ namespace ObjectHandler {
             } catch (...) {}
     }
 
+    void Logger::startAsync() {
+        AsyncLog::Options options;
+        {
+            Lock lock(asyncMutex_);
+            options = asyncOptions_;
+        }
+        resetAsync(boost::shared_ptr<AsyncLog>(
+            new AsyncLog(&Logger::write, options)));
+    }
+
+    void Logger::resetAsync(const boost::shared_ptr<AsyncLog> &asyncLog) {
+        boost::shared_ptr<AsyncLog> previous;
+        {
+            Lock lock(asyncMutex_);
+            previous = asyncLog_;
+            asyncLog_ = asyncLog;
+        }
+        // Threads which still hold the previous log write their messages
+        // synchronously once it is stopped, it is destroyed by the last
+        // of them.
+        if (previous)
+            previous->stop();
+    }
+
+    boost::shared_ptr<AsyncLog> Logger::asyncLog() const {
+        Lock lock(asyncMutex_);
+        return asyncLog_;
+    }
+
+    void Logger::setAsyncOptions(const AsyncLog::Options &options) {
+        AsyncLog::validate(options);
+        {
+            Lock lock(asyncMutex_);
+            asyncOptions_ = options;
+        }
+        if (asyncLog())
+            startAsync();
+    }
+
+    bool Logger::asynchronous() const {
+        return asyncLog().get() != 0;
+    }
+
+    AsyncLog::Statistics Logger::asyncStatistics() const {
+        boost::shared_ptr<AsyncLog> asyncLog = this->asyncLog();
+        if (asyncLog)
+            return asyncLog->statistics();
+        return AsyncLog::Statistics();
+    }
+
+    void Logger::flush() {
+        boost::shared_ptr<AsyncLog> asyncLog = this->asyncLog();
+        if (asyncLog)
+            asyncLog->flush();
+    }
+
+    void Logger::stopAsync() {
+        resetAsync(boost::shared_ptr<AsyncLog>());
+    }
+
     //get log file
     const std::string Logger::file() const {
         try{
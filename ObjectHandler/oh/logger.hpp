@@ -25,6 +25,12 @@
 #define oh_logger_hpp
 
 #include <oh/singleton.hpp>
+#include <oh/asynclog.hpp>
+#include <boost/shared_ptr.hpp>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#endif
 
 // Some older builds of log4cxx did not include file log4cxxdefines.h.
 // If the #include below fails, it means either that you have the wrong
@@ -62,9 +68,15 @@ namespace ObjectHandler {
             This function accepts an additional optional argument
             logLevel which is passed as an argument to setLogLevel 
             (see below). logLevel defaults to 4 (info).
+            If the optional argument asynchronous is true then
+            messages are queued and written by a background thread,
+            see setAsyncOptions().  Asynchronous logging to the
+            previous logfile is stopped, see stopAsync(), before it is
+            closed.
         */
         void setFile(const std::string &logFileName,
-                     const int &logLevel = 4);
+                     const int &logLevel = 4,
+                     const bool &asynchronous = false);
         //! Direct logging to the console (stdout)
         /*! Logging to the console is disabled by default.
             Call this function with a parameter of 1 to enable
@@ -98,6 +110,29 @@ namespace ObjectHandler {
                           const int &level = 4);
         //@}
 
+        //! \name Asynchronous Logging
+        //@{
+        //! Configure the queue used when logging asynchronously.
+        /*! The options take effect immediately if asynchronous logging
+            is active, otherwise on the next call to setFile().
+        */
+        void setAsyncOptions(const AsyncLog::Options &options);
+        //! Whether messages are being written by a background thread.
+        bool asynchronous() const;
+        //! Counters of the messages queued since asynchronous logging began.
+        /*! Returns all zeroes if asynchronous logging is not active.
+        */
+        AsyncLog::Statistics asyncStatistics() const;
+        //! Wait until all of the queued messages have been written.
+        void flush();
+        //! Write the queued messages, stop the background thread and log synchronously.
+        /*! Must be called before the addin is unloaded, e.g. from
+            xlAutoClose(), if asynchronous logging may be active.  The
+            destructor of the Logger runs during static destruction, when
+            the background thread cannot be joined, and abandons it.
+        */
+        void stopAsync();
+        //@}
         /** \name logFile and logLevel
         *  Miscellaneous utility functions.
         */
@@ -109,7 +144,7 @@ namespace ObjectHandler {
         //@}
 
 
-        virtual ~Logger(){}
+        virtual ~Logger();
     private:
         Logger();
         //log4cxx::LoggerPtr _logger;
@@ -117,6 +152,26 @@ namespace ObjectHandler {
         //log4cxx::AppenderPtr _fileAppender;
         //log4cxx::AppenderPtr _consoleAppender;
         log4cxx::LayoutPtr getLayout();
+        // Pass a message to log4cxx on the calling thread.  Static, so
+        // that the background thread does not refer to the Logger.
+        static void write(int level, const std::string &message);
+        void startAsync();
+        // Replace the asynchronous log, and stop the previous one.
+        void resetAsync(const boost::shared_ptr<AsyncLog> &asyncLog);
+        // The asynchronous log, if any.  Callers hold a copy of the
+        // pointer while they use it, so that another thread may replace
+        // it meanwhile.
+        boost::shared_ptr<AsyncLog> asyncLog() const;
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        typedef boost::mutex Mutex;
+        typedef boost::lock_guard<Mutex> Lock;
+#else
+        struct Mutex {};
+        struct Lock { explicit Lock(Mutex &) {} };
+#endif
+        mutable Mutex asyncMutex_;
+        boost::shared_ptr<AsyncLog> asyncLog_;
+        AsyncLog::Options asyncOptions_;
 
         //log4cxx::AppenderPtr fileAppender_;
         std::string filename_;
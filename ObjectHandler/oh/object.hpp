@@ -86,6 +86,22 @@ namespace ObjectHandler {
         property_t propertyValue(const std::string &propertyName) const;
         //@}
 
+        //! \name Refresh
+        //@{
+        //! Update this Object in place following a change in its precedents.
+        /*! When a precedent of a Dirty Object has changed, the Object is
+            normally discarded and a new one constructed from its ValueObject.
+            A derived class whose state can be brought up to date more cheaply
+            may override this function to do so, and return true.  Returning
+            false requests that the Object be recreated as usual, which is
+            what the default implementation does.
+
+            This function is called only for classes which have been
+            registered with SerializationFactory::registerRefresh().
+        */
+        virtual bool refresh(const ValueObject &) { return false; }
+        //@}
+
         //! \name Permanent Objects
         //@{
         //! Query the value of the "permanent" flag.
@@ -121,7 +137,30 @@ namespace ObjectHandler {
         Object(const Object&);
     };
 
+    //! Mixin for Objects which write their state to their ValueObject only when it is read.
+    /*! An Object whose state changes frequently, and which records that
+        state in its ValueObject, may derive from this class as well as
+        from Object, and write the ValueObject in publishProperties() rather
+        than after each change.  publishProperties() is called through the
+        free function below, before the ValueObject is read by
+        Object::propertyValue(), Object::propertyNames(),
+        ObjectWrapper::properties() and SerializationFactory.
+    */
+    class PropertyPublisher {
+    public:
+        virtual ~PropertyPublisher() {}
+        //! Write the state of this Object to its ValueObject, if it has changed.
+        virtual void publishProperties() const = 0;
+    };
+
+    //! Call publishProperties() on the given Object if it is a PropertyPublisher.
+    inline void publishProperties(const Object &object) {
+        if (const PropertyPublisher *publisher = dynamic_cast<const PropertyPublisher*>(&object))
+            publisher->publishProperties();
+    }
+
     inline std::set<std::string> Object::propertyNames() const {
+        publishProperties(*this);
         if(mProps)
             return mProps->getPropertyNames();
         else
@@ -129,6 +168,7 @@ namespace ObjectHandler {
     }
 
     inline std::vector<std::string> Object::propertyNamesVector() const {
+        publishProperties(*this);
         if(mProps)
             return mProps->getPropertyNamesVector();
         else
@@ -136,6 +176,7 @@ namespace ObjectHandler {
     }
 
     inline property_t Object::propertyValue(const std::string &propertyName) const {
+        publishProperties(*this);
         if (mProps)
             return mProps->getProperty(propertyName);
         OH_FAIL("ObjectHandler error: attempt to retrieve property "
@@ -26,6 +26,7 @@
 #include <oh/repository.hpp>
 #include <oh/utilities.hpp>
 #include <oh/exception.hpp>
+#include <oh/functionstatistics.hpp>
 #include <oh/property.hpp>
 #include <oh/group.hpp>
 #include <oh/range.hpp>
@@ -0,0 +1,145 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Class ObjectIndex - Case-insensitive hash index of ObjectWrappers
+*/
+
+#ifndef oh_objectindex_hpp
+#define oh_objectindex_hpp
+
+#include <oh/iless.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace ObjectHandler {
+
+    class ObjectWrapper;
+
+    //! Case-insensitive hash index of ObjectWrappers.
+    /*! An open-addressing hash table with linear probing.  Each slot holds
+        the case-folded ID, computed once when the entry is inserted, along
+        with its hash.  A lookup hashes the requested ID once and then
+        compares it character by character against the folded keys, so
+        retrieval neither allocates nor consults a std::locale.
+
+        The caller supplies the hash (see foldedHash()) so that it may be
+        shared with other structures keyed on the same ID.
+    */
+    class ObjectIndex {
+    public:
+        ObjectIndex() : size_(0) {}
+
+        //! Return the entry for the given ID, or a null pointer if none exists.
+        boost::shared_ptr<ObjectWrapper> find(const std::string &objectID,
+                                              std::size_t hash) const {
+            if (slots_.empty())
+                return boost::shared_ptr<ObjectWrapper>();
+            return slots_[locate(objectID, hash)].objectWrapper;
+        }
+        //! Insert the entry for the given ID, replacing any existing entry.
+        void insert(const std::string &objectID, std::size_t hash,
+                    const boost::shared_ptr<ObjectWrapper> &objectWrapper) {
+            // Keep the load factor at or below one half.
+            if (2 * (size_ + 1) > slots_.size())
+                rehash(slots_.empty() ? 16 : 2 * slots_.size());
+            Slot &slot = slots_[locate(objectID, hash)];
+            if (!slot.objectWrapper) {
+                slot.hash = hash;
+                slot.key.resize(objectID.size());
+                std::transform(objectID.begin(), objectID.end(), slot.key.begin(), foldCase);
+                ++size_;
+            }
+            slot.objectWrapper = objectWrapper;
+        }
+        //! Remove the entry for the given ID.  Return false if there was none.
+        bool erase(const std::string &objectID, std::size_t hash) {
+            if (slots_.empty())
+                return false;
+            std::size_t mask = slots_.size() - 1;
+            std::size_t i = locate(objectID, hash);
+            if (!slots_[i].objectWrapper)
+                return false;
+            slots_[i] = Slot();
+            --size_;
+            // Backward-shift the rest of the probe sequence so that no
+            // tombstones are required.
+            for (std::size_t j = (i + 1) & mask; slots_[j].objectWrapper; j = (j + 1) & mask) {
+                std::size_t home = slots_[j].hash & mask;
+                if (((j - home) & mask) >= ((j - i) & mask)) {
+                    std::swap(slots_[i], slots_[j]);
+                    i = j;
+                }
+            }
+            return true;
+        }
+        //! Remove all entries.
+        void clear() {
+            std::vector<Slot>().swap(slots_);
+            size_ = 0;
+        }
+        //! Number of entries.
+        std::size_t size() const { return size_; }
+
+    private:
+        struct Slot {
+            Slot() : hash(0) {}
+            std::size_t hash;
+            std::string key;
+            boost::shared_ptr<ObjectWrapper> objectWrapper;
+        };
+
+        static bool matches(const Slot &slot, const std::string &objectID, std::size_t hash) {
+            return slot.hash == hash && foldedEqual(objectID, slot.key);
+        }
+
+        // Index of the slot holding the given ID, or of the empty slot
+        // at which it would be inserted.
+        std::size_t locate(const std::string &objectID, std::size_t hash) const {
+            std::size_t mask = slots_.size() - 1;
+            std::size_t i = hash & mask;
+            while (slots_[i].objectWrapper && !matches(slots_[i], objectID, hash))
+                i = (i + 1) & mask;
+            return i;
+        }
+
+        void rehash(std::size_t capacity) {
+            std::vector<Slot> old(capacity);
+            old.swap(slots_);
+            std::size_t mask = capacity - 1;
+            for (std::vector<Slot>::iterator s = old.begin(); s != old.end(); ++s) {
+                if (!s->objectWrapper)
+                    continue;
+                std::size_t i = s->hash & mask;
+                while (slots_[i].objectWrapper)
+                    i = (i + 1) & mask;
+                slots_[i].hash = s->hash;
+                slots_[i].key.swap(s->key);
+                slots_[i].objectWrapper.swap(s->objectWrapper);
+            }
+        }
+
+        std::vector<Slot> slots_;
+        std::size_t size_;
+    };
+
+}
+
+#endif
+
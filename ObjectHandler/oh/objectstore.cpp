@@ -0,0 +1,161 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <oh/config.hpp>
+#endif
+
+#include <oh/objectstore.hpp>
+#include <algorithm>
+
+using boost::shared_ptr;
+using std::string;
+
+namespace ObjectHandler {
+
+    namespace {
+
+        struct EntryLess {
+            bool operator()(const ObjectStore::Entry &a, const ObjectStore::Entry &b) const {
+                return less_(a.first, b.first);
+            }
+            my_iless less_;
+        };
+
+    }
+
+    shared_ptr<ObjectWrapper> ObjectStore::find(const string &objectID) const {
+        std::size_t hash = foldedHash(objectID);
+        const Shard &s = shard(hash);
+        ReadLock lock(s.mutex);
+        return s.objectIndex.find(objectID, hash);
+    }
+
+    std::vector<shared_ptr<ObjectWrapper> >
+    ObjectStore::find(const std::vector<string> &objectIDs) const {
+        std::vector<shared_ptr<ObjectWrapper> > ret(objectIDs.size());
+        std::vector<std::size_t> hashes(objectIDs.size());
+        // Pairs of (shard, position in objectIDs), sorted to bring together
+        // the IDs which fall in the same shard.
+        std::vector<std::pair<std::size_t, std::size_t> > order(objectIDs.size());
+        for (std::size_t i = 0; i < objectIDs.size(); ++i) {
+            hashes[i] = foldedHash(objectIDs[i]);
+            order[i] = std::make_pair(&shard(hashes[i]) - shards_, i);
+        }
+        std::sort(order.begin(), order.end());
+        std::size_t i = 0;
+        while (i < order.size()) {
+            std::size_t index = order[i].first;
+            const Shard &s = shards_[index];
+            ReadLock lock(s.mutex);
+            do {
+                std::size_t n = order[i].second;
+                ret[n] = s.objectIndex.find(objectIDs[n], hashes[n]);
+            } while (++i < order.size() && order[i].first == index);
+        }
+        return ret;
+    }
+
+    bool ObjectStore::exists(const string &objectID) const {
+        return find(objectID).get() != 0;
+    }
+
+    std::size_t ObjectStore::size() const {
+        std::size_t ret = 0;
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            ReadLock lock(shards_[i].mutex);
+            ret += shards_[i].objectMap.size();
+        }
+        return ret;
+    }
+
+    std::vector<ObjectStore::Entry> ObjectStore::entries() const {
+        std::vector<Entry> ret;
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            ReadLock lock(shards_[i].mutex);
+            ret.insert(ret.end(), shards_[i].objectMap.begin(), shards_[i].objectMap.end());
+        }
+        std::sort(ret.begin(), ret.end(), EntryLess());
+        return ret;
+    }
+
+    void ObjectStore::insert(const string &objectID,
+                             const shared_ptr<ObjectWrapper> &objectWrapper) {
+        std::size_t hash = foldedHash(objectID);
+        Shard &s = shard(hash);
+        WriteLock lock(s.mutex);
+        s.objectMap[objectID] = objectWrapper;
+        s.objectIndex.insert(objectID, hash, objectWrapper);
+    }
+
+    bool ObjectStore::erase(const string &objectID) {
+        // Release the last reference to the ObjectWrapper outside of the lock,
+        // its destructor unregisters it from its precedents.
+        shared_ptr<ObjectWrapper> erased;
+        std::size_t hash = foldedHash(objectID);
+        Shard &s = shard(hash);
+        WriteLock lock(s.mutex);
+        erased = s.objectIndex.find(objectID, hash);
+        if (!erased)
+            return false;
+        s.objectIndex.erase(objectID, hash);
+        s.objectMap.erase(objectID);
+        ++generation_;
+        return true;
+    }
+
+    void ObjectStore::eraseTransient() {
+        for (std::size_t n = 0; n < shardCount; ++n) {
+            WriteLock lock(shards_[n].mutex);
+            ObjectMap &objectMap = shards_[n].objectMap;
+            ObjectMap::iterator i = objectMap.begin();
+            while (i != objectMap.end()) {
+                if (i->second->permanent()) {
+                    ++i;
+                } else {
+                    shards_[n].objectIndex.erase(i->first, foldedHash(i->first));
+                    objectMap.erase(i++);
+                }
+            }
+        }
+        ++generation_;
+    }
+
+    ObjectStore::~ObjectStore() {
+        clear();
+    }
+
+    void ObjectStore::clear() {
+        // Each ObjectWrapper holds references to its precedents.  Release them
+        // all before clearing the maps, otherwise destroying the last dependant
+        // in a long chain would destroy the whole chain recursively.
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            WriteLock lock(shards_[i].mutex);
+            ObjectMap::const_iterator j;
+            for (j = shards_[i].objectMap.begin(); j != shards_[i].objectMap.end(); ++j)
+                j->second->unregisterWithAll();
+        }
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            WriteLock lock(shards_[i].mutex);
+            shards_[i].objectMap.clear();
+            shards_[i].objectIndex.clear();
+        }
+        ++generation_;
+    }
+
+}
+
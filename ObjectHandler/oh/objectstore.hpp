@@ -0,0 +1,142 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Class ObjectStore - Sharded container for the Objects in the Repository
+*/
+
+#ifndef oh_objectstore_hpp
+#define oh_objectstore_hpp
+
+#include <oh/objectwrapper.hpp>
+#include <oh/objectindex.hpp>
+#include <oh/iless.hpp>
+#include <oh/ohdefines.hpp>
+#include <map>
+#include <vector>
+#include <string>
+
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/atomic.hpp>
+#endif
+
+namespace ObjectHandler {
+
+    //! Sharded container for the Objects in the Repository.
+    /*! The ObjectWrappers are distributed over a fixed number of shards
+        according to a hash of the case-folded object ID, so that two IDs
+        which differ only in case always map to the same shard.  Within a
+        shard, objects are held in a case-insensitive std::map, which
+        provides the ordered view used for listing and dumping, and in an
+        ObjectIndex keyed on the same hash, which serves all lookups by ID
+        in constant time.
+
+        If OH_ENABLE_THREAD_SAFE_REPOSITORY is defined then each shard is
+        guarded by its own reader/writer lock.  Lookups take a shared lock
+        on a single shard only, so that any number of threads may retrieve
+        objects concurrently; insertions and deletions take an exclusive
+        lock on the affected shard.  Otherwise the locks compile to nothing.
+
+        This class is not exported across DLL boundaries, the Repository
+        holds its only instance as a static variable in repository.cpp.
+    */
+    class ObjectStore {
+    public:
+        ObjectStore() : generation_(0) {}
+        ~ObjectStore();
+
+        //! The type of the structure used to store the Objects in each shard.
+        typedef std::map<std::string, boost::shared_ptr<ObjectWrapper>, my_iless> ObjectMap;
+        //! An entry in the store.
+        typedef std::pair<std::string, boost::shared_ptr<ObjectWrapper> > Entry;
+
+        //! Number of shards, must be a power of two.
+        static const std::size_t shardCount = 32;
+
+        //! \name Lookup
+        //@{
+        //! Return the ObjectWrapper with the given ID, or a null pointer if none exists.
+        boost::shared_ptr<ObjectWrapper> find(const std::string &objectID) const;
+        //! Return the ObjectWrappers with the given IDs, with null pointers for any which do not exist.
+        /*! The IDs are grouped by shard, and the lock on each shard is taken
+            at most once for the whole batch.
+        */
+        std::vector<boost::shared_ptr<ObjectWrapper> > find(
+            const std::vector<std::string> &objectIDs) const;
+        //! Indicate whether an Object with the given ID is present.
+        bool exists(const std::string &objectID) const;
+        //! Count of all the Objects in the store.
+        std::size_t size() const;
+        //! Copy the contents of the store into a vector ordered by case-insensitive ID.
+        std::vector<Entry> entries() const;
+        //! A counter which is incremented whenever an entry is removed.
+        /*! Clients which cache ObjectWrappers may compare this value against
+            the one observed when the cache was filled to detect deletions.
+        */
+        std::size_t generation() const { return generation_; }
+        //@}
+
+        //! \name Modifiers
+        //@{
+        //! Store the ObjectWrapper with the given ID, replacing any existing entry.
+        void insert(const std::string &objectID,
+                    const boost::shared_ptr<ObjectWrapper> &objectWrapper);
+        //! Remove the entry with the given ID.  Return false if there was none.
+        bool erase(const std::string &objectID);
+        //! Remove all entries whose Objects are not permanent.
+        void eraseTransient();
+        //! Remove all entries.
+        void clear();
+        //@}
+
+    private:
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        typedef boost::shared_mutex Mutex;
+        typedef boost::shared_lock<Mutex> ReadLock;
+        typedef boost::unique_lock<Mutex> WriteLock;
+#else
+        struct Mutex {};
+        struct ReadLock { explicit ReadLock(Mutex &) {} };
+        typedef ReadLock WriteLock;
+#endif
+        struct Shard {
+            mutable Mutex mutex;
+            ObjectMap objectMap;
+            ObjectIndex objectIndex;
+        };
+        // The low bits of the hash select the slot in the ObjectIndex,
+        // take the shard from higher bits.
+        Shard &shard(std::size_t hash) {
+            return shards_[(hash >> 20) & (shardCount - 1)];
+        }
+        const Shard &shard(std::size_t hash) const {
+            return shards_[(hash >> 20) & (shardCount - 1)];
+        }
+        Shard shards_[shardCount];
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        boost::atomic<std::size_t> generation_;
+#else
+        std::size_t generation_;
+#endif
+    };
+
+}
+
+#endif
+
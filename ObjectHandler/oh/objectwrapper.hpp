@@ -26,13 +26,27 @@
 #define oh_objectwrapper_hpp
 
 #include <ostream>
+#include <vector>
+#include <set>
+#include <typeinfo>
 #include <oh/object.hpp>
 #include <oh/observable.hpp>
 #include <oh/serializationfactory.hpp>
 #include <oh/utilities.hpp>
+#include <boost/function.hpp>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/thread/mutex.hpp>
+#include <boost/atomic.hpp>
+#define OH_OBJECT_WRAPPER_LOCK boost::mutex::scoped_lock lock(mutex_);
+#else
+#define OH_OBJECT_WRAPPER_LOCK
+#endif
 
 namespace ObjectHandler {
 
+    //! Reads the ValueObject of an Object whose creation has been deferred.
+    typedef boost::function<boost::shared_ptr<ValueObject> ()> ValueObjectLoader;
+
     //! Container to ensure that Object references are updated.
     /*! ObjectWrapper holds a reference to an Object.  Before returning the reference
         the ObjectHandler client application, the ObjectWrapper ensures that the state
@@ -45,6 +59,30 @@ namespace ObjectHandler {
         ObjectHandler client application attempts to retrieve a Dirty Object, the
         ObjectWrapper first recreates the Object, ensuring that its state reflects
         any changes in the precedents.
+
+        Changes are propagated lazily.  When an Object is replaced, all of its
+        direct and indirect dependants are marked Dirty in a single iterative
+        traversal of the dependency graph, in which each ObjectWrapper is
+        visited once however many paths lead to it.  Nothing is recreated at
+        that point.  When a Dirty Object is next retrieved, it and any of its
+        precedents which are also Dirty are recreated, each exactly once,
+        precedents before dependants.
+
+        An ObjectWrapper may also be constructed from a ValueObject alone, in
+        which case creation of the Object is deferred.  The Repository calls
+        create() the first time the Object is retrieved, see
+        Repository::deferObject().  Until then the ValueObject stands in for
+        the Object's properties, and the ObjectWrapper has no precedents.
+        The ValueObject may itself be read on demand, from a
+        ValueObjectLoader, the first time that it is needed.
+
+        If OH_ENABLE_THREAD_SAFE_REPOSITORY is defined then access to the
+        contained Object and the Dirty flag is guarded by a mutex, so that when
+        several threads retrieve the same Dirty Object it is recreated once.
+        The traversals of the dependency graph walk copies of the sets of
+        precedents and dependants, taken under the locks of Observer and
+        Observable, so that recreation may run while the Repository registers
+        the precedents of another Object.
     */
     class ObjectWrapper : public Observer, public Observable {        
     public:
@@ -52,6 +90,13 @@ namespace ObjectHandler {
         //@{
         //! Construct the ObjectWrapper from the given Object.
         ObjectWrapper(const boost::shared_ptr<Object>& object);
+        //! Construct the ObjectWrapper from a ValueObject, deferring creation of the Object.
+        ObjectWrapper(const boost::shared_ptr<ValueObject>& valueObject);
+        //! As above, but the ValueObject is read from the loader when it is first needed.
+        /*! The value of the Permanent property is given, so that the
+            ValueObject need not be read to answer permanent().
+        */
+        ObjectWrapper(const ValueObjectLoader& loader, bool permanent);
         //! Virtual destructor - unregister with Observers.
         virtual ~ObjectWrapper() { unregisterWithAll(); }
         //@}
@@ -62,18 +107,46 @@ namespace ObjectHandler {
         /*! This function is called on any attempt to retrieve a Dirty Object.
             To recreate the Object, we take its ValueObject, which is a snapshot
             of the arguments to the Object's constructor, and pass this ValueObject
-            to the SerializationFactory which recreates the Object.
+            to the SerializationFactory which recreates the Object.  If the
+            Object's class supports it, the Object is instead updated in place
+            by Object::refresh().
+
+            Any Dirty precedents are recreated first, in topological order, so
+            that the creator function finds them up to date and recreation does
+            not recurse through the Repository.
         */
         void recreate();
         //! Update the ObjectWrapper following a change in its precedents.
         /*! This function is called by the Observable with which this Observer
-            has registered.  Sets Dirty -> true.
+            has registered.  Sets Dirty -> true for this ObjectWrapper and all
+            of its dependants.
         */
         virtual void update();
         //! Return a copy of the reference to the Object contained by ObjectWrapper.
-        boost::shared_ptr<Object> object() const { return object_; }
+        /*! Throws an exception if creation of the Object has been deferred
+            and create() has not yet been called.
+        */
+        boost::shared_ptr<Object> object() const;
+        //! Return the contained Object downcast to T, or a null pointer if it is not a T.
+        /*! The result of the downcast, including a failed downcast, is cached
+            until the Object is replaced or recreated, so that repeated calls
+            for the same type involve only a comparison of type_info pointers.
+            Throws an exception as object() if the Object has not been created.
+        */
+        template <class T>
+        boost::shared_ptr<T> typedObject() const;
         //! Replace the contained Object with the one provided.
         void reset(boost::shared_ptr<Object> object);
+        //! Discard the contained Object, deferring creation of its replacement.
+        void defer(const boost::shared_ptr<ValueObject> &valueObject);
+        //! As above, the ValueObject of the replacement is read from the loader.
+        void defer(const ValueObjectLoader &loader, bool permanent);
+        //! Create the Object whose creation was deferred.
+        /*! Returns true if the Object was created by this call, false if it
+            already existed.  On failure the ObjectWrapper is left unchanged,
+            so that the error is reported again on the next attempt.
+        */
+        bool create();
         //@}
 
         //! \name Inspectors
@@ -85,37 +158,255 @@ namespace ObjectHandler {
         //! Query the value of the dirty flag.
         /*! False means the Object is up to date, true means it is invalid.
         */
-        bool dirty() const { return dirty_; }
+        bool dirty() const;
+        //! False if creation of the Object has been deferred and it does not yet exist.
+        bool created() const;
+        //! The ValueObject of the Object, whether or not it has been created.
+        boost::shared_ptr<ValueObject> properties() const;
+        //! Query the value of the Permanent flag, whether or not the Object has been created.
+        bool permanent() const;
         //@}
 
         //! \name Logging
         //@{
         //! Write this object to the given output stream.
-        virtual void dump(std::ostream& out) { object_->dump(out); }
+        virtual void dump(std::ostream& out);
         //@}
 
     protected:
         //! Reference to the Object contained by ObjectWrapper.
         boost::shared_ptr<Object> object_;
+        //! The ValueObject of an Object whose creation has been deferred.
+        /*! Null until it has been read if the ObjectWrapper was constructed
+            from a ValueObjectLoader.
+        */
+        mutable boost::shared_ptr<ValueObject> valueObject_;
 
     private:
+        // The ValueObject of an Object whose creation has been deferred,
+        // read from the loader if necessary.  Called with the lock held.
+        const boost::shared_ptr<ValueObject>& deferredValueObject() const;
+        // Reads valueObject_ if it has not yet been read.
+        mutable ValueObjectLoader loader_;
+        // The Permanent property of the ValueObject to be read by loader_.
+        bool loaderPermanent_;
+        // Recreate the contained Object alone, if it is still Dirty.
+        void recreateObject();
+        // Set Dirty -> true for all dependants, and optionally for this object.
+        void invalidate(bool includeSelf);
+        // Record a visit by the traversal with the given epoch and set
+        // Dirty -> true, return false if that traversal had already visited.
+        bool visit(std::size_t epoch);
+        // Discard the downcasts cached by typedObject(), called whenever object_ changes.
+        void clearTypeCache();
+        // Return a new value identifying a traversal of the dependency graph.
+        static std::size_t nextEpoch() {
+            return ++epochCounter_;
+        }
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        static boost::atomic<std::size_t> epochCounter_;
+#else
+        static std::size_t epochCounter_;
+#endif
         // Flag indicating whether contained Object is up to date.
         bool dirty_;
+        // The traversal of the dependency graph which last visited this object.
+        std::size_t epoch_;
         // Time at which Object was first created.
         double creationTime_;
         // Time at which Object was last recreated.
         double updateTime_;
+        // The downcasts of object_ most recently requested from typedObject().
+        struct TypedObject {
+            TypedObject() : type(0) {}
+            const std::type_info *type;
+            boost::shared_ptr<void> object;
+        };
+        static const std::size_t typeCacheSize = 2;
+        mutable TypedObject typeCache_[typeCacheSize];
+        mutable std::size_t typeCacheNext_;
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        // Guards object_, valueObject_, loader_, dirty_, epoch_ and the type cache.
+        mutable boost::mutex mutex_;
+#endif
     };
 
     inline ObjectWrapper::ObjectWrapper(const boost::shared_ptr<Object>& object)
-        : object_(object), dirty_(false) {
+        : object_(object), loaderPermanent_(false),
+          dirty_(false), epoch_(0), typeCacheNext_(0) {
             creationTime_ = updateTime_ = getTime();
     }
 
+    inline ObjectWrapper::ObjectWrapper(const boost::shared_ptr<ValueObject>& valueObject)
+        : valueObject_(valueObject), loaderPermanent_(false),
+          dirty_(false), epoch_(0), typeCacheNext_(0) {
+            creationTime_ = updateTime_ = getTime();
+    }
+
+    inline ObjectWrapper::ObjectWrapper(const ValueObjectLoader& loader, bool permanent)
+        : loader_(loader), loaderPermanent_(permanent),
+          dirty_(false), epoch_(0), typeCacheNext_(0) {
+            creationTime_ = updateTime_ = getTime();
+    }
+
+    inline const boost::shared_ptr<ValueObject>& ObjectWrapper::deferredValueObject() const {
+        if (!valueObject_ && loader_) {
+            valueObject_ = loader_();
+            loader_.clear();
+        }
+        return valueObject_;
+    }
+
+    inline boost::shared_ptr<Object> ObjectWrapper::object() const {
+        OH_OBJECT_WRAPPER_LOCK
+        OH_REQUIRE(object_, "Object with ID '" << deferredValueObject()->objectId()
+            << "' has not been created");
+        return object_;
+    }
+
+    template <class T>
+    inline boost::shared_ptr<T> ObjectWrapper::typedObject() const {
+        OH_OBJECT_WRAPPER_LOCK
+        OH_REQUIRE(object_, "Object with ID '" << deferredValueObject()->objectId()
+            << "' has not been created");
+        // If typeid(T) yields distinct type_info objects in different
+        // modules then the comparison fails and the downcast is repeated.
+        const std::type_info *type = &typeid(T);
+        for (std::size_t i = 0; i < typeCacheSize; ++i) {
+            if (typeCache_[i].type == type)
+                return boost::static_pointer_cast<T>(typeCache_[i].object);
+        }
+        boost::shared_ptr<T> ret = boost::dynamic_pointer_cast<T>(object_);
+        TypedObject &entry = typeCache_[typeCacheNext_];
+        typeCacheNext_ = (typeCacheNext_ + 1) % typeCacheSize;
+        entry.type = type;
+        entry.object = ret;
+        return ret;
+    }
+
+    inline void ObjectWrapper::clearTypeCache() {
+        for (std::size_t i = 0; i < typeCacheSize; ++i)
+            typeCache_[i] = TypedObject();
+    }
+
+    inline bool ObjectWrapper::dirty() const {
+        OH_OBJECT_WRAPPER_LOCK
+        return dirty_;
+    }
+
+    inline bool ObjectWrapper::created() const {
+        OH_OBJECT_WRAPPER_LOCK
+        return object_.get() != 0;
+    }
+
+    inline boost::shared_ptr<ValueObject> ObjectWrapper::properties() const {
+        OH_OBJECT_WRAPPER_LOCK
+        if (!object_)
+            return deferredValueObject();
+        publishProperties(*object_);
+        return object_->properties();
+    }
+
+    inline bool ObjectWrapper::permanent() const {
+        OH_OBJECT_WRAPPER_LOCK
+        if (object_)
+            return object_->permanent();
+        if (!valueObject_ && loader_)
+            return loaderPermanent_;
+        // Classes with no Permanent property create transient Objects.
+        try {
+            return boost::get<bool>(valueObject_->getProperty("Permanent"));
+        } catch (const std::exception &) {
+            return false;
+        }
+    }
+
+    inline bool ObjectWrapper::create() {
+        OH_OBJECT_WRAPPER_LOCK
+        // Another thread may have created the Object while we were waiting.
+        if (object_)
+            return false;
+        const boost::shared_ptr<ValueObject> &valueObject = deferredValueObject();
+        try {
+            object_ = SerializationFactory::instance().recreateObject(valueObject);
+            clearTypeCache();
+        } catch (const std::exception &e) {
+            OH_FAIL("Error creating object with ID '" << valueObject->objectId()
+                << "' of class " << valueObject->className()
+                << ", whose creation was deferred when it was loaded: " << e.what());
+        }
+        valueObject_.reset();
+        creationTime_ = updateTime_ = getTime();
+        return true;
+    }
+
+    inline void ObjectWrapper::dump(std::ostream& out) {
+        boost::shared_ptr<Object> object;
+        boost::shared_ptr<ValueObject> valueObject;
+        {
+            OH_OBJECT_WRAPPER_LOCK
+            object = object_;
+            valueObject = valueObject_;
+        }
+        // A ValueObject which has not yet been read is not read to be logged.
+        if (object)
+            object->dump(out);
+        else if (valueObject)
+            out << "creation deferred, class = " << valueObject->className()
+                << std::endl << std::endl;
+        else
+            out << "creation deferred, properties not yet read"
+                << std::endl << std::endl;
+    }
+
     inline void ObjectWrapper::recreate(){
+
+        // Depth-first traversal of the Dirty precedents, collecting them in
+        // post-order so that each appears after all of its own precedents.
+        std::vector<ObjectWrapper*> order;
+        std::set<ObjectWrapper*> visited;
+        std::vector<std::pair<ObjectWrapper*, bool> > stack;
+        stack.push_back(std::make_pair(this, false));
+        while (!stack.empty()) {
+            std::pair<ObjectWrapper*, bool> top = stack.back();
+            stack.pop_back();
+            if (top.second) {
+                order.push_back(top.first);
+                continue;
+            }
+            if (!visited.insert(top.first).second)
+                continue;
+            stack.push_back(std::make_pair(top.first, true));
+            // A copy, registration by other threads may change the set.
+            const std::vector<boost::shared_ptr<Observable> > precedents =
+                top.first->observables();
+            std::vector<boost::shared_ptr<Observable> >::const_iterator i;
+            for (i = precedents.begin(); i != precedents.end(); ++i) {
+                ObjectWrapper *precedent = dynamic_cast<ObjectWrapper*>(i->get());
+                if (precedent && precedent->dirty()
+                    && visited.find(precedent) == visited.end())
+                    stack.push_back(std::make_pair(precedent, false));
+            }
+        }
+
+        for (std::vector<ObjectWrapper*>::const_iterator i = order.begin();
+             i != order.end(); ++i)
+            (*i)->recreateObject();
+    }
+
+    inline void ObjectWrapper::recreateObject(){
+        OH_OBJECT_WRAPPER_LOCK
+        // Another thread may have recreated the Object while we were waiting.
+        // An Object whose creation is deferred is created up to date.
+        if (!dirty_ || !object_)
+            return;
         try {
-            object_ = SerializationFactory::instance().recreateObject( 
-                object_->properties());
+            if (!SerializationFactory::instance().refreshObject(object_)) {
+                publishProperties(*object_);
+                object_ = SerializationFactory::instance().recreateObject( 
+                    object_->properties());
+                clearTypeCache();
+            }
             dirty_ = false;
             updateTime_ = getTime();
         } catch (const std::exception &e) {
@@ -124,15 +415,99 @@ namespace ObjectHandler {
     }
 
     inline void ObjectWrapper::update(){
-        notifyObservers();
+        invalidate(true);
+    }
+
+    inline bool ObjectWrapper::visit(std::size_t epoch){
+        OH_OBJECT_WRAPPER_LOCK
+        if (epoch_ == epoch)
+            return false;
+        epoch_ = epoch;
         dirty_ = true;
+        return true;
+    }
+
+    inline void ObjectWrapper::invalidate(bool includeSelf){
+        std::size_t epoch = nextEpoch();
+        {
+            OH_OBJECT_WRAPPER_LOCK
+            epoch_ = epoch;
+            if (includeSelf)
+                dirty_ = true;
+        }
+
+        bool successful = true;
+        std::string errMsg;
+        // The observers of each ObjectWrapper are copied, registration by
+        // other threads may change the sets.
+        std::vector<Observer*> pending = observers();
+        while (!pending.empty()) {
+            Observer *observer = pending.back();
+            pending.pop_back();
+            ObjectWrapper *dependant = dynamic_cast<ObjectWrapper*>(observer);
+            if (dependant) {
+                if (!dependant->visit(epoch))
+                    continue;
+                std::vector<Observer*> dependants = dependant->observers();
+                pending.insert(pending.end(), dependants.begin(), dependants.end());
+            } else {
+                // Observers other than ObjectWrappers are notified as usual,
+                // see Observable::notifyObservers().
+                try {
+                    observer->update();
+                } catch (std::exception& e) {
+                    successful = false;
+                    errMsg = e.what();
+                } catch (...) {
+                    successful = false;
+                }
+            }
+        }
+        OH_REQUIRE(successful,
+                   "could not notify one or more observers: " << errMsg);
     }
 
     inline void ObjectWrapper::reset(boost::shared_ptr<Object> object) {
-        object_ = object;
-        dirty_ = false;
-        updateTime_ = getTime();
-        notifyObservers();
+        {
+            OH_OBJECT_WRAPPER_LOCK
+            object_ = object;
+            clearTypeCache();
+            valueObject_.reset();
+            loader_.clear();
+            dirty_ = false;
+            updateTime_ = getTime();
+        }
+        invalidate(false);
+    }
+
+    inline void ObjectWrapper::defer(const boost::shared_ptr<ValueObject> &valueObject) {
+        {
+            OH_OBJECT_WRAPPER_LOCK
+            object_.reset();
+            clearTypeCache();
+            valueObject_ = valueObject;
+            loader_.clear();
+            dirty_ = false;
+            updateTime_ = getTime();
+        }
+        // The precedents of the new Object are not known until it is created.
+        unregisterWithAll();
+        invalidate(false);
+    }
+
+    inline void ObjectWrapper::defer(const ValueObjectLoader &loader, bool permanent) {
+        {
+            OH_OBJECT_WRAPPER_LOCK
+            object_.reset();
+            clearTypeCache();
+            valueObject_.reset();
+            loader_ = loader;
+            loaderPermanent_ = permanent;
+            dirty_ = false;
+            updateTime_ = getTime();
+        }
+        unregisterWithAll();
+        invalidate(false);
     }
 
     //! Log the given ObjectWrapper to the given stream.
@@ -26,18 +26,34 @@
 #ifndef oh_observable_hpp
 #define oh_observable_hpp
 
+#include <oh/ohdefines.hpp>
 #include <oh/exception.hpp>
 
 #include <boost/shared_ptr.hpp>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/thread/mutex.hpp>
+#define OH_OBSERVABLE_LOCK boost::mutex::scoped_lock observableLock(observableMutex_);
+#define OH_OBSERVER_LOCK boost::mutex::scoped_lock observerLock(observerMutex_);
+#else
+#define OH_OBSERVABLE_LOCK
+#define OH_OBSERVER_LOCK
+#endif
 
 #include <set>
+#include <vector>
 
 namespace ObjectHandler {
 
     class Observer;
 
     //! Object that notifies its changes to a set of observers
-    /*! \ingroup patterns */
+    /*! If OH_ENABLE_THREAD_SAFE_REPOSITORY is defined then the set of
+        observers is guarded by a mutex, and observers() returns a copy of
+        it, so that it may be walked while other threads register or
+        unregister observers.
+
+        \ingroup patterns
+    */
     class Observable {
         friend class Observer;
       public:
@@ -50,15 +66,25 @@ namespace ObjectHandler {
             or when the programmer desires to notify any changes.
         */
         void notifyObservers();
+      protected:
+        //! A copy of the set of observers currently registered with this object.
+        std::vector<Observer*> observers() const;
       private:
         typedef std::set<Observer*>::iterator iterator;
         std::pair<iterator, bool> registerObserver(Observer*);
         size_t unregisterObserver(Observer*);
         std::set<Observer*> observers_;
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        mutable boost::mutex observableMutex_;
+#endif
     };
 
     //! Object that gets notified when a given observable changes
-    /*! \ingroup patterns */
+    /*! If OH_ENABLE_THREAD_SAFE_REPOSITORY is defined then the set of
+        observables is guarded by a mutex, as for Observable.
+
+        \ingroup patterns
+    */
     class Observer {
       public:
         // constructors, assignment, destructor
@@ -77,9 +103,15 @@ namespace ObjectHandler {
         */
         void unregisterWithAll();
         virtual void update() = 0;
+      protected:
+        //! A copy of the set of observables with which this object is currently registered.
+        std::vector<boost::shared_ptr<Observable> > observables() const;
       private:
         std::set<boost::shared_ptr<Observable> > observables_;
         typedef std::set<boost::shared_ptr<Observable> >::iterator iterator;
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        mutable boost::mutex observerMutex_;
+#endif
     };
 
 
@@ -106,19 +138,28 @@ namespace ObjectHandler {
         return *this;
     }
 
+    inline std::vector<Observer*> Observable::observers() const {
+        OH_OBSERVABLE_LOCK
+        return std::vector<Observer*>(observers_.begin(), observers_.end());
+    }
+
     inline std::pair<std::set<Observer*>::iterator, bool>
     Observable::registerObserver(Observer* o) {
+        OH_OBSERVABLE_LOCK
         return observers_.insert(o);
     }
 
     inline size_t Observable::unregisterObserver(Observer* o) {
+        OH_OBSERVABLE_LOCK
         return observers_.erase(o);
     }
 
     inline void Observable::notifyObservers() {
         bool successful = true;
         std::string errMsg;
-        for (iterator i=observers_.begin(); i!=observers_.end(); ++i) {
+        std::vector<Observer*> observers = this->observers();
+        for (std::vector<Observer*>::const_iterator i=observers.begin();
+             i!=observers.end(); ++i) {
             try {
                 (*i)->update();
             } catch (std::exception& e) {
@@ -140,19 +181,24 @@ namespace ObjectHandler {
     }
 
 
-    inline Observer::Observer(const Observer& o)
-    : observables_(o.observables_) {
+    // The lock of an Observer is never held while the lock of an
+    // Observable is taken, nor vice versa.
+
+    inline Observer::Observer(const Observer& o) {
+        std::vector<boost::shared_ptr<Observable> > observables = o.observables();
+        observables_.insert(observables.begin(), observables.end());
         for (iterator i=observables_.begin(); i!=observables_.end(); ++i)
             (*i)->registerObserver(this);
     }
 
     inline Observer& Observer::operator=(const Observer& o) {
-        iterator i;
-        for (i=observables_.begin(); i!=observables_.end(); ++i)
-            (*i)->unregisterObserver(this);
-        observables_ = o.observables_;
-        for (i=observables_.begin(); i!=observables_.end(); ++i)
-            (*i)->registerObserver(this);
+        if (&o == this)
+            return *this;
+        unregisterWithAll();
+        std::vector<boost::shared_ptr<Observable> > observables = o.observables();
+        for (std::vector<boost::shared_ptr<Observable> >::const_iterator i =
+                 observables.begin(); i != observables.end(); ++i)
+            registerWith(*i);
         return *this;
     }
 
@@ -161,10 +207,17 @@ namespace ObjectHandler {
             (*i)->unregisterObserver(this);
     }
 
+    inline std::vector<boost::shared_ptr<Observable> > Observer::observables() const {
+        OH_OBSERVER_LOCK
+        return std::vector<boost::shared_ptr<Observable> >(observables_.begin(),
+                                                           observables_.end());
+    }
+
     inline std::pair<std::set<boost::shared_ptr<Observable> >::iterator, bool>
     Observer::registerWith(const boost::shared_ptr<Observable>& h) {
         if (h) {
             h->registerObserver(this);
+            OH_OBSERVER_LOCK
             return observables_.insert(h);
         }
         return std::make_pair(observables_.end(), false);
@@ -174,13 +227,18 @@ namespace ObjectHandler {
     size_t Observer::unregisterWith(const boost::shared_ptr<Observable>& h) {
         if (h)
             h->unregisterObserver(this);
+        OH_OBSERVER_LOCK
         return observables_.erase(h);
     }
 
     inline void Observer::unregisterWithAll() {
-        for (iterator i=observables_.begin(); i!=observables_.end(); ++i)
+        std::set<boost::shared_ptr<Observable> > observables;
+        {
+            OH_OBSERVER_LOCK
+            observables.swap(observables_);
+        }
+        for (iterator i=observables.begin(); i!=observables.end(); ++i)
             (*i)->unregisterObserver(this);
-        observables_.clear();
     }
 
 }
@@ -44,6 +44,24 @@
 //! Version string for output lib name.
 #define OBJHANDLER_LIB_VERSION "1_10_0"
 
+/* Uncomment the line below to allow objects to be retrieved from the
+   Repository concurrently from multiple threads.  This requires linking
+   against boost_thread.  On Unix the value is set instead by
+   ./configure --enable-thread-safe-repository.
+*/
+#ifndef OH_ENABLE_THREAD_SAFE_REPOSITORY
+//#define OH_ENABLE_THREAD_SAFE_REPOSITORY
+#endif
+
+/* Uncomment the line below to count the calls to each addin function and
+   time the stages of each call, see ohFunctionStats.  This requires
+   linking against boost_chrono.  On Unix the value is set instead by
+   ./configure --enable-function-statistics.
+*/
+#ifndef OH_ENABLE_FUNCTION_STATISTICS
+//#define OH_ENABLE_FUNCTION_STATISTICS
+#endif
+
 #include <cctype>
 #if defined(BOOST_NO_STDC_NAMESPACE)
     namespace std { using ::tolower; using ::toupper; }
@@ -0,0 +1,100 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <oh/config.hpp>
+#endif
+
+#include <oh/parallelloop.hpp>
+
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+
+#include <boost/thread/once.hpp>
+
+namespace ObjectHandler {
+
+    namespace {
+
+        WorkerPool *pool = 0;
+        boost::once_flag poolOnce = BOOST_ONCE_INIT;
+
+    }
+
+    // The pool is allocated once and never deleted, so that its threads
+    // are not joined during static destruction or while a DLL unloads.
+    WorkerPool &WorkerPool::instance() {
+        struct Create {
+            static void apply() { pool = new WorkerPool; }
+        };
+        boost::call_once(&Create::apply, poolOnce);
+        return *pool;
+    }
+
+    WorkerPool::WorkerPool() : size_(0), wanted_(0), busy_(0) {
+        std::size_t threads = boost::thread::hardware_concurrency();
+        try {
+            for (std::size_t n = 1; n < threads; ++n) {
+                threads_.create_thread(boost::bind(&WorkerPool::work, this));
+                ++size_;
+            }
+        } catch (const boost::thread_resource_error &) {
+            // Carry on with however many threads could be started.
+        }
+    }
+
+    void WorkerPool::run(const boost::function<void()> &task, std::size_t workers) {
+
+        boost::mutex::scoped_try_lock job(jobMutex_);
+        if (!job || workers == 0 || size_ == 0) {
+            task();
+            return;
+        }
+        {
+            boost::lock_guard<boost::mutex> lock(mutex_);
+            task_ = task;
+            wanted_ = std::min(workers, size_);
+        }
+        wake_.notify_all();
+        task();
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        wanted_ = 0;
+        while (busy_ != 0)
+            done_.wait(lock);
+        task_.clear();
+    }
+
+    void WorkerPool::work() {
+        for (;;) {
+            boost::function<void()> task;
+            {
+                boost::unique_lock<boost::mutex> lock(mutex_);
+                while (wanted_ == 0)
+                    wake_.wait(lock);
+                --wanted_;
+                ++busy_;
+                task = task_;
+            }
+            task();
+            boost::lock_guard<boost::mutex> lock(mutex_);
+            if (--busy_ == 0)
+                done_.notify_all();
+        }
+    }
+
+}
+
+#endif
@@ -0,0 +1,288 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Support for looping functions which process their input in parallel
+*/
+
+#ifndef oh_parallelloop_hpp
+#define oh_parallelloop_hpp
+
+#include <oh/exception.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/condition_variable.hpp>
+#endif
+
+namespace ObjectHandler {
+
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    //! Worker threads shared by all calls to parallelFor().
+    /*! The threads are started on first use, one fewer than the number of
+        hardware threads since the calling thread also takes part, and wait
+        on a condition variable between jobs.  The pool runs one job at a
+        time: a job submitted while another is running, e.g. by a function
+        called from within parallelFor(), runs on the calling thread alone.
+
+        The pool is never destroyed, its threads end with the process.
+    */
+    class DLL_API WorkerPool {
+    public:
+        static WorkerPool &instance();
+        //! Count of worker threads, excluding the calling thread.
+        std::size_t size() const { return size_; }
+        //! Run task on the calling thread and on up to the given count of workers.
+        /*! Returns once the task has returned on every thread which started
+            it.  Workers which have not yet started the task when it returns
+            on the calling thread do not start it, so the task should return
+            only when there is no work left.  The task must not throw.
+        */
+        void run(const boost::function<void()> &task, std::size_t workers);
+    private:
+        WorkerPool();
+        void work();
+        boost::mutex jobMutex_;
+        boost::mutex mutex_;
+        boost::condition_variable wake_;
+        boost::condition_variable done_;
+        boost::thread_group threads_;
+        std::size_t size_;
+        boost::function<void()> task_;
+        std::size_t wanted_;
+        std::size_t busy_;
+    };
+#endif
+
+    //! Hands out consecutive chunks of a range of indexes to any number of threads.
+    template <class ChunkFunction>
+    class ChunkQueue {
+    public:
+        ChunkQueue(std::size_t begin, std::size_t end, std::size_t chunkSize,
+                   ChunkFunction &chunkFunction)
+        : next_(begin), end_(end), chunkSize_(chunkSize),
+          chunkFunction_(chunkFunction), failed_(false) {}
+        //! Process chunks until none remain.
+        void run() {
+            for (;;) {
+                std::size_t begin, end;
+                {
+                    Lock lock(mutex_);
+                    if (next_ == end_ || failed_)
+                        return;
+                    begin = next_;
+                    end = std::min(end_, begin + chunkSize_);
+                    next_ = end;
+                }
+                try {
+                    chunkFunction_(begin, end);
+                } catch (const std::exception &e) {
+                    Lock lock(mutex_);
+                    if (!failed_)
+                        error_ = e.what();
+                    failed_ = true;
+                } catch (...) {
+                    Lock lock(mutex_);
+                    if (!failed_)
+                        error_ = "unknown error";
+                    failed_ = true;
+                }
+            }
+        }
+        bool failed() const { return failed_; }
+        const std::string &error() const { return error_; }
+    private:
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        typedef boost::mutex Mutex;
+        typedef boost::lock_guard<Mutex> Lock;
+#else
+        struct Mutex {};
+        struct Lock { explicit Lock(Mutex &) {} };
+#endif
+        Mutex mutex_;
+        std::size_t next_;
+        std::size_t end_;
+        std::size_t chunkSize_;
+        ChunkFunction &chunkFunction_;
+        bool failed_;
+        std::string error_;
+    };
+
+    //! Invoke chunkFunction(b, e) on consecutive chunks [b, e) which cover [begin, end).
+    /*! If OH_ENABLE_THREAD_SAFE_REPOSITORY is defined then the chunks are
+        processed by the WorkerPool together with the calling thread, each
+        taking the next chunk until none remain.  Otherwise the chunks are
+        processed in order on the calling thread.  The range is divided into
+        several chunks per thread, so that threads which finish early can
+        take work from the others.
+
+        No chunk is smaller than grainSize, except perhaps the last, so a
+        range shorter than twice grainSize is processed on the calling
+        thread alone.  Callers whose elements are cheap should pass a grain
+        large enough to cover the cost of waking the pool.
+
+        chunkFunction should record errors against the elements concerned
+        rather than throw.  If it does throw then no further chunks are
+        started, and the first error is rethrown once all threads are idle.
+    */
+    template <class ChunkFunction>
+    void parallelFor(std::size_t begin, std::size_t end, ChunkFunction &chunkFunction,
+                     std::size_t grainSize = 1) {
+
+        if (begin >= end)
+            return;
+        std::size_t size = end - begin;
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        grainSize = std::max<std::size_t>(1, grainSize);
+        if (size < 2 * grainSize) {
+            ChunkQueue<ChunkFunction> queue(begin, end, size, chunkFunction);
+            queue.run();
+            OH_REQUIRE(!queue.failed(), queue.error());
+            return;
+        }
+        WorkerPool &pool = WorkerPool::instance();
+        std::size_t threads = pool.size() + 1;
+        std::size_t chunkSize = std::max(grainSize, size / (4 * threads));
+        std::size_t chunks = (size + chunkSize - 1) / chunkSize;
+        ChunkQueue<ChunkFunction> queue(begin, end, chunkSize, chunkFunction);
+        pool.run(boost::bind(&ChunkQueue<ChunkFunction>::run, &queue),
+                 std::min(threads, chunks) - 1);
+#else
+        (void)grainSize;
+        ChunkQueue<ChunkFunction> queue(begin, end, size, chunkFunction);
+        queue.run();
+#endif
+        OH_REQUIRE(!queue.failed(), queue.error());
+    }
+
+    //! The result of one iteration of a looping function.
+    template <class OutputType>
+    struct LoopResult {
+        LoopResult() : value(), failed(false) {}
+        OutputType value;
+        bool failed;
+        std::string error;
+    };
+
+    //! Specialization for looping functions which return void.
+    /*! The value of each successful iteration is true.
+    */
+    template <>
+    struct LoopResult<void> {
+        LoopResult() : value(true), failed(false) {}
+        bool value;
+        bool failed;
+        std::string error;
+    };
+
+    //! Invoke the loop function and save its return value.
+    template <class LoopFunction, class InputType, class OutputType>
+    struct LoopInvoke {
+        static void apply(LoopFunction &loopFunction,
+                          const InputType &inputItem,
+                          LoopResult<OutputType> &result) {
+            result.value = loopFunction(inputItem);
+        }
+    };
+
+    //! Partial specialization for LoopInvoke where return type is void
+    template <class LoopFunction, class InputType>
+    struct LoopInvoke<LoopFunction, InputType, void> {
+        static void apply(LoopFunction &loopFunction,
+                          const InputType &inputItem,
+                          LoopResult<void> &) {
+            loopFunction(inputItem);
+        }
+    };
+
+    //! Invoke the loop function on a chunk of the input, recording errors by element.
+    template <class LoopFunction, class InputType, class OutputType>
+    class LoopChunk {
+    public:
+        LoopChunk(LoopFunction &loopFunction,
+                  const std::vector<InputType> &inputs,
+                  std::vector<LoopResult<OutputType> > &results)
+        : loopFunction_(loopFunction), inputs_(inputs), results_(results) {}
+        void operator()(std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                LoopResult<OutputType> &result = results_[i];
+                if (result.failed)
+                    continue;
+                try {
+                    LoopInvoke<LoopFunction, InputType, OutputType>::apply(
+                        loopFunction_, inputs_[i], result);
+                } catch (const std::exception &e) {
+                    result.failed = true;
+                    result.error = e.what();
+                }
+            }
+        }
+    private:
+        LoopFunction &loopFunction_;
+        const std::vector<InputType> &inputs_;
+        std::vector<LoopResult<OutputType> > &results_;
+    };
+
+    //! The fewest iterations of a looping function handed to a thread at a time.
+    const std::size_t loopGrainSize = 4;
+
+    //! Invoke the loop function once for each input, in parallel where possible.
+    /*! results must be the same size as inputs.  Elements of results which
+        are already marked as failed, e.g. because the input value could not
+        be converted, are skipped.  The outcome of each iteration is saved in
+        the corresponding element of results, so that the caller can process
+        the values and the errors in their original order, regardless of the
+        order in which the iterations were executed.
+
+        The first iteration is executed on the calling thread before the
+        remainder are distributed over the pool, so that any lazy
+        initialization of the underlying object (e.g. the bootstrap of a
+        yield curve) happens once, before it can be raced by the pool.
+
+        Iterations are distributed loopGrainSize at a time, so that short
+        loops run on the calling thread alone.  The loop function must be
+        safe to call concurrently, see parallelFor().
+    */
+    template <class LoopFunction, class InputType, class OutputType>
+    void evaluateLoop(LoopFunction &loopFunction,
+                      const std::vector<InputType> &inputs,
+                      std::vector<LoopResult<OutputType> > &results) {
+        OH_REQUIRE(results.size() == inputs.size(),
+                   "evaluateLoop - " << inputs.size() << " inputs but "
+                   << results.size() << " results");
+        LoopChunk<LoopFunction, InputType, OutputType> chunk(loopFunction, inputs, results);
+        std::size_t first = 0;
+        for (; first < results.size(); ++first) {
+            if (!results[first].failed) {
+                chunk(first, first + 1);
+                break;
+            }
+        }
+        if (first < results.size())
+            parallelFor(first + 1, results.size(), chunk, loopGrainSize);
+    }
+
+}
+
+#endif
+
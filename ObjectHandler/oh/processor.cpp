@@ -48,6 +48,11 @@ namespace ObjectHandler {
         return processorMap_[valueObject->processorName()];
     }
 
+    ProcessorPtr ProcessorFactory::getProcessor(const std::string &processorName) const {
+        std::map<std::string, ProcessorPtr>::const_iterator i = processorMap_.find(processorName);
+        return i == processorMap_.end() ? ProcessorPtr() : i->second;
+    }
+
     void ProcessorFactory::postProcess() {
         std::map<std::string, ProcessorPtr>::iterator it = processorMap_.begin();
         for(; it != processorMap_.end(); ++it)
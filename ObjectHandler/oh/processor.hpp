@@ -72,6 +72,22 @@ namespace ObjectHandler {
         virtual std::string process(const SerializationFactory&,
             const boost::shared_ptr<ValueObject> &valueObject,
             bool overwriteExisting) const = 0;
+        //! As process(), but creation of the Object may be deferred until it is first retrieved.
+        /*! The default implementation calls process().  Processors which
+            simply create the Object from its ValueObject may override this
+            function to call SerializationFactory::deferObject() instead.
+        */
+        virtual std::string processDeferred(const SerializationFactory& factory,
+            const boost::shared_ptr<ValueObject> &valueObject,
+            bool overwriteExisting) const {
+                return process(factory, valueObject, overwriteExisting);
+        }
+        //! Whether processDeferred() does nothing but defer creation of the Object.
+        /*! If so, the ValueObject need not be read until the Object is
+            created, see Repository::restore().  The default implementation
+            returns false.
+        */
+        virtual bool defersOnly() const { return false; }
         //! Perform post-serialization processing that may require other Objects.
         /*! This function is called after all Objects have been deserialized.
             Use this function when the post-processing of a given Object
@@ -97,6 +113,17 @@ namespace ObjectHandler {
                 return object.first;
         }
 
+        // Store the ValueObject, deferring creation of the Object.
+        virtual std::string processDeferred(const SerializationFactory& factory,
+            const boost::shared_ptr<ValueObject> &valueObject,
+            bool overwriteExisting) const {
+
+                return factory.deferObject(valueObject, overwriteExisting);
+        }
+
+        // processDeferred() does no more than defer creation.
+        virtual bool defersOnly() const { return true; }
+
         // Post processing - not implemented.
         virtual void postProcess() const {}
     };
@@ -115,6 +142,8 @@ namespace ObjectHandler {
         virtual bool storeProcessor(std::string name, ProcessorPtr& ptr);
 
 		ProcessorPtr getProcessor(const boost::shared_ptr<ValueObject> &valueObject);
+        //! The Processor with the given name, or a null pointer if there is none.
+        ProcessorPtr getProcessor(const std::string &processorName) const;
 
         /*static int categoryIndex(const boost::shared_ptr<ValueObject>& obj, bool forComparison = false) {
             int endIndex = forComparison? LAST_SORTABLE_CATEGORY_INDEX: nrCategories;
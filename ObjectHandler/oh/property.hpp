@@ -28,12 +28,14 @@
 
 #include <oh/ohdefines.hpp>
 #include <oh/exception.hpp>
+#include <oh/sharedvalue.hpp>
 #include <string>
 #include <vector>
 #include <boost/variant.hpp>
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/variant.hpp>
+#include <boost/serialization/vector.hpp>
 #include <oh/conversions/convert2.hpp>
 
 namespace ObjectHandler {
@@ -43,11 +45,84 @@ namespace ObjectHandler {
         //! Serialize this value to/from an archive
         template<class Archive>
         void serialize(Archive &ar, const unsigned int) {}
+        bool operator==(const empty_property_tag&) const { return true; }
     };
 
+    //! A matrix of doubles held in a single contiguous array
+    /*! Vectors and matrices of property_t hold one variant per element.  A
+        rectangular matrix of doubles is instead held in row-major order in
+        a single array, which is allocated once and which is serialized in
+        bulk.
+    */
+    class dense_matrix {
+        friend class boost::serialization::access;
+    public:
+        //! \name Structors
+        //@{
+        //! Empty default constructor
+        dense_matrix() : rows_(0), columns_(0) {}
+        //! Copy the given matrix, whose rows must all be the same length.
+        explicit dense_matrix(const std::vector<std::vector<double> >& mtx)
+        : rows_(mtx.size()), columns_(mtx.empty() ? 0 : mtx[0].size()) {
+            values_.reserve(rows_ * columns_);
+            for (std::vector<std::vector<double> >::const_iterator i = mtx.begin(); i != mtx.end(); ++i) {
+                OH_REQUIRE(i->size() == columns_, "dense_matrix: rows of unequal length");
+                values_.insert(values_.end(), i->begin(), i->end());
+            }
+        }
+        //@}
+
+        //! \name Inspectors
+        //@{
+        std::size_t rows() const { return rows_; }
+        std::size_t columns() const { return columns_; }
+        //! Pointer to the first element of the given row.
+        const double* row(std::size_t i) const { return values_.empty() ? 0 : &values_[i * columns_]; }
+        //! All of the elements, in row-major order.
+        const std::vector<double>& values() const { return values_; }
+        //@}
+
+        bool operator==(const dense_matrix& m) const {
+            return rows_ == m.rows_ && columns_ == m.columns_ && values_ == m.values_;
+        }
+        friend std::size_t hash_value(const dense_matrix& m) {
+            std::size_t seed = boost::hash_range(m.values_.begin(), m.values_.end());
+            boost::hash_combine(seed, m.rows_);
+            return seed;
+        }
+    private:
+        template<class Archive>
+        void serialize(Archive &ar, const unsigned int) {
+            ar  & boost::serialization::make_nvp("rows", rows_)
+                & boost::serialization::make_nvp("columns", columns_)
+                & boost::serialization::make_nvp("values", values_);
+        }
+
+        std::size_t rows_;
+        std::size_t columns_;
+        std::vector<double> values_;
+    };
+
+    class property_t;
+
     //! The underlying types supported by property_t
+    /*! New types must be appended so that the positions of the existing
+        types, which are recorded in serialized property_t values, do not
+        change.
+
+        Contiguous vectors and matrices of doubles are held as SharedValues,
+        so that copies of a property_t share a single array, and equal
+        arrays are stored once.  The shared vectors of property_t which
+        ValueObjects hold for vectors of dates, quotes and other mixed
+        values are stored as they are, so that retrieving such a property
+        does not copy the vector.  A SharedValue is serialized as the value
+        which it holds.
+    */
     typedef boost::make_recursive_variant<empty_property_tag, bool, int, std::string, long, double,
-            std::vector<boost::recursive_variant_> >::type property_base;
+            std::vector<boost::recursive_variant_>, SharedValue<std::vector<double> >,
+            SharedValue<dense_matrix>, SharedValue<std::vector<property_t> > >::type property_base;
+
+    class SharedMatrix;
 
     //! A value of variant type
     /*! Class property_t is a wrapper for boost::variant, which is natively
@@ -79,6 +154,38 @@ namespace ObjectHandler {
 
             property_base::operator= <vector>(row);
         }
+        //! Construct from std::vector<double>, stored contiguously
+        property_t(const std::vector<double>& vct)
+            : property_base(SharedValue<std::vector<double> >(vct)) {}
+        //! Construct from a shared std::vector<double>, without copying it
+        property_t(const SharedValue<std::vector<double> >& vct) : property_base(vct) {}
+        //! Construct from a shared std::vector<property_t>, without copying it
+        property_t(const SharedValue<std::vector<property_t> >& vct) : property_base(vct) {}
+        //! Construct from the value held by a SharedValue
+        template<typename T>
+        property_t(const SharedValue<T>& t) {
+            property_t value(t.get());
+            property_base::operator=(static_cast<const property_base&>(value));
+        }
+        //! Construct from a SharedMatrix, sharing the value which it holds
+        property_t(const SharedMatrix& mtx);
+        //! Construct from std::vector<std::vector<double> >
+        /*! A rectangular matrix is stored as a dense_matrix, otherwise each
+            row is stored contiguously.
+        */
+        property_t(const std::vector<std::vector<double> >& mtx) {
+            bool rectangular = true;
+            for (std::vector<std::vector<double> >::const_iterator i = mtx.begin(); i != mtx.end(); ++i)
+                rectangular = rectangular && i->size() == mtx[0].size();
+            if (rectangular) {
+                property_base::operator=(SharedValue<dense_matrix>(dense_matrix(mtx)));
+            } else {
+                vector matrix;
+                for (std::vector<std::vector<double> >::const_iterator i = mtx.begin(); i != mtx.end(); ++i)
+                    matrix.push_back(SharedValue<std::vector<double> >(*i));
+                property_base::operator= <vector>(matrix);
+            }
+        }
         //! Construct from std::vector<std::vector<T> >
         template<typename T>
         property_t(const std::vector<std::vector<T> >& mtx) {
@@ -100,6 +207,10 @@ namespace ObjectHandler {
             property_base::operator=(static_cast<const property_base&>(rhs));
             return *this;
         }
+        //! Equality of the underlying values
+        bool operator==(const property_t& rhs) const {
+            return static_cast<const property_base&>(*this) == static_cast<const property_base&>(rhs);
+        }
         //! Function call operator - return underlying data
         template<typename T>
         operator T() const { return boost::get<T>(*this); }
@@ -123,16 +234,133 @@ namespace ObjectHandler {
         //@}
     };
 
+    //! A matrix of doubles held as the property_t which represents it
+    /*! The type of the ValueObject members which hold matrices of doubles.
+        The matrix is held as a shared dense_matrix, or as a vector of
+        shared rows if it is not rectangular, so that a property_t
+        retrieved from the member shares the stored value rather than
+        interning a new copy.  A SharedMatrix is serialized as a
+        std::vector<std::vector<double> >.
+    */
+    class SharedMatrix {
+    public:
+        //! \name Structors
+        //@{
+        //! An empty matrix, which is not interned
+        SharedMatrix() {}
+        SharedMatrix(const std::vector<std::vector<double> >& mtx) : value_(mtx) {}
+        //@}
+
+        //! \name Modifiers
+        //@{
+        SharedMatrix& operator=(const std::vector<std::vector<double> >& mtx) {
+            value_ = property_t(mtx);
+            return *this;
+        }
+        //@}
+
+        //! \name Inspectors
+        //@{
+        //! A copy of the matrix.
+        std::vector<std::vector<double> > get() const;
+        //! The property_t which holds the matrix.
+        const property_t& property() const { return value_; }
+        //@}
+    private:
+        property_t value_;
+    };
+
+    inline property_t::property_t(const SharedMatrix& mtx)
+        : property_base(static_cast<const property_base&>(mtx.property())) {}
+
+    namespace detail {
+
+        //! Convert a range of doubles to type value_t, one element at a time.
+        template<class value_t>
+        void appendReals(const double* begin, const double* end, std::vector<value_t>& ret) {
+            ret.reserve(ret.size() + (end - begin));
+            for(; begin != end; ++begin)
+                ret.push_back(ObjectHandler::convert2<value_t, property_t>(*begin)); //implicit property_t constructor call!
+        }
+
+        //! Copy a range of doubles in bulk.
+        inline void appendReals(const double* begin, const double* end, std::vector<double>& ret) {
+            ret.insert(ret.end(), begin, end);
+        }
+
+        //! Convert a vector, held either contiguously or as a vector of property_t, to type value_t.
+        template<class value_t>
+        void appendVector(const property_base& c, std::vector<value_t>& ret) {
+            if (const SharedValue<std::vector<double> >* shared =
+                    boost::get<SharedValue<std::vector<double> > >(&c)) {
+                const std::vector<double>& vct = shared->get();
+                if (!vct.empty())
+                    appendReals(&vct[0], &vct[0] + vct.size(), ret);
+                return;
+            }
+            if (const SharedValue<std::vector<property_t> >* shared =
+                    boost::get<SharedValue<std::vector<property_t> > >(&c)) {
+                const std::vector<property_t>& vct = shared->get();
+                ret.reserve(ret.size() + vct.size());
+                for (std::vector<property_t>::const_iterator i = vct.begin(); i != vct.end(); ++i)
+                    ret.push_back(ObjectHandler::convert2<value_t, property_t>(*i));
+                return;
+            }
+            const property_t::vector& vct = boost::get<property_t::vector>(c);
+            ret.reserve(ret.size() + vct.size());
+            for(property_t::vector::const_iterator i = vct.begin(); i != vct.end(); ++i) {
+                ret.push_back(ObjectHandler::convert2<value_t, property_t>(*i)); //implicit property_t constructor call!
+            }
+        }
+
+    }
+
+    namespace detail {
+
+        //! Hash a value of any of the types supported by property_t.
+        inline std::size_t hashProperty(const property_base& p) {
+            std::size_t seed = 0;
+            boost::hash_combine(seed, p.which());
+            if (const bool* val = boost::get<bool>(&p))
+                boost::hash_combine(seed, *val);
+            else if (const int* val = boost::get<int>(&p))
+                boost::hash_combine(seed, *val);
+            else if (const std::string* val = boost::get<std::string>(&p))
+                boost::hash_combine(seed, *val);
+            else if (const long* val = boost::get<long>(&p))
+                boost::hash_combine(seed, *val);
+            else if (const double* val = boost::get<double>(&p))
+                boost::hash_combine(seed, *val);
+            else if (const property_t::vector* val = boost::get<property_t::vector>(&p))
+                for (property_t::vector::const_iterator i = val->begin(); i != val->end(); ++i)
+                    boost::hash_combine(seed, hashProperty(*i));
+            else if (const SharedValue<std::vector<double> >* val =
+                    boost::get<SharedValue<std::vector<double> > >(&p))
+                boost::hash_combine(seed, val->get());
+            else if (const SharedValue<dense_matrix>* val =
+                    boost::get<SharedValue<dense_matrix> >(&p))
+                boost::hash_combine(seed, val->get());
+            else if (const SharedValue<std::vector<property_t> >* val =
+                    boost::get<SharedValue<std::vector<property_t> > >(&p))
+                for (std::vector<property_t>::const_iterator i = val->get().begin(); i != val->get().end(); ++i)
+                    boost::hash_combine(seed, hashProperty(*i));
+            return seed;
+        }
+
+    }
+
+    //! Hash a property_t by its content, so that it can be held by a SharedValue.
+    inline std::size_t hash_value(const property_t& p) {
+        return detail::hashProperty(p);
+    }
+
     //! Template function to convert a vector from type property_t to type value_t
     namespace vector {
         template<class value_t>
         std::vector<value_t> convert2(const property_t& c, const std::string &parameterName) {
             try {
-                const property_t::vector& vct = boost::get<property_t::vector>(c);
                 std::vector<value_t> ret;
-                for(property_t::vector::const_iterator i = vct.begin(); i != vct.end(); ++i) {
-                    ret.push_back(ObjectHandler::convert2<value_t, property_t>(*i)); //implicit property_t constructor call!
-                }
+                detail::appendVector(c, ret);
                 return ret;
             } catch(const std::exception &e) {
                 OH_FAIL("vector property: unable to convert parameter '" << parameterName 
@@ -146,16 +374,26 @@ namespace ObjectHandler {
         template<class value_t>
         std::vector<std::vector<value_t> > convert2(const property_t& c, const std::string &parameterName) {
             try {
-                const property_t::vector& matrix = boost::get<property_t::vector>(c);
                 std::vector<std::vector<value_t> > ret;
-                for(property_t::vector::const_iterator i = matrix.begin(); i != matrix.end(); ++i) {
-                    std::vector<value_t> rowOut;
-                    const property_t::vector& rowIn = boost::get<property_t::vector>(*i);
-                    for(property_t::vector::const_iterator j = rowIn.begin(); j != rowIn.end(); ++j) {
-                        rowOut.push_back(ObjectHandler::convert2<value_t, property_t>(*j)); //implicit property_t constructor call!
-                    }
-                    ret.push_back(rowOut);                
+                if (const SharedValue<dense_matrix>* shared = boost::get<SharedValue<dense_matrix> >(&c)) {
+                    const dense_matrix& mtx = shared->get();
+                    ret.resize(mtx.rows());
+                    for (std::size_t i = 0; i < mtx.rows(); ++i)
+                        detail::appendReals(mtx.row(i), mtx.row(i) + mtx.columns(), ret[i]);
+                    return ret;
                 }
+                if (const SharedValue<std::vector<property_t> >* shared =
+                        boost::get<SharedValue<std::vector<property_t> > >(&c)) {
+                    const std::vector<property_t>& matrix = shared->get();
+                    ret.resize(matrix.size());
+                    for (std::size_t i = 0; i < matrix.size(); ++i)
+                        detail::appendVector(matrix[i], ret[i]);
+                    return ret;
+                }
+                const property_t::vector& matrix = boost::get<property_t::vector>(c);
+                ret.resize(matrix.size());
+                for(std::size_t i = 0; i < matrix.size(); ++i)
+                    detail::appendVector(matrix[i], ret[i]);
                 return ret;
             } catch(const std::exception &e) {
                 OH_FAIL("property matrix: unable to convert parameter '" << parameterName 
@@ -164,6 +402,22 @@ namespace ObjectHandler {
         }
     }
 
+    inline std::vector<std::vector<double> > SharedMatrix::get() const {
+        if (value_.missing())
+            return std::vector<std::vector<double> >();
+        return matrix::convert2<double>(value_, "SharedMatrix");
+    }
+
+    namespace detail {
+
+        //! Log a row of doubles to the given stream.
+        inline void logReals(std::ostream &out, const double* begin, const double* end) {
+            for (const double* i = begin; i != end; ++i)
+                out << (i == begin ? "" : ", ") << *i;
+        }
+
+    }
+
     //! Log the given property_t value to the given stream.
     inline std::ostream &operator<<(std::ostream &out, const property_t &p) {
 
@@ -179,6 +433,23 @@ namespace ObjectHandler {
             out << *val;
         else if (const bool* val = boost::get<bool>(&p))
             out << *val;
+        else if (const SharedValue<std::vector<double> >* val =
+                boost::get<SharedValue<std::vector<double> > >(&p)) {
+            const std::vector<double>& vct = val->get();
+            out << "[";
+            if (!vct.empty())
+                detail::logReals(out, &vct[0], &vct[0] + vct.size());
+            out << "]";
+        } else if (const SharedValue<dense_matrix>* val =
+                boost::get<SharedValue<dense_matrix> >(&p)) {
+            const dense_matrix& mtx = val->get();
+            out << "[";
+            for (std::size_t i = 0; i < mtx.rows(); ++i) {
+                out << (i == 0 ? "" : "; ");
+                detail::logReals(out, mtx.row(i), mtx.row(i) + mtx.columns());
+            }
+            out << "]";
+        }
         //else if (const empty_property_tag* val = boost::get<empty_property_tag>(&p))
         //    out << "[Null value]";
         //else if (const std::vector<boost::recursive_variant_>* val =
@@ -191,5 +462,42 @@ namespace ObjectHandler {
 
 }
 
+namespace boost { namespace serialization {
+
+    // Serialize a SharedMatrix as the std::vector<std::vector<double> >
+    // which ValueObjects held before, see SharedValue.
+
+    template <>
+    struct implementation_level<ObjectHandler::SharedMatrix>
+        : public implementation_level<std::vector<std::vector<double> > > {};
+
+    template <>
+    struct tracking_level<ObjectHandler::SharedMatrix>
+        : public tracking_level<std::vector<std::vector<double> > > {};
+
+    template <>
+    struct version<ObjectHandler::SharedMatrix>
+        : public version<std::vector<std::vector<double> > > {};
+
+    template <class Archive>
+    void save(Archive &ar, const ObjectHandler::SharedMatrix &s, const unsigned int v) {
+        std::vector<std::vector<double> > mtx = s.get();
+        serialize_adl(ar, mtx, v);
+    }
+
+    template <class Archive>
+    void load(Archive &ar, ObjectHandler::SharedMatrix &s, const unsigned int v) {
+        std::vector<std::vector<double> > mtx;
+        serialize_adl(ar, mtx, v);
+        s = mtx;
+    }
+
+    template <class Archive>
+    void serialize(Archive &ar, ObjectHandler::SharedMatrix &s, const unsigned int v) {
+        split_free(ar, s, v);
+    }
+
+} }
+
 #endif
 
@@ -24,12 +24,31 @@
 #endif
 
 #include <oh/repository.hpp>
+#include <oh/objectstore.hpp>
+#include <oh/snapshot.hpp>
+#include <oh/processor.hpp>
 #include <oh/serializationfactory.hpp>
 #include <oh/exception.hpp>
 #include <oh/group.hpp>
 #include <boost/regex.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/bind.hpp>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#define OH_REPOSITORY_WRITE_LOCK \
+    boost::recursive_mutex::scoped_lock writerLock(writerMutex_);
+#define OH_HANDLE_LOCK \
+    boost::mutex::scoped_lock handleLock(handleMutex_);
+#else
+#define OH_REPOSITORY_WRITE_LOCK
+#define OH_HANDLE_LOCK
+#endif
 #include <ostream>
 #include <sstream>
+#include <algorithm>
 
 using boost::shared_ptr;
 using std::set;
@@ -40,9 +59,151 @@ namespace ObjectHandler {
 
     Repository *Repository::instance_;
 
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    boost::atomic<std::size_t> ObjectWrapper::epochCounter_(0);
+#else
+    std::size_t ObjectWrapper::epochCounter_ = 0;
+#endif
+
     // std::map cannot be exported across DLL boundaries
     // so instead we use a static variable.
-    Repository::ObjectMap objectMap_;
+    ObjectStore objectStore_;
+
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    // Serializes structural changes to the Repository (store/delete), which
+    // update the observer graph.  Retrieval does not take this lock.
+    boost::recursive_mutex writerMutex_;
+#endif
+
+    namespace {
+
+        // An interned object ID together with the state cached against it.
+        struct HandleEntry {
+            HandleEntry(const string &id)
+            : objectID(id), generation(0), source(0), type(0) {}
+            string objectID;
+            // The ObjectWrapper found for objectID, valid as long as
+            // the ObjectStore generation is unchanged.
+            boost::weak_ptr<ObjectWrapper> objectWrapper;
+            std::size_t generation;
+            // The Object most recently downcast via this handle, and the
+            // result of the downcast.
+            const Object *source;
+            const std::type_info *type;
+            boost::weak_ptr<void> typed;
+        };
+
+        // Orders the recreation of a set of Dirty ObjectWrappers, so that each
+        // is recreated only after all of its Dirty precedents.  Any number of
+        // threads may call run() concurrently, each takes whichever
+        // ObjectWrapper is ready next.
+        class RecreateSchedule {
+        public:
+            RecreateSchedule() : running_(0), recreated_(0) {}
+            // Add the ObjectWrapper with the given ID and return its index.
+            std::size_t add(const string &objectID,
+                            const shared_ptr<ObjectWrapper> &objWrapper) {
+                nodes_.push_back(Node(objectID, objWrapper));
+                return nodes_.size() - 1;
+            }
+            // The dependant may not be recreated before the precedent.
+            void addDependency(std::size_t precedent, std::size_t dependant) {
+                nodes_[precedent].dependants.push_back(dependant);
+                ++nodes_[dependant].pending;
+            }
+            void start() {
+                for (std::size_t i = 0; i < nodes_.size(); ++i)
+                    if (nodes_[i].pending == 0)
+                        ready_.push_back(i);
+            }
+            void run();
+            long recreated() const { return recreated_; }
+            const std::vector<string> &errors() const { return errors_; }
+        private:
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+            typedef boost::mutex Mutex;
+            typedef boost::unique_lock<Mutex> Lock;
+            typedef boost::condition_variable Condition;
+#else
+            struct Mutex {};
+            struct Lock {
+                explicit Lock(Mutex &) {}
+                void lock() {}
+                void unlock() {}
+            };
+            struct Condition {
+                void wait(Lock &) {}
+                void notify_all() {}
+            };
+#endif
+            struct Node {
+                Node(const string &id, const shared_ptr<ObjectWrapper> &ow)
+                : objectID(id), objWrapper(ow), pending(0) {}
+                string objectID;
+                shared_ptr<ObjectWrapper> objWrapper;
+                std::vector<std::size_t> dependants;
+                // Count of precedents not yet recreated.
+                std::size_t pending;
+            };
+            std::vector<Node> nodes_;
+            std::vector<std::size_t> ready_;
+            std::size_t running_;
+            long recreated_;
+            std::vector<string> errors_;
+            Mutex mutex_;
+            Condition condition_;
+        };
+
+        void RecreateSchedule::run() {
+            Lock lock(mutex_);
+            for (;;) {
+                while (ready_.empty() && running_ > 0)
+                    condition_.wait(lock);
+                // If nothing is ready and nothing is running then the
+                // remaining Objects depend on one which could not be
+                // recreated, and are left Dirty.
+                if (ready_.empty())
+                    break;
+                Node &node = nodes_[ready_.back()];
+                ready_.pop_back();
+                ++running_;
+                lock.unlock();
+
+                string error;
+                try {
+                    node.objWrapper->recreate();
+                } catch (const std::exception &e) {
+                    error = e.what();
+                    if (error.empty())
+                        error = "unknown error";
+                } catch (...) {
+                    error = "unknown error";
+                }
+
+                lock.lock();
+                --running_;
+                if (error.empty()) {
+                    ++recreated_;
+                    std::vector<std::size_t>::const_iterator i;
+                    for (i = node.dependants.begin(); i != node.dependants.end(); ++i)
+                        if (--nodes_[*i].pending == 0)
+                            ready_.push_back(*i);
+                } else {
+                    errors_.push_back(node.objectID + ": " + error);
+                }
+                condition_.notify_all();
+            }
+        }
+
+    }
+
+    // Interned object IDs, indexed by ObjectHandle.
+    std::vector<HandleEntry> handleEntries_;
+    std::map<string, ObjectHandle, my_iless> handleMap_;
+
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    boost::mutex handleMutex_;
+#endif
 
     Repository::Repository() {
         instance_ = this;
@@ -52,6 +213,12 @@ namespace ObjectHandler {
         instance_ = 0;
     }
 
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    boost::recursive_mutex &Repository::writerMutex() {
+        return writerMutex_;
+    }
+#endif
+
     Repository &Repository::instance() {
         OH_REQUIRE(instance_,
                    "Attempt to reference uninitialized Repository object");
@@ -63,23 +230,69 @@ namespace ObjectHandler {
                                    const shared_ptr<Object> &object,
                                    bool overwrite,
                                    boost::shared_ptr<ValueObject>) {
-        OH_REQUIRE(overwrite || !objectExists(objectID),
+        OH_REPOSITORY_WRITE_LOCK
+        shared_ptr<ObjectWrapper> objWrapper = objectStore_.find(objectID);
+        OH_REQUIRE(overwrite || !objWrapper,
                    "Cannot store object with ID '" << objectID <<
                    "' because an object with that ID already exists");
 
-        if(objectExists(objectID)){
-            ObjectMap::const_iterator result = objectMap_.find(objectID);
-            //result->second->notifyObservers();
-            result->second->reset(object);
-        } else{
-            shared_ptr<ObjectWrapper> objWrapper(new ObjectWrapper(object));
-            objectMap_[objectID] = objWrapper;
+        if (objWrapper) {
+            objWrapper->reset(object);
+        } else {
+            objWrapper = shared_ptr<ObjectWrapper>(new ObjectWrapper(object));
+            objectStore_.insert(objectID, objWrapper);
         }
 
-        registerObserver(objectMap_[objectID]);
+        registerObserver(objWrapper);
         return objectID;
     }
 
+    string Repository::deferObject(const string &objectID,
+                                   const shared_ptr<ValueObject> &valueObject,
+                                   bool overwrite) {
+        OH_REPOSITORY_WRITE_LOCK
+        shared_ptr<ObjectWrapper> objWrapper = objectStore_.find(objectID);
+        OH_REQUIRE(overwrite || !objWrapper,
+                   "Cannot store object with ID '" << objectID <<
+                   "' because an object with that ID already exists");
+
+        if (objWrapper) {
+            objWrapper->defer(valueObject);
+        } else {
+            objWrapper = shared_ptr<ObjectWrapper>(new ObjectWrapper(valueObject));
+            objectStore_.insert(objectID, objWrapper);
+        }
+        return objectID;
+    }
+
+    string Repository::deferObject(const string &objectID,
+                                   const ValueObjectLoader &loader,
+                                   bool permanent,
+                                   bool overwrite) {
+        OH_REPOSITORY_WRITE_LOCK
+        shared_ptr<ObjectWrapper> objWrapper = objectStore_.find(objectID);
+        OH_REQUIRE(overwrite || !objWrapper,
+                   "Cannot store object with ID '" << objectID <<
+                   "' because an object with that ID already exists");
+
+        if (objWrapper) {
+            objWrapper->defer(loader, permanent);
+        } else {
+            objWrapper = shared_ptr<ObjectWrapper>(new ObjectWrapper(loader, permanent));
+            objectStore_.insert(objectID, objWrapper);
+        }
+        return objectID;
+    }
+
+    void Repository::createObject(const shared_ptr<ObjectWrapper> &objWrapper) {
+        // The creator function retrieves the precedents, creating any of
+        // them which were themselves deferred.
+        if (!objWrapper->created() && objWrapper->create()) {
+            OH_REPOSITORY_WRITE_LOCK
+            registerObserver(objWrapper);
+        }
+    }
+
     void Repository::retrieveObject(shared_ptr<Object> &ret,
                                     const string &id) {
         ret = retrieveObjectImpl(id);
@@ -87,25 +300,133 @@ namespace ObjectHandler {
 
     shared_ptr<Object> Repository::retrieveObjectImpl(const string &objectID) {
 
-        ObjectMap::const_iterator result = objectMap_.find(formatID(objectID));
-        OH_REQUIRE(result != objectMap_.end(),
+        shared_ptr<ObjectWrapper> objWrapper = objectStore_.find(formatID(objectID));
+        OH_REQUIRE(objWrapper,
                    "ObjectHandler error: attempt to retrieve object "
                    "with unknown ID '" << objectID << "'");
-        if(result->second->dirty()) {
-            result->second->recreate();
+        createObject(objWrapper);
+        if(objWrapper->dirty()) {
+            objWrapper->recreate();
+        }
+        return objWrapper->object();
+    }
+
+    std::vector<shared_ptr<ObjectWrapper> >
+    Repository::retrieveObjectWrappers(const std::vector<string> &objectIDs) {
+
+        std::vector<string> realIDs;
+        realIDs.reserve(objectIDs.size());
+        std::vector<string>::const_iterator i;
+        for (i = objectIDs.begin(); i != objectIDs.end(); ++i)
+            realIDs.push_back(i->empty() ? *i : formatID(*i));
+
+        std::vector<shared_ptr<ObjectWrapper> > ret = objectStore_.find(realIDs);
+        for (std::size_t n = 0; n < ret.size(); ++n) {
+            if (objectIDs[n].empty())
+                continue;
+            OH_REQUIRE(ret[n],
+                       "ObjectHandler error: attempt to retrieve object "
+                       "with unknown ID '" << objectIDs[n] << "'");
+            createObject(ret[n]);
+            if(ret[n]->dirty()) {
+                ret[n]->recreate();
+            }
+        }
+        return ret;
+    }
+
+    void Repository::retrieveObject(shared_ptr<Object> &ret,
+                                    ObjectHandle handle) {
+        ret = retrieveObjectImpl(handle);
+    }
+
+    shared_ptr<Object> Repository::retrieveObjectImpl(ObjectHandle handle) {
+
+        shared_ptr<ObjectWrapper> objWrapper;
+        {
+            OH_HANDLE_LOCK
+            OH_REQUIRE(handle < handleEntries_.size(),
+                       "ObjectHandler error: invalid object handle " << handle);
+            HandleEntry &entry = handleEntries_[handle];
+            std::size_t generation = objectStore_.generation();
+            if (entry.generation == generation)
+                objWrapper = entry.objectWrapper.lock();
+            if (!objWrapper) {
+                objWrapper = objectStore_.find(entry.objectID);
+                entry.objectWrapper = objWrapper;
+                entry.generation = generation;
+            }
+            OH_REQUIRE(objWrapper,
+                       "ObjectHandler error: attempt to retrieve object "
+                       "with unknown ID '" << entry.objectID << "'");
         }
-        return result->second->object();
+        createObject(objWrapper);
+        if(objWrapper->dirty()) {
+            objWrapper->recreate();
+        }
+        return objWrapper->object();
+    }
+
+    ObjectHandle Repository::handle(const string &objectID) {
+        string realID = formatID(objectID);
+        OH_HANDLE_LOCK
+        std::map<string, ObjectHandle, my_iless>::const_iterator i = handleMap_.find(realID);
+        if (i != handleMap_.end())
+            return i->second;
+        ObjectHandle ret = handleEntries_.size();
+        handleEntries_.push_back(HandleEntry(realID));
+        handleMap_[realID] = ret;
+        return ret;
+    }
+
+    std::vector<ObjectHandle> Repository::handle(const std::vector<string> &objectIDs) {
+        std::vector<ObjectHandle> ret;
+        ret.reserve(objectIDs.size());
+        std::vector<string>::const_iterator i;
+        for (i = objectIDs.begin(); i != objectIDs.end(); ++i)
+            ret.push_back(handle(*i));
+        return ret;
     }
 
-    const shared_ptr<ObjectWrapper>&
+    string Repository::handleID(ObjectHandle handle) const {
+        OH_HANDLE_LOCK
+        OH_REQUIRE(handle < handleEntries_.size(),
+                   "ObjectHandler error: invalid object handle " << handle);
+        return handleEntries_[handle].objectID;
+    }
+
+    shared_ptr<void> Repository::cachedObject(ObjectHandle handle,
+                                              const std::type_info &type,
+                                              const Object *object) const {
+        OH_HANDLE_LOCK
+        const HandleEntry &entry = handleEntries_[handle];
+        if (entry.source != object || !entry.type || *entry.type != type)
+            return shared_ptr<void>();
+        // While the cached pointer is alive the Object it points to cannot
+        // have been destroyed, so a matching address identifies the same Object.
+        return entry.typed.lock();
+    }
+
+    void Repository::cacheObject(ObjectHandle handle,
+                                 const std::type_info &type,
+                                 const Object *object,
+                                 const shared_ptr<void> &typed) {
+        OH_HANDLE_LOCK
+        HandleEntry &entry = handleEntries_[handle];
+        entry.source = object;
+        entry.type = &type;
+        entry.typed = typed;
+    }
+
+    shared_ptr<ObjectWrapper>
     Repository::getObjectWrapper(const string &objectID) const {
 
-        ObjectMap::const_iterator result = objectMap_.find(objectID);
-        OH_REQUIRE(result != objectMap_.end(),
+        shared_ptr<ObjectWrapper> objWrapper = objectStore_.find(objectID);
+        OH_REQUIRE(objWrapper,
                    "ObjectHandler error: attempt to retrieve object "
                    "with unknown ID '" << objectID << "'");
 
-        return result->second;
+        return objWrapper;
     }
 
     void Repository::registerObserver(shared_ptr<ObjectWrapper> objWrapper) {
@@ -124,10 +445,10 @@ namespace ObjectHandler {
 
     void Repository::deleteObject(const string &objectID) {
         string realID = formatID(objectID);
-        OH_REQUIRE(objectExists(realID),
+        OH_REPOSITORY_WRITE_LOCK
+        OH_REQUIRE(objectStore_.erase(realID),
                    "Cannot delete '" << realID << "' because no Object with "
                    "that ID is present in the Repository");
-        objectMap_.erase(realID);
     }
 
     void Repository::deleteObject(const std::vector<string> &objectIDs) {
@@ -140,57 +461,211 @@ namespace ObjectHandler {
 
     void Repository::deleteAllObjects(const bool &deletePermanent) {
 
+        OH_REPOSITORY_WRITE_LOCK
         if (deletePermanent) {
-            objectMap_.clear();
+            objectStore_.clear();
         } else {
-            ObjectMap::iterator i = objectMap_.begin();
-            while (i != objectMap_.end()) {
-                if (i->second->object()->permanent())
-                    ++i;
-                else
-                    objectMap_.erase(i++);                    
+            objectStore_.eraseTransient();
+        }
+    }
+
+    long Repository::recreateDirty(long threads) {
+
+        OH_REQUIRE(threads >= 0, "Invalid number of threads: " << threads);
+
+        RecreateSchedule schedule;
+        std::map<ObjectWrapper*, std::size_t> index;
+        std::vector<ObjectStore::Entry> entries = objectStore_.entries();
+        std::vector<ObjectStore::Entry>::const_iterator i;
+        for (i = entries.begin(); i != entries.end(); ++i)
+            if (i->second->dirty())
+                index[i->second.get()] = schedule.add(i->first, i->second);
+
+        // Only a Dirty precedent constrains the order of recreation.
+        for (i = entries.begin(); i != entries.end(); ++i) {
+            std::map<ObjectWrapper*, std::size_t>::const_iterator dependant =
+                index.find(i->second.get());
+            if (dependant == index.end())
+                continue;
+            const set<string>& relationObs =
+                i->second->object()->properties()->getPrecedentObjects();
+            set<string>::const_iterator iter;
+            for (iter = relationObs.begin(); iter != relationObs.end(); ++iter) {
+                shared_ptr<ObjectWrapper> precedent = objectStore_.find(formatID(*iter));
+                std::map<ObjectWrapper*, std::size_t>::const_iterator j =
+                    index.find(precedent.get());
+                if (j != index.end())
+                    schedule.addDependency(j->second, dependant->second);
             }
         }
+        schedule.start();
+
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        if (threads == 0)
+            threads = std::max(1U, boost::thread::hardware_concurrency());
+        threads = std::min(threads, static_cast<long>(index.size()));
+        boost::thread_group pool;
+        try {
+            for (long n = 1; n < threads; ++n)
+                pool.create_thread(boost::bind(&RecreateSchedule::run, &schedule));
+        } catch (const boost::thread_resource_error &) {
+            // Carry on with however many threads could be started.
+        }
+        schedule.run();
+        pool.join_all();
+#else
+        schedule.run();
+#endif
+
+        const std::vector<string> &errors = schedule.errors();
+        if (!errors.empty()) {
+            std::ostringstream msg;
+            std::vector<string>::const_iterator e;
+            for (e = errors.begin(); e != errors.end(); ++e)
+                msg << std::endl << *e;
+            OH_FAIL("Error in function Repository::recreateDirty() : "
+                    "unable to recreate " << errors.size() << " object(s):" << msg.str());
+        }
+        return schedule.recreated();
+    }
+
+    long Repository::snapshot(const string &path, bool overwrite) {
+
+        // Objects whose creation was deferred are written from the
+        // ValueObjects they were loaded with, without creating them.
+        std::vector<ObjectStore::Entry> entries = objectStore_.entries();
+        std::vector<shared_ptr<ValueObject> > valueObjects(entries.size());
+        std::map<ObjectWrapper*, std::size_t> position;
+        for (std::size_t n = 0; n < entries.size(); ++n) {
+            valueObjects[n] = entries[n].second->properties();
+            position[entries[n].second.get()] = n;
+        }
+
+        // The precedents of each Object, as positions in entries.
+        std::vector<std::vector<std::size_t> > precedents(entries.size());
+        for (std::size_t n = 0; n < entries.size(); ++n) {
+            const set<string>& relationObs = valueObjects[n]->getPrecedentObjects();
+            set<string>::const_iterator iter;
+            for (iter = relationObs.begin(); iter != relationObs.end(); ++iter) {
+                shared_ptr<ObjectWrapper> precedent = objectStore_.find(formatID(*iter));
+                std::map<ObjectWrapper*, std::size_t>::const_iterator j =
+                    position.find(precedent.get());
+                if (j != position.end())
+                    precedents[n].push_back(j->second);
+            }
+        }
+
+        // Depth-first traversal collecting the Objects in post-order, so
+        // that each appears after all of its precedents and restore() can
+        // recreate them in a single pass.
+        std::vector<std::size_t> order;
+        std::vector<bool> visited(entries.size(), false);
+        for (std::size_t root = 0; root < entries.size(); ++root) {
+            std::vector<std::pair<std::size_t, bool> > stack;
+            stack.push_back(std::make_pair(root, false));
+            while (!stack.empty()) {
+                std::pair<std::size_t, bool> top = stack.back();
+                stack.pop_back();
+                if (top.second) {
+                    order.push_back(top.first);
+                    continue;
+                }
+                if (visited[top.first])
+                    continue;
+                visited[top.first] = true;
+                stack.push_back(std::make_pair(top.first, true));
+                std::vector<std::size_t>::const_iterator p;
+                for (p = precedents[top.first].begin(); p != precedents[top.first].end(); ++p)
+                    if (!visited[*p])
+                        stack.push_back(std::make_pair(*p, false));
+            }
+        }
+
+        std::vector<Snapshot::Item> items(order.size());
+        for (std::size_t n = 0; n < order.size(); ++n) {
+            items[n].objectID = entries[order[n]].first;
+            items[n].valueObject = valueObjects[order[n]];
+        }
+
+        Snapshot::write(path, items, overwrite);
+        return items.size();
+    }
+
+    std::vector<string> Repository::restore(const string &path,
+                                            bool overwrite,
+                                            bool deferCreation) {
+
+        // Held by the loaders of the ValueObjects which are read on demand.
+        shared_ptr<Snapshot> snapshot(new Snapshot(path));
+        std::vector<string> ret;
+        ret.reserve(snapshot->size());
+        for (std::size_t n = 0; n < snapshot->size(); ++n) {
+            if (deferCreation) {
+                ProcessorPtr processor =
+                    ProcessorFactory::instance().getProcessor(snapshot->processorName(n));
+                if (processor && processor->defersOnly()) {
+                    ret.push_back(deferObject(snapshot->objectID(n),
+                        boost::bind(&Snapshot::valueObject, snapshot, n),
+                        snapshot->permanent(n), overwrite));
+                    continue;
+                }
+            }
+            shared_ptr<ValueObject> valueObject = snapshot->valueObject(n);
+            try {
+                ProcessorPtr processor = ProcessorFactory::instance().getProcessor(valueObject);
+                ret.push_back(deferCreation
+                    ? processor->processDeferred(
+                        SerializationFactory::instance(), valueObject, overwrite)
+                    : processor->process(
+                        SerializationFactory::instance(), valueObject, overwrite));
+            } catch (const std::exception &e) {
+                OH_FAIL("Error restoring object '" << snapshot->objectID(n)
+                        << "' from snapshot " << path << ": " << e.what());
+            }
+        }
+        ProcessorFactory::instance().postProcess();
+        return ret;
     }
 
     void Repository::dump(std::ostream& out) {
 
         out << "dump of all objects in ObjectHandler:" << endl << endl;
-        ObjectMap::const_iterator i;
-        for (i=objectMap_.begin(); i!=objectMap_.end(); ++i) {
-                shared_ptr<Object> object = i->second->object();
-                out << "Object with ID = " << i->first << ":" << endl <<object;
+        std::vector<ObjectStore::Entry> entries = objectStore_.entries();
+        std::vector<ObjectStore::Entry>::const_iterator i;
+        for (i=entries.begin(); i!=entries.end(); ++i) {
+                out << "Object with ID = " << i->first << ":" << endl;
+                i->second->ObjectWrapper::dump(out);
         }
     }
 
     void Repository::dumpObject(const string &objectID, std::ostream &out) {
 
         string realID = formatID(objectID);
-        ObjectMap::const_iterator result = objectMap_.find(realID);
-        if (result == objectMap_.end()) {
+        shared_ptr<ObjectWrapper> objWrapper = objectStore_.find(realID);
+        if (!objWrapper) {
             out << "no object in repository with ID = " << realID << endl;
         } else {
             out << "log dump of object with ID = " << realID <<
-                endl << result->second;
+                endl << objWrapper;
         }
     }
 
     int Repository::objectCount() {
-        return objectMap_.size();
+        return objectStore_.size();
     }
 
     const std::vector<string> Repository::listObjectIDs(const string &regex) {
 
         std::vector<string> objectIDs;
+        std::vector<ObjectStore::Entry> entries = objectStore_.entries();
+        std::vector<ObjectStore::Entry>::const_iterator i;
         if (regex.empty()) {
-            objectIDs.reserve(objectMap_.size());
-            ObjectMap::const_iterator i;
-            for (i=objectMap_.begin(); i!=objectMap_.end(); ++i)
+            objectIDs.reserve(entries.size());
+            for (i=entries.begin(); i!=entries.end(); ++i)
                 objectIDs.push_back(i->first);
         } else {
             boost::regex r(regex, boost::regex::perl | boost::regex::icase);
-            ObjectMap::const_iterator i;
-            for (i=objectMap_.begin(); i!=objectMap_.end(); ++i) {
+            for (i=entries.begin(); i!=entries.end(); ++i) {
                 string objectID = i->first;
                 if (regex_match(objectID, r))
                     objectIDs.push_back(objectID);
@@ -200,7 +675,7 @@ namespace ObjectHandler {
     }
 
     bool Repository::objectExists(const string &objectID) const {
-        return objectMap_.find(objectID) != objectMap_.end();
+        return objectStore_.exists(objectID);
     }
 
     std::vector<bool>
@@ -221,10 +696,9 @@ namespace ObjectHandler {
 
         std::vector<string>::const_iterator i;
         for (i = objectList.begin(); i != objectList.end(); ++i) {
-            string realID = formatID(*i);
-            if(objectExists(realID)){
-                ObjectMap::const_iterator result = objectMap_.find(realID);
-                ret.push_back(result->second->creationTime());
+            shared_ptr<ObjectWrapper> objWrapper = objectStore_.find(formatID(*i));
+            if (objWrapper) {
+                ret.push_back(objWrapper->creationTime());
             } else {
                 OH_FAIL("Unable to retrieve object with ID "<<*i);
             }
@@ -239,10 +713,9 @@ namespace ObjectHandler {
         for (std::vector<string>::const_iterator i = objectList.begin();
             i != objectList.end(); ++i) {
 
-                string realID = formatID(*i);
-                if (objectExists(realID)){
-                    ObjectMap::const_iterator result = objectMap_.find(realID);
-                    ret.push_back( result->second->updateTime());
+                shared_ptr<ObjectWrapper> objWrapper = objectStore_.find(formatID(*i));
+                if (objWrapper) {
+                    ret.push_back(objWrapper->updateTime());
                 } else {
                     OH_FAIL("Unable to retrieve object with ID "<<*i);
                 }
@@ -252,11 +725,10 @@ namespace ObjectHandler {
 
     const std::vector<string>
     Repository::precedentIDs(const string &objectID) {
-        string realID = formatID(objectID);
-        if (objectExists(realID)){
-			ObjectMap::const_iterator result = objectMap_.find(realID);
-
-			shared_ptr<Object> object = result->second->object();
+        shared_ptr<ObjectWrapper> objWrapper = objectStore_.find(formatID(objectID));
+        if (objWrapper) {
+            createObject(objWrapper);
+			shared_ptr<Object> object = objWrapper->object();
 			shared_ptr<Group> group = boost::dynamic_pointer_cast<Group>(object);
 
 			if(group)
@@ -294,10 +766,9 @@ namespace ObjectHandler {
 
         std::vector<string>::const_iterator i;
         for (i = objectList.begin(); i != objectList.end(); ++i) {
-            string realID = formatID(*i);
-            if (objectExists(realID)){
-                ObjectMap::const_iterator result = objectMap_.find(realID);
-                ret.push_back(result->second->object()->permanent());
+            shared_ptr<ObjectWrapper> objWrapper = objectStore_.find(formatID(*i));
+            if (objWrapper) {
+                ret.push_back(objWrapper->permanent());
             } else {
                 OH_FAIL("Unable to retrieve object with ID "<<*i);
             }
@@ -311,13 +782,9 @@ namespace ObjectHandler {
 
         std::vector<string>::const_iterator i;
         for (i = objectList.begin(); i != objectList.end(); ++i) {
-            string realID = formatID(*i);
-            if (objectExists(realID)){
-
-                ObjectMap::const_iterator result = objectMap_.find(realID);
-
-                ret.push_back(result->second->object()->properties()->className());
-
+            shared_ptr<ObjectWrapper> objWrapper = objectStore_.find(formatID(*i));
+            if (objWrapper) {
+                ret.push_back(objWrapper->properties()->className());
             } else {
                 OH_FAIL("Unable to retrieve object with ID "<<*i);
             }
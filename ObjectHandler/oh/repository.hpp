@@ -29,6 +29,10 @@
 #include <oh/ohdefines.hpp>
 #include <oh/iless.hpp>
 #include <map>
+#include <typeinfo>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/thread/recursive_mutex.hpp>
+#endif
 
 //! ObjectHandler
 /*! Namespace for ObjectHandler functionality.
@@ -38,6 +42,11 @@ namespace ObjectHandler {
 	//! Forward declarations
 	class Group;
 
+    //! Stable integer handle for an interned object ID.
+    /*! \sa Repository::handle()
+    */
+    typedef std::size_t ObjectHandle;
+
     //! Maintain a store of Objects.
     /*! The client application may store, retrieve, and delete Objects in
         the Repository.
@@ -49,6 +58,12 @@ namespace ObjectHandler {
 
         This class is designed so that it can be exported across DLL
         boundaries on the Windows platform.
+
+        If OH_ENABLE_THREAD_SAFE_REPOSITORY is defined then Objects may be
+        retrieved concurrently from multiple threads.  The store is split into
+        shards, each guarded by a reader/writer lock (see class ObjectStore),
+        and structural changes - storing and deleting Objects - are serialized
+        against one another.
     */
     class DLL_API Repository {
     public:
@@ -79,6 +94,26 @@ namespace ObjectHandler {
                                         bool overwrite = false,
                                         boost::shared_ptr<ValueObject> valueObject = boost::shared_ptr<ValueObject>());
 
+        //! Store a ValueObject with the given ID, deferring creation of its Object.
+        /*! The Object is created from the ValueObject the first time that it
+            is retrieved.  If creation fails then the error is reported to
+            the caller attempting the retrieval, and again on each subsequent
+            attempt.  Any existing Object with that ID is replaced, its
+            dependants are marked Dirty.
+        */
+        virtual std::string deferObject(const std::string &objectID,
+                                        const boost::shared_ptr<ValueObject> &valueObject,
+                                        bool overwrite = false);
+        //! As above, but the ValueObject is read from the loader when it is first needed.
+        /*! The value of the ValueObject's Permanent property is given, see
+            ObjectWrapper.  The ID of the Object is not checked against the
+            OBJECTID property of the ValueObject.
+        */
+        virtual std::string deferObject(const std::string &objectID,
+                                        const ValueObjectLoader &loader,
+                                        bool permanent,
+                                        bool overwrite = false);
+
         //! Template member function to retrieve the Object with given ID.
         /*! Retrieve the object with the given ID and downcast it to the desired type.
             Throw an exception if no Object exists with that ID.
@@ -103,6 +138,54 @@ namespace ObjectHandler {
         void retrieveObject(boost::shared_ptr<Object> &ret,
                             const std::string &id);
 
+        //! Template member function to retrieve the Object with the given handle.
+        /*! As retrieveObject() above, but the Object is identified by a handle
+            previously obtained from handle().  The downcast pointer is cached
+            against the handle, so that as long as the Object has not been
+            replaced or recreated, repeated retrieval involves no string
+            handling and no dynamic_pointer_cast.
+        */
+        template <class T>
+        void retrieveObject(boost::shared_ptr<T> &ret,
+                            ObjectHandle handle) {
+            boost::shared_ptr<Object> object = retrieveObjectImpl(handle);
+            boost::shared_ptr<void> cached = cachedObject(handle, typeid(T), object.get());
+            if (cached) {
+                ret = boost::static_pointer_cast<T>(cached);
+                return;
+            }
+            ret = boost::dynamic_pointer_cast<T>(object);
+            OH_REQUIRE(ret, "Error retrieving object with id '"
+                << handleID(handle) << "' - unable to convert reference to type '"
+                << typeid(T).name() << "' found instead '"
+                << typeid(*object).name() << "'");
+            cacheObject(handle, typeid(T), object.get(), ret);
+        }
+
+        //! Retrieve the Object with the given handle without downcasting it.
+        void retrieveObject(boost::shared_ptr<Object> &ret,
+                            ObjectHandle handle);
+
+        //! Retrieve the Object with the given handle.
+        /*! The ObjectWrapper associated with the handle is cached, and is only
+            looked up again by ID if the Object has been deleted since the
+            handle was last used.  Throws an exception if no Object exists with
+            the ID associated with the handle.
+        */
+        virtual boost::shared_ptr<Object> retrieveObjectImpl(ObjectHandle handle);
+
+        //! Retrieve the ObjectWrappers of the Objects with the given IDs.
+        /*! Equivalent to retrieving each Object in turn, but the IDs are
+            looked up in the store in a single pass, see ObjectStore::find().
+            Objects whose creation was deferred are created, and Dirty Objects
+            are recreated, before the ObjectWrappers are returned.  An empty
+            ID yields a null pointer.  Throws an exception if no Object exists
+            with any other ID.  The downcasts of the Objects may then be
+            obtained from ObjectWrapper::typedObject(), see getObjectVector().
+        */
+        virtual std::vector<boost::shared_ptr<ObjectWrapper> > retrieveObjectWrappers(
+            const std::vector<std::string> &objectIDs);
+
         //! Default implementation of retrieveObjectImpl.
         /*! Retrieves the Object with the given ID.
             Throws an exception if no Object exists with that ID.
@@ -127,6 +210,28 @@ namespace ObjectHandler {
         /*! Take no action if the Repository is already empty.
         */
         virtual void deleteAllObjects(const bool &deletePermanent = false);
+
+        //! Recreate all of the Dirty Objects in the Repository.
+        /*! Dirty Objects are normally recreated one at a time when they are
+            next retrieved.  This function recreates all of them up front,
+            using the precedent IDs of each Object's ValueObject to ensure
+            that no Object is recreated before any of its Dirty precedents.
+
+            If OH_ENABLE_THREAD_SAFE_REPOSITORY is defined then Objects whose
+            precedents are up to date are recreated concurrently on the given
+            number of threads, zero meaning one per hardware thread.  This is
+            only safe if the creator functions registered with the
+            SerializationFactory may themselves be called concurrently.
+            Otherwise, or if threads is 1, the Objects are recreated in turn
+            on the calling thread.
+
+            If the recreation of an Object fails then its dependants are left
+            Dirty, the remaining Objects are recreated regardless, and an
+            exception listing the failures is thrown at the end.
+
+            Returns the number of Objects recreated.
+        */
+        virtual long recreateDirty(long threads = 1);
         //@}
 
         //! \name Logging
@@ -157,11 +262,57 @@ namespace ObjectHandler {
         virtual std::vector<bool> objectExists(const std::vector<std::string> &objectList);
         //@}
 
+        //! \name Snapshots
+        //@{
+        //! Write the ValueObjects of all the Objects in the Repository to a snapshot file.
+        /*! The file holds the ValueObjects in binary form with an index,
+            see class Snapshot, each written after its precedents.  Objects
+            whose creation was deferred are written from the ValueObjects
+            with which they were loaded and are not created.  Returns the
+            count of Objects written.
+        */
+        virtual long snapshot(const std::string &path, bool overwrite = false);
+        //! Recreate the Objects in the given snapshot file.
+        /*! The file is mapped into memory and the Objects are recreated in
+            the order in which they were written, precedents first, then
+            ProcessorFactory::postProcess() is called.  Returns the IDs of
+            the Objects restored.  If deferCreation is true then creation of
+            the Objects is deferred as described for
+            SerializationFactory::loadObject().
+
+            When creation is deferred, and the Processor of a ValueObject
+            does nothing but defer it, see Processor::defersOnly(), the
+            ValueObject itself is not read from the mapping until it is first
+            needed.  The file then stays mapped until every such ValueObject
+            has been read or its Object deleted.  On Windows the file cannot
+            be replaced in the meantime.
+        */
+        virtual std::vector<std::string> restore(const std::string &path,
+                                                 bool overwrite = false,
+                                                 bool deferCreation = false);
+        //@}
+
+        //! \name Object Handles
+        //@{
+        //! Intern the given ID and return a stable handle for it.
+        /*! Repeated calls with the same ID, in any case, return the same handle.
+            The handle remains valid for the lifetime of the Repository, even if
+            the Object is subsequently deleted and stored again under that ID.
+            An Object with the given ID need not exist at the time of the call.
+        */
+        virtual ObjectHandle handle(const std::string &objectID);
+        //! Intern each of the given IDs.
+        std::vector<ObjectHandle> handle(const std::vector<std::string> &objectIDs);
+        //! Retrieve the ID associated with the given handle.
+        std::string handleID(ObjectHandle handle) const;
+        //@}
+
         //! Define the type of the structure used to store the Objects.
         /*! The Repository class cannot declare a private data member of type
             ObjectMap, because std::map cannot be exported across DLL boundaries
-            on the Windows platform.  Instead the map is declared as a static
-            variable in the cpp file.
+            on the Windows platform.  Instead the Objects are held in an
+            ObjectStore declared as a static variable in the cpp file, which
+            partitions them over several maps of this type.
         */
         typedef std::map<std::string, boost::shared_ptr<ObjectWrapper>, my_iless> ObjectMap;
 
@@ -185,8 +336,15 @@ namespace ObjectHandler {
     protected:
         //! A pointer to the Repository instance, used to support the Singleton pattern.
         static Repository *instance_;
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        //! The lock which serializes structural changes to the Repository.
+        /*! A derived class which looks up and then inserts an ObjectWrapper
+            must hold it for the whole of the change, as the base class does.
+        */
+        static boost::recursive_mutex &writerMutex();
+#endif
         //! Get the object ObjectWrapper from ObjectMap
-        virtual const boost::shared_ptr<ObjectWrapper>& getObjectWrapper(const std::string &objectID) const;
+        virtual boost::shared_ptr<ObjectWrapper> getObjectWrapper(const std::string &objectID) const;
 
         //! Register an ObjectWrapper as an Observer of its precedents
         /*! The given ObjectWrapper is registered as an Observer of all of its
@@ -196,6 +354,12 @@ namespace ObjectHandler {
         virtual void registerObserver( 
             boost::shared_ptr<ObjectWrapper> objWrapper);
 
+        //! Create the Object held by the given ObjectWrapper if its creation was deferred.
+        /*! Once created, the ObjectWrapper is registered as an Observer of
+            the Object's precedents.
+        */
+        void createObject(const boost::shared_ptr<ObjectWrapper> &objWrapper);
+
         //! Convert Excel-format Object IDs into the format recognized by the base Repository class
         /*! The functiong will be used in derived class(e.g in class
             repositoryXL it will change the objectID custom_#0001 into custom);
@@ -208,6 +372,18 @@ namespace ObjectHandler {
         //! Retrieve the list of IDs of precedent objects containde in this group
 		virtual const std::vector<std::string> precedentIDs(const boost::shared_ptr<Group>& group);
 
+    private:
+        // Return the downcast pointer cached for the given handle and type,
+        // if it was derived from the given Object, otherwise a null pointer.
+        boost::shared_ptr<void> cachedObject(ObjectHandle handle,
+                                             const std::type_info &type,
+                                             const Object *object) const;
+        // Cache the downcast pointer for the given handle and type.
+        void cacheObject(ObjectHandle handle,
+                         const std::type_info &type,
+                         const Object *object,
+                         const boost::shared_ptr<void> &typed);
+
     };
 
 }
@@ -27,6 +27,7 @@
 #include <oh/range.hpp>
 #include <oh/group.hpp>
 #include <oh/repository.hpp>
+#include <oh/iless.hpp>
 #include <oh/conversions/getobjectvector.hpp>
 
 //#if BOOST_VERSION > 105000
@@ -37,11 +38,23 @@
 
 #include <boost/regex.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/bind.hpp>
+#define OH_LOAD_QUEUE_LOCK boost::mutex::scoped_lock lock(mutex_);
+#else
+#define OH_LOAD_QUEUE_LOCK
+#endif
 #include <boost/serialization/variant.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 
 #include <fstream>
+#include <queue>
+#include <functional>
+#include <algorithm>
 
 namespace ObjectHandler {
 
@@ -97,6 +110,24 @@ namespace ObjectHandler {
         creatorMap_()[className] = creator;
     }
 
+    std::set<std::string> &SerializationFactory::refreshSet_() const {
+        static std::set<std::string> refreshSet;
+        return refreshSet;
+    }
+
+    void SerializationFactory::registerRefresh(const std::string &className) {
+        refreshSet_().insert(className);
+    }
+
+    bool SerializationFactory::refreshObject(
+        const boost::shared_ptr<Object> &object) const {
+
+        const boost::shared_ptr<ValueObject> &valueObject = object->properties();
+        if (!valueObject || refreshSet_().find(valueObject->className()) == refreshSet_().end())
+            return false;
+        return object->refresh(*valueObject);
+    }
+
     boost::shared_ptr<Object> SerializationFactory::recreateObject( 
         boost::shared_ptr<ObjectHandler::ValueObject> valueObject) const {
 
@@ -121,15 +152,72 @@ namespace ObjectHandler {
         return object;
     }
 
+    std::string SerializationFactory::deferObject(
+        const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
+        bool overwriteExisting) const {
+
+        OH_REQUIRE(creatorMap_().find(valueObject->className()) != creatorMap_().end(),
+            "No creator for class " << valueObject->className());
+        std::string objectID = boost::get<std::string>(valueObject->getProperty("OBJECTID"));
+        return ObjectHandler::Repository::instance().deferObject(
+            objectID, valueObject, overwriteExisting);
+    }
+
+    SerializationFactory::ArchiveFormat
+    SerializationFactory::archiveFormat(const std::string &path) {
+        std::string::size_type n = path.size();
+        if (n >= 4 && boost::algorithm::iequals(path.substr(n - 4), ".bin"))
+            return Binary;
+        return Xml;
+    }
+
+    void SerializationFactory::register_out(boost::archive::binary_oarchive &,
+        std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >&) {
+        OH_FAIL("Binary serialization is not supported by this application");
+    }
+
+    void SerializationFactory::register_in(boost::archive::binary_iarchive &,
+        std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >&) {
+        OH_FAIL("Binary serialization is not supported by this application");
+    }
+
+    void SerializationFactory::writeValueObjects(std::ostream &outputStream,
+        std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects,
+        ArchiveFormat format) {
+
+        if (format == Binary) {
+            boost::archive::binary_oarchive oa(outputStream);
+            register_out(oa, valueObjects);
+        } else {
+            boost::archive::xml_oarchive oa(outputStream);
+            register_out(oa, valueObjects);
+        }
+    }
+
+    void SerializationFactory::readValueObjects(std::istream &inputStream,
+        std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects,
+        ArchiveFormat format) {
+
+        if (format == Binary) {
+            boost::archive::binary_iarchive ia(inputStream);
+            register_in(ia, valueObjects);
+        } else {
+            boost::archive::xml_iarchive ia(inputStream);
+            register_in(ia, valueObjects);
+        }
+    }
+
 	int SerializationFactory::saveObjectStream(
 		std::ostream& outputStream,
-        const std::vector<boost::shared_ptr<Object> > objectList)
+        const std::vector<boost::shared_ptr<Object> > objectList,
+        ArchiveFormat format)
 	{
         std::vector<boost::shared_ptr<ObjectHandler::ValueObject> > valueObjects;
         std::set<std::string> seen;
         std::vector<boost::shared_ptr<ObjectHandler::Object> >::const_iterator i;
         for (i=objectList.begin(); i!=objectList.end(); ++i) {
             boost::shared_ptr<ObjectHandler::Object> object = *i;
+            publishProperties(*object);
             // FIXME just call ValueObject::objectId()?
             std::string objectID
                 = boost::get<std::string>(object->properties()->getProperty("OBJECTID"));
@@ -145,8 +233,7 @@ namespace ObjectHandler {
         // 3) I don't understand why this sort is required anyway?
         //std::stable_sort(valueObjects.begin(), valueObjects.end(), compareCategory);
 
-        boost::archive::xml_oarchive oa(outputStream);
-        register_out(oa, valueObjects);
+        writeValueObjects(outputStream, valueObjects, format);
         return valueObjects.size();
 	}
 
@@ -180,6 +267,18 @@ namespace ObjectHandler {
 
         OH_REQUIRE(objectList.size(), "Object list is empty");
 
+        checkOutputPath(path, forceOverwrite);
+
+        ArchiveFormat format = archiveFormat(path);
+        std::ofstream ofs(path.c_str(),
+            format == Binary ? std::ios::out | std::ios::binary : std::ios::out);
+        return saveObjectStream(ofs, objectList, format);
+    }
+
+    void SerializationFactory::checkOutputPath(
+        const std::string &path,
+        bool forceOverwrite) {
+
         // Create a boost path object from the char*.
         boost::filesystem::path boostPath(path);
 
@@ -205,9 +304,32 @@ namespace ObjectHandler {
                 OH_FAIL("Overwrite=FALSE and the specified output file exists: " << path);
             }
         }
+    }
+
+    int SerializationFactory::convertObjectFile(
+        const std::string &inputPath,
+        const std::string &outputPath,
+        bool forceOverwrite) {
+
+        ArchiveFormat inputFormat = archiveFormat(inputPath);
+        ArchiveFormat outputFormat = archiveFormat(outputPath);
+        std::vector<boost::shared_ptr<ObjectHandler::ValueObject> > valueObjects;
+
+        try {
+            std::ifstream ifs(inputPath.c_str(),
+                inputFormat == Binary ? std::ios::in | std::ios::binary : std::ios::in);
+            OH_REQUIRE(ifs, "Unable to open file");
+            readValueObjects(ifs, valueObjects, inputFormat);
+        } catch (const std::exception &e) {
+            OH_FAIL("Error deserializing file " << inputPath << ": " << e.what());
+        }
+        OH_REQUIRE(valueObjects.size(), "Object list is empty");
 
-        std::ofstream ofs(path.c_str());
-        return saveObjectStream(ofs, objectList);
+        checkOutputPath(outputPath, forceOverwrite);
+        std::ofstream ofs(outputPath.c_str(),
+            outputFormat == Binary ? std::ios::out | std::ios::binary : std::ios::out);
+        writeValueObjects(ofs, valueObjects, outputFormat);
+        return valueObjects.size();
     }
 
     /*std::string SerializationFactory::processObject(
@@ -226,50 +348,132 @@ namespace ObjectHandler {
         return objectID;
     }*/
 
-    void SerializationFactory::processPath(
+    void SerializationFactory::readPath(
         const std::string &path,
-        bool overwriteExisting,
-        std::vector<std::string> &processedIDs)  {
-
-        try {
-
-            std::ifstream ifs(path.c_str());
-            boost::archive::xml_iarchive ia(ifs);
-            std::vector<boost::shared_ptr<ObjectHandler::ValueObject> > valueObjects;
+        std::vector<boost::shared_ptr<ObjectHandler::ValueObject> > &valueObjects) {
 
-            register_in(ia, valueObjects);
-
-            OH_REQUIRE(valueObjects.size(), "Object list is empty");
+        ArchiveFormat format = archiveFormat(path);
+        std::ifstream ifs(path.c_str(),
+            format == Binary ? std::ios::in | std::ios::binary : std::ios::in);
+        readValueObjects(ifs, valueObjects, format);
+        OH_REQUIRE(valueObjects.size(), "Object list is empty");
+    }
 
-            std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >::const_iterator i;
-            int count = 0;
-            for (i=valueObjects.begin(); i!=valueObjects.end(); ++i) {
-                try {
-                    processedIDs.push_back(
-                        ProcessorFactory::instance().getProcessor(*i)->process(
-                            *this, *i, overwriteExisting));
-                    count++;
-                } catch (const std::exception &e) {
-                    OH_FAIL("Error processing item " << count << ": " << e.what());
+    namespace {
+
+        // A file to be deserialized, and the result.
+        struct LoadTask {
+            LoadTask(const std::string &p) : path(p) {}
+            std::string path;
+            std::vector<boost::shared_ptr<ValueObject> > valueObjects;
+            std::string error;
+        };
+
+        // Deserializes the files in a list of LoadTasks.  Any number of
+        // threads may call run() concurrently, each takes the next file.
+        class LoadQueue {
+        public:
+            LoadQueue(SerializationFactory &factory,
+                      void (SerializationFactory::*read)(const std::string&,
+                          std::vector<boost::shared_ptr<ValueObject> >&),
+                      std::vector<LoadTask> &tasks)
+            : factory_(factory), read_(read), tasks_(tasks), next_(0) {}
+            void run() {
+                for (;;) {
+                    std::size_t i;
+                    {
+                        OH_LOAD_QUEUE_LOCK
+                        if (next_ == tasks_.size())
+                            return;
+                        i = next_++;
+                    }
+                    LoadTask &task = tasks_[i];
+                    try {
+                        (factory_.*read_)(task.path, task.valueObjects);
+                    } catch (const std::exception &e) {
+                        task.error = e.what();
+                    } catch (...) {
+                        task.error = "unknown error";
+                    }
+                }
+            }
+        private:
+            SerializationFactory &factory_;
+            void (SerializationFactory::*read_)(const std::string&,
+                std::vector<boost::shared_ptr<ValueObject> >&);
+            std::vector<LoadTask> &tasks_;
+            std::size_t next_;
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+            boost::mutex mutex_;
+#endif
+        };
+
+        // Reorder the given ValueObjects so that each follows its
+        // precedents, the Objects it will retrieve from the Repository
+        // when it is created.  Apart from that the original order is
+        // preserved.  Any ValueObjects which form a cycle are left at the
+        // end in their original order.
+        void sortByDependency(std::vector<boost::shared_ptr<ValueObject> > &valueObjects) {
+
+            std::size_t n = valueObjects.size();
+            std::map<std::string, std::size_t, my_iless> index;
+            for (std::size_t i = 0; i < n; ++i)
+                index.insert(std::make_pair(valueObjects[i]->objectId(), i));
+
+            std::vector<std::vector<std::size_t> > dependants(n);
+            std::vector<std::size_t> pending(n, 0);
+            for (std::size_t i = 0; i < n; ++i) {
+                const std::set<std::string> &ids = valueObjects[i]->getPrecedentObjects();
+                for (std::set<std::string>::const_iterator id = ids.begin();
+                     id != ids.end(); ++id) {
+                    std::map<std::string, std::size_t, my_iless>::const_iterator j =
+                        index.find(*id);
+                    if (j != index.end() && j->second != i) {
+                        dependants[j->second].push_back(i);
+                        ++pending[i];
+                    }
                 }
             }
 
-        } catch (const std::exception &e) {
-            OH_FAIL("Error deserializing file " << path << ": " << e.what());
+            // Kahn's algorithm, always taking the earliest ready ValueObject.
+            std::priority_queue<std::size_t, std::vector<std::size_t>,
+                                std::greater<std::size_t> > ready;
+            for (std::size_t i = 0; i < n; ++i)
+                if (pending[i] == 0)
+                    ready.push(i);
+            std::vector<boost::shared_ptr<ValueObject> > sorted;
+            sorted.reserve(n);
+            std::vector<bool> done(n, false);
+            while (!ready.empty()) {
+                std::size_t i = ready.top();
+                ready.pop();
+                sorted.push_back(valueObjects[i]);
+                done[i] = true;
+                std::vector<std::size_t>::const_iterator j;
+                for (j = dependants[i].begin(); j != dependants[i].end(); ++j)
+                    if (--pending[*j] == 0)
+                        ready.push(*j);
+            }
+            for (std::size_t i = 0; i < n; ++i)
+                if (!done[i])
+                    sorted.push_back(valueObjects[i]);
+            valueObjects.swap(sorted);
         }
+
     }
 
     std::vector<std::string> SerializationFactory::loadObject(
         const std::string &directory,
         const std::string &pattern,
         bool recurse,
-        bool overwriteExisting)  {
+        bool overwriteExisting,
+        bool deferCreation)  {
 
         boost::filesystem::path boostPath(directory);
         OH_REQUIRE(boost::filesystem::exists(boostPath) && boost::filesystem::is_directory(boostPath),
             "The specified directory is not valid : " << directory);
 
-        std::vector<std::string> returnValue;
+        std::vector<std::string> paths;
         bool fileFound = false;
         boost::regex r(pattern, boost::regex::perl | boost::regex::icase);
 
@@ -284,7 +488,7 @@ namespace ObjectHandler {
 #endif
                                     boost::filesystem::is_regular(itr->status())) {
                         fileFound = true;
-                        processPath(itr->path().string(), overwriteExisting, returnValue);
+                        paths.push_back(itr->path().string());
                     }
             }
 
@@ -299,7 +503,7 @@ namespace ObjectHandler {
 #endif
                                     boost::filesystem::is_regular(itr->status())) {
                         fileFound = true;
-                        processPath(itr->path().string(), overwriteExisting, returnValue);
+                        paths.push_back(itr->path().string());
                     }
             }
 
@@ -308,7 +512,57 @@ namespace ObjectHandler {
         OH_REQUIRE(fileFound, "Found no files matching pattern '" << pattern << "' in directory '"
             << directory << "' with recursion = " << std::boolalpha << recurse);
 
-        // processPath() will already have thrown if empty files were detected
+        // Deserialize the files, concurrently if possible.
+        std::vector<LoadTask> tasks(paths.begin(), paths.end());
+        LoadQueue queue(*this, &SerializationFactory::readPath, tasks);
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        std::size_t threads = std::min<std::size_t>(
+            boost::thread::hardware_concurrency(), tasks.size());
+        boost::thread_group pool;
+        try {
+            for (std::size_t n = 1; n < threads; ++n)
+                pool.create_thread(boost::bind(&LoadQueue::run, &queue));
+        } catch (const boost::thread_resource_error &) {
+            // Carry on with however many threads could be started.
+        }
+        queue.run();
+        pool.join_all();
+#else
+        queue.run();
+#endif
+
+        // Restore the objects in dependency order, so that objects
+        // may refer to those loaded from other files.
+        std::vector<boost::shared_ptr<ObjectHandler::ValueObject> > valueObjects;
+        std::map<ValueObject*, std::string> sourcePath;
+        std::vector<LoadTask>::const_iterator t;
+        for (t = tasks.begin(); t != tasks.end(); ++t) {
+            OH_REQUIRE(t->error.empty(),
+                "Error deserializing file " << t->path << ": " << t->error);
+            valueObjects.insert(valueObjects.end(),
+                t->valueObjects.begin(), t->valueObjects.end());
+            std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >::const_iterator v;
+            for (v = t->valueObjects.begin(); v != t->valueObjects.end(); ++v)
+                sourcePath[v->get()] = t->path;
+        }
+        sortByDependency(valueObjects);
+
+        std::vector<std::string> returnValue;
+        std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >::const_iterator i;
+        for (i = valueObjects.begin(); i != valueObjects.end(); ++i) {
+            try {
+                ProcessorPtr processor = ProcessorFactory::instance().getProcessor(*i);
+                returnValue.push_back(deferCreation
+                    ? processor->processDeferred(*this, *i, overwriteExisting)
+                    : processor->process(*this, *i, overwriteExisting));
+            } catch (const std::exception &e) {
+                OH_FAIL("Error deserializing file " << sourcePath[i->get()]
+                    << ": Error processing object '" << (*i)->objectId()
+                    << "': " << e.what());
+            }
+        }
+
+        // readPath() will already have thrown if empty files were detected
         // so the following is a redundant sanity check.
         OH_REQUIRE(!returnValue.empty(), "No objects loaded from directory : " << directory);
 
@@ -336,15 +590,15 @@ namespace ObjectHandler {
 
     std::vector<std::string> SerializationFactory::loadObjectStream(
         std::istream& xmlStream,
-        bool overwriteExisting) {
+        bool overwriteExisting,
+        ArchiveFormat format,
+        bool deferCreation) {
 
         std::vector<std::string> returnValue;
 
         try {
-            boost::archive::xml_iarchive ia(xmlStream);
-
             std::vector<boost::shared_ptr<ObjectHandler::ValueObject> > valueObjects;
-            register_in(ia, valueObjects);
+            readValueObjects(xmlStream, valueObjects, format);
 
             OH_REQUIRE(valueObjects.size(), "Object list is empty");
 
@@ -352,9 +606,10 @@ namespace ObjectHandler {
             int count = 0;
             for (i=valueObjects.begin(); i!=valueObjects.end(); ++i) {
                 try {
-                    returnValue.push_back(
-                        ProcessorFactory::instance().getProcessor(*i)->process(
-                            *this, *i, overwriteExisting));
+                    ProcessorPtr processor = ProcessorFactory::instance().getProcessor(*i);
+                    returnValue.push_back(deferCreation
+                        ? processor->processDeferred(*this, *i, overwriteExisting)
+                        : processor->process(*this, *i, overwriteExisting));
                     count++;
                 } catch (const std::exception &e) {
                     OH_FAIL("Error processing item " << count << ": " << e.what());
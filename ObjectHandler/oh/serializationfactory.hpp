@@ -29,11 +29,14 @@
 #include <oh/object.hpp>
 #include <oh/valueobject.hpp>
 #include <map>
+#include <set>
 #include <string>
 #include <list>
 
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/archive/xml_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
 
 namespace ObjectHandler {
 
@@ -44,6 +47,13 @@ namespace ObjectHandler {
     //! A Singleton wrapping the boost::serialization interface
     /*! The pure virtual functions in this class must be implemented as appropriate
         for client applications.
+
+        Objects may be serialized either to XML or to a compact binary
+        format which is much faster to load.  For files, the format is
+        determined by the file name, see archiveFormat().  Binary files are
+        specific to the platform and the version of boost with which they
+        were written.  Use convertObjectFile() to translate between the
+        two formats.
     */
     class DLL_API SerializationFactory {
 
@@ -59,6 +69,16 @@ namespace ObjectHandler {
         static SerializationFactory &instance();
         //@}
 
+        //! \name Archive formats
+        //@{
+        //! The formats in which Objects may be serialized.
+        enum ArchiveFormat { Xml, Binary };
+        //! The format implied by the given file name.
+        /*! Binary for files with extension ".bin", Xml otherwise.
+        */
+        static ArchiveFormat archiveFormat(const std::string &path);
+        //@}
+
         //! \name Serialization - public interface
         //@{
         //! Serialize the given Object list to the path indicated.
@@ -81,7 +101,8 @@ namespace ObjectHandler {
         //! Write the object(s) to the given stream.
         virtual int saveObjectStream(
 			std::ostream& outputStream,
-            const std::vector<boost::shared_ptr<Object> > objectList);
+            const std::vector<boost::shared_ptr<Object> > objectList,
+            ArchiveFormat format = Xml);
 
         //! Write the object(s) to the given stream.
         virtual int saveObjectStream(
@@ -89,22 +110,61 @@ namespace ObjectHandler {
             const std::vector<std::string>& handlesList,
             bool includeGroups = true);
 
-        //! Deserialize an Object list from the path indicated.
+        //! Deserialize the Objects in all files matching the pattern.
+        /*! The files are first deserialized into ValueObjects, on several
+            threads if OH_ENABLE_THREAD_SAFE_REPOSITORY is defined.  The
+            Objects are then created on the calling thread, ordered by their
+            precedent Object IDs, see ValueObject::getPrecedentObjects(), so
+            that each Object is created after those of its precedents which
+            are being loaded, regardless of which files they came from.
+            ProcessorFactory::postProcess() is called once at the end.
+
+            If deferCreation is true then Objects which need no special
+            processing are not created at all, the Repository holds their
+            ValueObjects and creates each Object the first time that it is
+            retrieved, see Processor::processDeferred().  Any error in
+            creating an Object is then reported when it is retrieved.
+        */
         virtual std::vector<std::string> loadObject(
             const std::string &directory,
             const std::string &pattern,
             bool recurse,
-            bool overwriteExisting);
+            bool overwriteExisting,
+            bool deferCreation = false);
 
         //! Load object(s) from the given stream.
+        /*! See loadObject() for the meaning of deferCreation.
+        */
         virtual std::vector<std::string> loadObjectStream(
             std::istream &xmlStream,
-            bool overwriteExisting);
+            bool overwriteExisting,
+            ArchiveFormat format = Xml,
+            bool deferCreation = false);
 
         //! Load object(s) from the given string.
         virtual std::vector<std::string> loadObjectString(
             const std::string &xml,
             bool overwriteExisting);
+
+        //! Write ValueObjects to the given stream in the given format.
+        void writeValueObjects(std::ostream &outputStream,
+            std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects,
+            ArchiveFormat format);
+        //! Read ValueObjects from the given stream in the given format.
+        void readValueObjects(std::istream &inputStream,
+            std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects,
+            ArchiveFormat format);
+
+        //! Convert a file of serialized objects from one format to another.
+        /*! The formats of the input and output files are determined by their
+            names, see archiveFormat().  The objects are not created, so this
+            function does not affect the Repository.  Returns the count of
+            objects converted.
+        */
+        virtual int convertObjectFile(
+            const std::string &inputPath,
+            const std::string &outputPath,
+            bool forceOverwrite);
         //@}
 
         //! \name Object Creation
@@ -120,14 +180,25 @@ namespace ObjectHandler {
         StrObjectPair restoreObject(
             const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
             bool overwriteExisting) const;
+        //! Store a ValueObject in the Repository, deferring creation of its Object.
+        /*! The Object is created by recreateObject() the first time it is
+            retrieved, see Repository::deferObject().  Returns the ID of the
+            Object.
+        */
+        std::string deferObject(
+            const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
+            bool overwriteExisting) const;
+        //! Update an Object in place from its ValueObject
+        /*! If the class of the given Object has been registered with
+            registerRefresh() then call Object::refresh() and return the
+            result, otherwise return false.  A return value of false means
+            that the Object must be recreated with recreateObject().
+        */
+        bool refreshObject(const boost::shared_ptr<Object> &object) const;
         //@}
 
       protected:
 
-        virtual void processPath(
-            const std::string &path,
-            bool overwriteExisting,
-            std::vector<std::string> &processedIDs);
         /*virtual std::string processObject(
             const boost::shared_ptr<ObjectHandler::ValueObject> &valueObject,
             bool overwriteExisting);*/
@@ -135,6 +206,25 @@ namespace ObjectHandler {
             std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects) = 0;
         virtual void register_in(boost::archive::xml_iarchive &ar,
             std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects) = 0;
+        //! Write ValueObjects to a binary archive.
+        /*! Client applications which support the binary format override this
+            function and its counterpart register_in() in the same way as
+            for XML.  The default implementation throws an exception.
+        */
+        virtual void register_out(boost::archive::binary_oarchive &ar,
+            std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects);
+        virtual void register_in(boost::archive::binary_iarchive &ar,
+            std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects);
+
+        //! Deserialize the ValueObjects in the given file.
+        /*! The format is determined by the file name, see archiveFormat().
+            This function does not modify the Repository and may be called
+            concurrently from several threads.
+        */
+        void readPath(const std::string &path,
+            std::vector<boost::shared_ptr<ObjectHandler::ValueObject> > &valueObjects);
+        //! Ensure that the given output file may be written.
+        void checkOutputPath(const std::string &path, bool forceOverwrite);
 
         //! A pointer to the SerializationFactory instance, used to support the Singleton pattern.
         static SerializationFactory *instance_;
@@ -142,11 +232,15 @@ namespace ObjectHandler {
         typedef boost::shared_ptr<Object> (*Creator)(const boost::shared_ptr<ValueObject>&);
         //! Register a Creator with the Factory.
         void registerCreator(const std::string &className, const Creator &creator);
+        //! Indicate that Objects of the given class support Object::refresh().
+        void registerRefresh(const std::string &className);
         // A map of Creators for each supported class.
         typedef std::map<std::string, Creator> CreatorMap;
         // Cannot export std::map across DLL boundaries, so instead of a data member
         // use a private member function that wraps a reference to a static variable.
         CreatorMap &creatorMap_() const;
+        // The classes registered with registerRefresh(), likewise.
+        std::set<std::string> &refreshSet_() const;
     };
 
 }
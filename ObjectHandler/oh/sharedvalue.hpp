@@ -0,0 +1,229 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Class SharedValue - An immutable value shared by all of its copies
+*/
+
+#ifndef oh_sharedvalue_hpp
+#define oh_sharedvalue_hpp
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/serialization/split_free.hpp>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/level.hpp>
+#include <boost/serialization/tracking.hpp>
+#include <boost/serialization/version.hpp>
+#include <map>
+#include <vector>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/once.hpp>
+#endif
+
+namespace ObjectHandler {
+
+    //! An immutable value shared by all of its copies.
+    /*! A ValueObject captures every input to the constructor of its Object,
+        and a large number of Objects are often constructed from identical
+        vectors, e.g. the nominals and the schedule dates of a book of
+        swaps.  A SharedValue holds a reference to an immutable T which it
+        looks up by content in a pool when it is constructed from a T or
+        assigned, so that equal values are stored only once.  A default
+        constructed SharedValue refers to a single empty T without taking
+        the lock of the pool.  Copying a SharedValue copies the reference.
+        Assigning a new value replaces the reference, the T which was
+        previously referenced is not modified.
+
+        The pool holds weak references, a T is destroyed and removed from the
+        pool when the last SharedValue which refers to it is destroyed.
+
+        A SharedValue is serialized exactly as the T which it holds, so that
+        archives written before a ValueObject member was changed from T to
+        SharedValue<T> can still be read, and vice versa.
+
+        T must be copyable, equality comparable, and hashable by boost::hash.
+    */
+    template <class T>
+    class SharedValue {
+    public:
+        typedef T value_type;
+
+        //! \name Structors
+        //@{
+        //! Refer to a default constructed T, which is not looked up in the pool.
+        SharedValue() {}
+        SharedValue(const T& t) : value_(intern(t)) {}
+        //@}
+
+        //! \name Modifiers
+        //@{
+        SharedValue& operator=(const T& t) {
+            value_ = intern(t);
+            return *this;
+        }
+        //@}
+
+        //! \name Inspectors
+        //@{
+        const T& get() const { return value_ ? *value_ : pool().empty; }
+        operator const T&() const { return get(); }
+        const T* operator->() const { return &get(); }
+        //! Test whether this and the given SharedValue refer to the same T.
+        bool shares(const SharedValue& s) const { return value_ == s.value_; }
+        bool operator==(const SharedValue& s) const {
+            return value_ == s.value_ || get() == s.get();
+        }
+        //! Count of the distinct values of type T currently in the pool.
+        static std::size_t poolSize() {
+            Pool &p = pool();
+            Lock lock(p.mutex);
+            return p.values.size();
+        }
+        //@}
+
+    private:
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        typedef boost::mutex Mutex;
+        typedef boost::lock_guard<Mutex> Lock;
+#else
+        struct Mutex {};
+        struct Lock { explicit Lock(Mutex &) {} };
+#endif
+        typedef std::multimap<std::size_t, boost::weak_ptr<const T> > ValueMap;
+        struct Pool {
+            Pool() : empty() {}
+            Mutex mutex;
+            ValueMap values;
+            // the value of default constructed SharedValues
+            const T empty;
+        };
+
+        // The pool is created on first use and never destroyed, values held
+        // by static objects may outlive any static pool.  pool_ and
+        // poolOnce_ are initialized statically, so the first use may come
+        // from any thread.
+        static Pool &pool() {
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+            boost::call_once(poolOnce_, &SharedValue::createPool);
+#else
+            if (!pool_)
+                createPool();
+#endif
+            return *pool_;
+        }
+        static void createPool() { pool_ = new Pool; }
+        static Pool *pool_;
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        static boost::once_flag poolOnce_;
+#endif
+
+        // Remove the pool entry of a value when it is destroyed.
+        struct Release {
+            explicit Release(std::size_t hash) : hash_(hash) {}
+            void operator()(const T *t) const {
+                {
+                    Pool &p = pool();
+                    Lock lock(p.mutex);
+                    std::pair<typename ValueMap::iterator, typename ValueMap::iterator>
+                        range = p.values.equal_range(hash_);
+                    while (range.first != range.second) {
+                        if (range.first->second.expired())
+                            p.values.erase(range.first++);
+                        else
+                            ++range.first;
+                    }
+                }
+                delete t;
+            }
+            std::size_t hash_;
+        };
+
+        static boost::shared_ptr<const T> intern(const T& t) {
+            std::size_t hash = boost::hash<T>()(t);
+            Pool &p = pool();
+            // Values which are found not to match are released after the
+            // lock, releasing the last reference removes the pool entry.
+            std::vector<boost::shared_ptr<const T> > mismatches;
+            Lock lock(p.mutex);
+            std::pair<typename ValueMap::iterator, typename ValueMap::iterator>
+                range = p.values.equal_range(hash);
+            for (; range.first != range.second; ++range.first) {
+                boost::shared_ptr<const T> value = range.first->second.lock();
+                if (value && *value == t)
+                    return value;
+                mismatches.push_back(value);
+            }
+            boost::shared_ptr<const T> value(new T(t), Release(hash));
+            p.values.insert(std::make_pair(hash, boost::weak_ptr<const T>(value)));
+            return value;
+        }
+
+        boost::shared_ptr<const T> value_;
+    };
+
+    template <class T>
+    typename SharedValue<T>::Pool *SharedValue<T>::pool_ = 0;
+
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    template <class T>
+    boost::once_flag SharedValue<T>::poolOnce_ = BOOST_ONCE_INIT;
+#endif
+
+}
+
+namespace boost { namespace serialization {
+
+    // Serialize a SharedValue<T> with the class information of T and the
+    // content of T, so that it is indistinguishable from T in an archive.
+
+    template <class T>
+    struct implementation_level<ObjectHandler::SharedValue<T> >
+        : public implementation_level<T> {};
+
+    template <class T>
+    struct tracking_level<ObjectHandler::SharedValue<T> >
+        : public tracking_level<T> {};
+
+    template <class T>
+    struct version<ObjectHandler::SharedValue<T> >
+        : public version<T> {};
+
+    template <class Archive, class T>
+    void save(Archive &ar, const ObjectHandler::SharedValue<T> &s, const unsigned int v) {
+        serialize_adl(ar, const_cast<T&>(s.get()), v);
+    }
+
+    template <class Archive, class T>
+    void load(Archive &ar, ObjectHandler::SharedValue<T> &s, const unsigned int v) {
+        T t;
+        serialize_adl(ar, t, v);
+        s = t;
+    }
+
+    template <class Archive, class T>
+    void serialize(Archive &ar, ObjectHandler::SharedValue<T> &s, const unsigned int v) {
+        split_free(ar, s, v);
+    }
+
+} }
+
+#endif
+
@@ -0,0 +1,281 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <oh/config.hpp>
+#endif
+
+#include <oh/snapshot.hpp>
+#include <oh/serializationfactory.hpp>
+#include <oh/exception.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/filesystem.hpp>
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#endif
+#include <fstream>
+#include <sstream>
+#include <streambuf>
+#include <cstdio>
+#include <cstring>
+
+using boost::shared_ptr;
+using boost::uint32_t;
+using boost::uint64_t;
+using std::string;
+
+namespace ObjectHandler {
+
+    // The layout of the file.  All offsets are from the start of the file.
+    struct Snapshot::Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t count;
+        uint64_t indexOffset;
+        uint64_t dataOffset;
+        uint64_t fileSize;
+    };
+
+    struct Snapshot::IndexEntry {
+        uint64_t idOffset;
+        uint64_t idLength;
+        uint64_t valueObjectOffset;
+        uint64_t valueObjectLength;
+        uint64_t processorOffset;
+        uint64_t processorLength;
+        uint64_t permanent;
+    };
+
+    namespace {
+
+        const char magic[8] = { 'O', 'H', 'S', 'N', 'A', 'P', '\0', '\0' };
+        const uint32_t byteOrder = 0x01020304;
+
+        // Read-only stream buffer over a block of memory.
+        class MemoryBuffer : public std::streambuf {
+        public:
+            MemoryBuffer(const char *begin, std::size_t length) {
+                char *p = const_cast<char*>(begin);
+                setg(p, p, p + length);
+            }
+        };
+
+        template <class T>
+        void put(std::ostream &out, const T &t) {
+            out.write(reinterpret_cast<const char*>(&t), sizeof(T));
+        }
+
+        // As ObjectWrapper::permanent(), classes with no Permanent
+        // property create transient Objects.
+        bool isPermanent(const ValueObject &valueObject) {
+            try {
+                return boost::get<bool>(valueObject.getProperty("Permanent"));
+            } catch (const std::exception &) {
+                return false;
+            }
+        }
+
+    }
+
+    void Snapshot::write(const string &path,
+                         const std::vector<Item> &items,
+                         bool forceOverwrite) {
+
+        OH_REQUIRE(forceOverwrite || !boost::filesystem::exists(path),
+                   "Overwrite=FALSE and the specified output file exists: " << path);
+
+        std::vector<string> archives, processors;
+        archives.reserve(items.size());
+        processors.reserve(items.size());
+        std::vector<Item>::const_iterator i;
+        for (i = items.begin(); i != items.end(); ++i) {
+            std::ostringstream out;
+            std::vector<shared_ptr<ValueObject> > valueObjects(1, i->valueObject);
+            SerializationFactory::instance().writeValueObjects(
+                out, valueObjects, SerializationFactory::Binary);
+            archives.push_back(out.str());
+            processors.push_back(i->valueObject->processorName());
+        }
+
+        Header header;
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        header.byteOrder = byteOrder;
+        header.count = items.size();
+        header.indexOffset = sizeof(Header);
+        header.dataOffset = header.indexOffset + items.size() * sizeof(IndexEntry);
+
+        std::vector<IndexEntry> index(items.size());
+        uint64_t offset = header.dataOffset;
+        for (std::size_t n = 0; n < items.size(); ++n) {
+            index[n].idOffset = offset;
+            index[n].idLength = items[n].objectID.size();
+            offset += index[n].idLength;
+            index[n].valueObjectOffset = offset;
+            index[n].valueObjectLength = archives[n].size();
+            offset += index[n].valueObjectLength;
+            index[n].processorOffset = offset;
+            index[n].processorLength = processors[n].size();
+            offset += index[n].processorLength;
+            index[n].permanent = isPermanent(*items[n].valueObject);
+        }
+        header.fileSize = offset;
+
+        // Write a temporary file alongside the target and rename it over
+        // the target, so that a process which has mapped the previous
+        // version of the file is not disturbed, and so that a failure
+        // part way through does not destroy the previous snapshot.
+        boost::filesystem::path target(path);
+        string tempPath = (target.parent_path() / boost::filesystem::unique_path(
+            target.filename().string() + ".%%%%-%%%%-%%%%.tmp")).string();
+        {
+            std::ofstream out(tempPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            OH_REQUIRE(out, "Unable to open snapshot file for writing: " << tempPath);
+            put(out, header);
+            for (std::size_t n = 0; n < index.size(); ++n)
+                put(out, index[n]);
+            for (std::size_t n = 0; n < items.size(); ++n) {
+                out.write(items[n].objectID.data(), items[n].objectID.size());
+                out.write(archives[n].data(), archives[n].size());
+                out.write(processors[n].data(), processors[n].size());
+            }
+            out.close();
+            if (!out) {
+                std::remove(tempPath.c_str());
+                OH_FAIL("Error writing snapshot file: " << tempPath);
+            }
+        }
+
+#if defined(_WIN32)
+        // rename() does not replace an existing file on Windows, replace it
+        // in a single step so that the file is never missing
+        if (!MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            DWORD error = GetLastError();
+            std::remove(tempPath.c_str());
+            OH_FAIL("Unable to replace snapshot file " << path << " (error "
+                    << error << "), it may be mapped by another process");
+        }
+#else
+        if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+            std::remove(tempPath.c_str());
+            OH_FAIL("Unable to rename " << tempPath << " to " << path);
+        }
+#endif
+    }
+
+    Snapshot::Snapshot(const string &path) : path_(path), data_(0), size_(0) {
+
+        try {
+            file_.reset(new boost::interprocess::file_mapping(
+                path.c_str(), boost::interprocess::read_only));
+            region_.reset(new boost::interprocess::mapped_region(
+                *file_, boost::interprocess::read_only));
+        } catch (const std::exception &e) {
+            OH_FAIL("Unable to map snapshot file " << path << ": " << e.what());
+        }
+        data_ = static_cast<const char*>(region_->get_address());
+        std::size_t length = region_->get_size();
+
+        Header header;
+        OH_REQUIRE(length >= sizeof(Header)
+                   && std::memcmp(data_, magic, sizeof(magic)) == 0,
+                   "File " << path << " is not an ObjectHandler snapshot");
+        std::memcpy(&header, data_, sizeof(Header));
+        OH_REQUIRE(header.byteOrder == byteOrder,
+                   "Snapshot file " << path << " was written on a platform "
+                   "with a different byte order");
+        OH_REQUIRE(header.version == version,
+                   "Snapshot file " << path << " has format version "
+                   << header.version << ", expected " << version);
+        // bound each size by the length of the file before adding it to an
+        // offset, so that a corrupt file cannot make the sums overflow
+        OH_REQUIRE(header.fileSize == length
+                   && header.indexOffset == sizeof(Header)
+                   && header.count <= (length - sizeof(Header)) / sizeof(IndexEntry)
+                   && header.dataOffset ==
+                      header.indexOffset + header.count * sizeof(IndexEntry),
+                   "Snapshot file " << path << " is truncated or corrupt");
+
+        size_ = static_cast<std::size_t>(header.count);
+        indexOffset_ = header.indexOffset;
+
+        for (std::size_t n = 0; n < size_; ++n) {
+            IndexEntry record = entry(n);
+            OH_REQUIRE(record.idOffset >= header.dataOffset
+                       && record.idOffset <= length
+                       && record.idLength <= length - record.idOffset
+                       && record.valueObjectOffset == record.idOffset + record.idLength
+                       && record.valueObjectLength <= length - record.valueObjectOffset
+                       && record.processorOffset ==
+                          record.valueObjectOffset + record.valueObjectLength
+                       && record.processorLength <= length - record.processorOffset,
+                       "Snapshot file " << path << " is truncated or corrupt");
+        }
+    }
+
+    const uint32_t Snapshot::version;
+
+    Snapshot::~Snapshot() {}
+
+    Snapshot::IndexEntry Snapshot::entry(std::size_t i) const {
+        OH_REQUIRE(i < size_, "Invalid position " << i << " in snapshot " << path_);
+        IndexEntry ret;
+        std::memcpy(&ret, data_ + indexOffset_ + i * sizeof(IndexEntry), sizeof(IndexEntry));
+        return ret;
+    }
+
+    string Snapshot::objectID(std::size_t i) const {
+        IndexEntry record = entry(i);
+        return string(data_ + record.idOffset, static_cast<std::size_t>(record.idLength));
+    }
+
+    string Snapshot::processorName(std::size_t i) const {
+        IndexEntry record = entry(i);
+        return string(data_ + record.processorOffset,
+                      static_cast<std::size_t>(record.processorLength));
+    }
+
+    bool Snapshot::permanent(std::size_t i) const {
+        return entry(i).permanent != 0;
+    }
+
+    shared_ptr<ValueObject> Snapshot::valueObject(std::size_t i) const {
+        IndexEntry record = entry(i);
+        MemoryBuffer buffer(data_ + record.valueObjectOffset,
+                            static_cast<std::size_t>(record.valueObjectLength));
+        std::istream in(&buffer);
+        std::vector<shared_ptr<ValueObject> > valueObjects;
+        try {
+            SerializationFactory::instance().readValueObjects(
+                in, valueObjects, SerializationFactory::Binary);
+        } catch (const std::exception &e) {
+            OH_FAIL("Error deserializing object '" << objectID(i)
+                    << "' from snapshot " << path_ << ": " << e.what());
+        }
+        OH_REQUIRE(valueObjects.size() == 1 && valueObjects[0],
+                   "Error deserializing object '" << objectID(i)
+                   << "' from snapshot " << path_);
+        return valueObjects[0];
+    }
+
+}
+
@@ -0,0 +1,127 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Class Snapshot - Memory-mapped image of the ValueObjects in the Repository
+*/
+
+#ifndef oh_snapshot_hpp
+#define oh_snapshot_hpp
+
+#include <oh/valueobject.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/cstdint.hpp>
+#include <string>
+#include <vector>
+
+namespace boost { namespace interprocess {
+    class file_mapping;
+    class mapped_region;
+} }
+
+namespace ObjectHandler {
+
+    //! Memory-mapped image of the ValueObjects in the Repository.
+    /*! A snapshot file consists of a header, an index holding one entry per
+        Object, and a data section holding each object ID followed by its
+        ValueObject in a binary archive of its own.  Entries appear in
+        dependency order, each after all of its precedents, so that the
+        Objects may be recreated in a single pass.
+
+        The index also records the name of the Processor of each
+        ValueObject and its Permanent property, so that an Object may be
+        stored in the Repository, with its creation deferred, without
+        deserializing its ValueObject.
+
+        Opening a snapshot maps the file into memory and validates the
+        header and the index.  Object IDs and ValueObjects are then read
+        directly from the mapping, one at a time, as they are requested.
+        The mapping lasts as long as the Snapshot, which may be shared by
+        the ObjectWrappers of Objects whose ValueObjects have not yet been
+        read, see Repository::restore().
+
+        The file is specific to the platform and the version of boost with
+        which it was written.  The header records the format version and
+        the byte order, and these are checked when the file is opened.
+
+        This class is not exported across DLL boundaries, it is used only
+        by the Repository.
+    */
+    class Snapshot {
+    public:
+        //! An Object to be written to a snapshot.
+        struct Item {
+            std::string objectID;
+            boost::shared_ptr<ValueObject> valueObject;
+        };
+
+        //! Write the given Items, in the given order, to the given file.
+        /*! The caller is responsible for placing each Item after its precedents.
+            The file is written under a temporary name and then renamed over
+            the target, so that processes which have mapped the previous
+            version are not disturbed.  On Windows a file which is mapped
+            cannot be replaced, and writing it fails until it is unmapped.
+        */
+        static void write(const std::string &path,
+                          const std::vector<Item> &items,
+                          bool forceOverwrite);
+
+        //! \name Structors
+        //@{
+        //! Map the given snapshot file into memory.
+        explicit Snapshot(const std::string &path);
+        ~Snapshot();
+        //@}
+
+        //! \name Inspectors
+        //@{
+        //! Count of the Objects in the snapshot.
+        std::size_t size() const { return size_; }
+        //! ID of the Object at the given position.
+        std::string objectID(std::size_t i) const;
+        //! Name of the Processor of the ValueObject at the given position.
+        std::string processorName(std::size_t i) const;
+        //! Value of the Permanent property of the ValueObject at the given position.
+        bool permanent(std::size_t i) const;
+        //! Deserialize the ValueObject of the Object at the given position.
+        boost::shared_ptr<ValueObject> valueObject(std::size_t i) const;
+        //@}
+
+        //! The version of the file format written by this class.
+        static const boost::uint32_t version = 2;
+
+    private:
+        struct Header;
+        struct IndexEntry;
+        IndexEntry entry(std::size_t i) const;
+
+        std::string path_;
+        boost::scoped_ptr<boost::interprocess::file_mapping> file_;
+        boost::scoped_ptr<boost::interprocess::mapped_region> region_;
+        const char *data_;
+        std::size_t size_;
+        boost::uint64_t indexOffset_;
+
+        Snapshot(const Snapshot&);
+        Snapshot& operator=(const Snapshot&);
+    };
+
+}
+
+#endif
+
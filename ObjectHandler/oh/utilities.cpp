@@ -28,6 +28,7 @@
 #include <oh/logger.hpp>
 #endif
 #include <oh/repository.hpp>
+#include <oh/asynclog.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <sstream>
@@ -54,9 +55,10 @@ namespace ObjectHandler {
     }
 
     std::string logSetFile(const std::string &logFileName,
-                           const int &logLevel) {
+                           const int &logLevel,
+                           const bool &asynchronous) {
 #ifdef OH_INCLUDE_LOG4CXX
-        Logger::instance().setFile(logFileName, logLevel);
+        Logger::instance().setFile(logFileName, logLevel, asynchronous);
         return logFileName;
 #else
         return std::string();
@@ -101,6 +103,53 @@ namespace ObjectHandler {
 #endif
     }
 
+    void logSetAsyncOptions(const long &queueSize,
+                            const long &batchSize,
+                            const long &flushInterval,
+                            const bool &dropWhenFull) {
+        AsyncLog::Options options;
+        options.queueSize = queueSize;
+        options.batchSize = batchSize;
+        options.flushInterval = flushInterval;
+        options.dropWhenFull = dropWhenFull;
+        AsyncLog::validate(options);
+#ifdef OH_INCLUDE_LOG4CXX
+        Logger::instance().setAsyncOptions(options);
+#endif
+    }
+
+    std::vector<std::vector<property_t> > logAsyncStatistics() {
+#ifdef OH_INCLUDE_LOG4CXX
+        AsyncLog::Statistics s = Logger::instance().asyncStatistics();
+#else
+        AsyncLog::Statistics s;
+#endif
+        const char *names[] = {
+            "Queued", "Written", "Dropped", "Waits", "Batches", "HighWater" };
+        const boost::uint64_t values[] = {
+            s.queued, s.written, s.dropped, s.waits, s.batches, s.highWater };
+        std::vector<std::vector<property_t> > ret;
+        for (std::size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+            std::vector<property_t> row;
+            row.push_back(std::string(names[i]));
+            row.push_back(static_cast<long>(values[i]));
+            ret.push_back(row);
+        }
+        return ret;
+    }
+
+    void logFlush() {
+#ifdef OH_INCLUDE_LOG4CXX
+        Logger::instance().flush();
+#endif
+    }
+
+    void logStopAsync() {
+#ifdef OH_INCLUDE_LOG4CXX
+        Logger::instance().stopAsync();
+#endif
+    }
+
     void logObject(const std::string &objectID) {
         std::ostringstream msg;
         Repository::instance().dumpObject(objectID, msg);
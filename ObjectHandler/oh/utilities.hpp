@@ -29,6 +29,7 @@
 
 #include <oh/ohdefines.hpp>
 #include <oh/exception.hpp>
+#include <oh/property.hpp>
 #include <string>
 #include <vector>
 #include <boost/lexical_cast.hpp>
@@ -54,7 +55,8 @@ namespace ObjectHandler {
     /*! Wraps function Logger::instance().logSetFile().
     */
     std::string logSetFile(const std::string &logFileName,
-                           const int &logLevel = 4);
+                           const int &logLevel = 4,
+                           const bool &asynchronous = false);
     //! Write a message to the log file.
     /*! Wraps function Logger::instance().logMessage().
     */
@@ -75,6 +77,26 @@ namespace ObjectHandler {
     */
     void logSetConsole(const int &console = 0,
                        const int &logLevel = 4);
+    //! Configure asynchronous logging.
+    /*! Wraps function Logger::instance().setAsyncOptions().
+    */
+    void logSetAsyncOptions(const long &queueSize = 4096,
+                            const long &batchSize = 64,
+                            const long &flushInterval = 500,
+                            const bool &dropWhenFull = false);
+    //! Return the counters of asynchronous logging as a table of names and values.
+    /*! Wraps function Logger::instance().asyncStatistics().
+    */
+    std::vector<std::vector<property_t> > logAsyncStatistics();
+    //! Wait until all queued log messages have been written.
+    /*! Wraps function Logger::instance().flush().
+    */
+    void logFlush();
+    //! Write the queued log messages and stop the background thread.
+    /*! Wraps function Logger::instance().stopAsync().  Called by
+        xlAutoClose() before the addin is unloaded.
+    */
+    void logStopAsync();
     //! Write Object with given ID to log file.
     /*! Writes a warning message to the log file
         if no Object is found with the given ID.
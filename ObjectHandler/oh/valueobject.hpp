@@ -33,6 +33,7 @@
 #include <algorithm>
 #include <oh/property.hpp>
 #include <oh/utilities.hpp>
+#include <oh/iless.hpp>
 #include <boost/serialization/access.hpp>
 
 namespace ObjectHandler {
@@ -94,6 +95,16 @@ namespace ObjectHandler {
         void setProperty(const std::string& name, const property_t& value);
         //! Set the value of the given system property.
         virtual void setSystemProperty(const std::string& name, const property_t& value) = 0;
+        //! Retrieve the value of a system property given its position.
+        /*! Position 0 is the Object ID, position 1 is the class name, and the
+            remaining system properties follow in the order in which they are
+            returned by getPropertyNamesVector().  Classes generated by gensrc
+            override this function with a switch on the position, so that the
+            property is retrieved without any string handling.
+        */
+        virtual property_t getSystemProperty(std::size_t index) const;
+        //! Set the value of a system property given its position.
+        virtual void setSystemProperty(std::size_t index, const property_t& value);
         //@}
 
         //! \name Inspectors
@@ -131,6 +142,10 @@ namespace ObjectHandler {
         void processVariant(const std::vector<property_t>& vecVariantID);
         //! Extract the Object IDs from the property_t matrix and pass them to processPrecedentID()
         void processVariant(const std::vector<std::vector<property_t> >& vecVariantIDs);
+        //! Extract the Object IDs from a shared property_t vector
+        void processVariant(const SharedValue<std::vector<property_t> >& vecVariantID);
+        //! Extract the Object IDs from a shared property_t matrix
+        void processVariant(const SharedValue<std::vector<std::vector<property_t> > >& vecVariantIDs);
         //@}
     protected:
         //! ID of the Object associated with this ValueObject.
@@ -172,6 +187,14 @@ namespace ObjectHandler {
         }
     }
 
+    inline void ValueObject::processVariant(const SharedValue<std::vector<property_t> >& vecVariantID){
+        processVariant(vecVariantID.get());
+    }
+
+    inline void ValueObject::processVariant(const SharedValue<std::vector<std::vector<property_t> > >& vecVariantIDs){
+        processVariant(vecVariantIDs.get());
+    }
+
     inline std::set<std::string> ValueObject::getPropertyNames() const {
         std::set<std::string> ret(getSystemPropertyNames());
         for(std::map<std::string, property_t>::const_iterator i
@@ -187,6 +210,31 @@ namespace ObjectHandler {
             return getSystemProperty(name);
     }
 
+    inline property_t ValueObject::getSystemProperty(std::size_t index) const {
+        if (index == 0)
+            return objectId_;
+        else if (index == 1)
+            return className_;
+        std::vector<std::string> names = getPropertyNamesVector();
+        OH_REQUIRE(index - 2 < names.size(),
+            "Error: attempt to retrieve non-existent Property at position " << index);
+        return getSystemProperty(names[index - 2]);
+    }
+
+    inline void ValueObject::setSystemProperty(std::size_t index, const property_t& value) {
+        if (index == 0) {
+            objectId_ = boost::get<std::string>(value);
+            return;
+        } else if (index == 1) {
+            className_ = boost::get<std::string>(value);
+            return;
+        }
+        std::vector<std::string> names = getPropertyNamesVector();
+        OH_REQUIRE(index - 2 < names.size(),
+            "Error: attempt to set non-existent Property at position " << index);
+        setSystemProperty(names[index - 2], value);
+    }
+
     inline bool ValueObject::hasProperty(const std::string& name) const {
         return userProperties.find(name) != userProperties.end();
     }
@@ -25,6 +25,7 @@
 #define ohxl_conversions_matrixtooper_hpp
 
 #include <ohxl/conversions/scalartooper.hpp>
+#include <oh/property.hpp>
 #include <vector>
 
 namespace ObjectHandler {
@@ -59,6 +60,25 @@ namespace ObjectHandler {
 
     }
 
+    //! Convert a dense_matrix to an Excel OPER.
+    inline void matrixToOper(const dense_matrix &m, OPER &xMatrix) {
+
+        if (m.rows() == 0 || m.columns() == 0) {
+            xMatrix.xltype = xltypeErr;
+            xMatrix.val.err = xlerrNA;
+            return;
+        }
+
+        xMatrix.val.array.rows = m.rows();
+        xMatrix.val.array.columns = m.columns();
+        xMatrix.val.array.lparray = new OPER[m.rows() * m.columns()];
+        xMatrix.xltype = xltypeMulti | xlbitDLLFree;
+
+        const std::vector<double> &values = m.values();
+        for (unsigned int i=0; i<values.size(); ++i)
+            scalarToOper(values[i], xMatrix.val.array.lparray[i], false);
+    }
+
 }
 
 #endif
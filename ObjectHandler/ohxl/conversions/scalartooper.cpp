@@ -93,6 +93,16 @@ namespace ObjectHandler {
                 scalarToOper("<MATRIX>", oper_);
         }
 
+        template<typename T>
+        void operator()(const SharedValue<T>& v) { (*this)(v.get()); }
+
+        void operator()(const dense_matrix& m) {
+            if(m_expand)
+                matrixToOper(m, oper_);
+            else
+                scalarToOper("<MATRIX>", oper_);
+        }
+
     private:
         OPER &oper_;
         bool m_expand;
@@ -26,6 +26,7 @@
 
 #include <ohxl/objecthandlerxl.hpp>
 #include <ohxl/utilities/xlutilities.hpp>
+#include <oh/parallelloop.hpp>
 
 // The max number of failed loop iterations to be logged.  This is for
 // a 0-based array and will be displayed to user as ERROR_LIMIT+1
@@ -33,6 +34,27 @@
 
 namespace ObjectHandler {
 
+    //! Record the error from a failed loop iteration, up to ERROR_LIMIT+1 errors.
+    inline void logLoopError(std::ostringstream &err, int &errorCount,
+                             int i, const char *message) {
+        if (errorCount > ERROR_LIMIT) {
+            // Limit exceeded.  Take no action.  For performance reasons we test
+            // this case first since it's most common on big loop w/many errors
+            ;
+        } else if (errorCount < ERROR_LIMIT) {
+            err << std::endl << std::endl 
+                << "iteration #" << i << " - " << message;
+            errorCount++;
+        } else { // errorCount == ERROR_LIMIT
+            err << std::endl << std::endl 
+                << "iteration #" << i << " - " << message
+                << std::endl << std::endl 
+                << "Count of failed iterations in looping function hit "
+                << "limit of " << ERROR_LIMIT + 1 << " - logging discontinued";
+            errorCount++;
+        }
+    }
+
     //! Execute one iteration of the loop function
     template<class LoopFunction, class InputType, class OutputType>
     struct LoopIteration {
@@ -114,23 +136,7 @@ namespace ObjectHandler {
             } catch (const std::exception &e) {
                 xOut.val.array.lparray[i].xltype = xltypeErr;
                 xOut.val.array.lparray[i].val.err = xlerrNum;
-
-                if (errorCount > ERROR_LIMIT) {
-                    // Limit exceeded.  Take no action.  For performance reasons we test
-                    // this case first since it's most common on big loop w/many errors
-                    ;
-                } else if (errorCount < ERROR_LIMIT) {
-                    err << std::endl << std::endl 
-                        << "iteration #" << i << " - " << e.what();
-                    errorCount++;
-                } else { // errorCount == ERROR_LIMIT
-                    err << std::endl << std::endl 
-                        << "iteration #" << i << " - " << e.what()
-                        << std::endl << std::endl 
-                        << "Count of failed iterations in looping function hit "
-                        << "limit of " << ERROR_LIMIT + 1 << " - logging discontinued";
-                    errorCount++;
-                }
+                logLoopError(err, errorCount, i, e.what());
             }
         }
 
@@ -146,6 +152,99 @@ namespace ObjectHandler {
 
     }
 
+    //! Invoke the contained function once for each item in the input vector, in parallel.
+    /*! As loop(), but the iterations are distributed over a pool of threads,
+        see evaluateLoop().  Only the loop function itself is invoked on the
+        pool.  The conversion of the inputs and of the results, which may
+        call back into Excel, takes place on the calling thread, before and
+        after the iterations respectively.  Errors are logged in the order
+        of the input, as for loop().
+
+        Generated for looping functions marked threadSafe in the gensrc
+        metadata.  Without OH_ENABLE_THREAD_SAFE_REPOSITORY the iterations
+        are executed in order on the calling thread.
+    */
+    template<class LoopFunction, class InputType, class OutputType>
+    void parallelLoop(
+              const boost::shared_ptr<FunctionCall> &functionCall,
+              LoopFunction &loopFunction, 
+              OPER *xIn, 
+              XLOPER &xOut) {
+
+        // A scalar input is processed as by loop().
+        if (xIn->xltype == xltypeNum
+        ||  xIn->xltype == xltypeBool
+        ||  xIn->xltype == xltypeStr) {
+            loop<LoopFunction, InputType, OutputType>(
+                functionCall, loopFunction, xIn, xOut);
+            return;
+        }
+
+        OPER xTemp, *xMulti;
+        bool excelToFree = false;
+        bool xllToFree = false;
+
+        if (xIn->xltype == xltypeMulti) {
+            xMulti = xIn;
+        } else if (isList(xIn)) {
+            splitOper(xIn, &xTemp);
+            xMulti = &xTemp;
+            xllToFree = true;
+        } else {
+            Excel(xlCoerce, &xTemp, 2, xIn, TempInt(xltypeMulti));
+            xMulti = &xTemp;
+            excelToFree = true;
+        }
+
+        int numCells = xMulti->val.array.rows * xMulti->val.array.columns;
+        std::vector<InputType> inputs(numCells);
+        std::vector<LoopResult<OutputType> > results(numCells);
+        for (int i=0; i<numCells; ++i) {
+            try {
+                inputs[i] = ObjectHandler::convert2<InputType>(
+                    ConvertOper(xMulti->val.array.lparray[i]));
+            } catch (const std::exception &e) {
+                results[i].failed = true;
+                results[i].error = e.what();
+            }
+        }
+
+        xOut.val.array.rows = xMulti->val.array.rows;
+        xOut.val.array.columns = xMulti->val.array.columns;
+
+        // Free memory
+        if (excelToFree) {
+            Excel(xlFree, 0, 1, &xTemp);
+        } else if (xllToFree) {
+            freeOper(&xTemp);
+        }
+
+        evaluateLoop(loopFunction, inputs, results);
+
+        xOut.val.array.lparray = new XLOPER[numCells]; 
+        xOut.xltype = xltypeMulti | xlbitDLLFree;
+
+        int errorCount = 0;
+        std::ostringstream err;
+        for (int i=0; i<numCells; ++i) {
+            if (!results[i].failed) {
+                try {
+                    scalarToOper(results[i].value, xOut.val.array.lparray[i], false);
+                    continue;
+                } catch (const std::exception &e) {
+                    results[i].error = e.what();
+                }
+            }
+            xOut.val.array.lparray[i].xltype = xltypeErr;
+            xOut.val.array.lparray[i].val.err = xlerrNum;
+            logLoopError(err, errorCount, i, results[i].error.c_str());
+        }
+
+        if (errorCount)
+            RepositoryXL::instance().logError(err.str(), functionCall);
+
+    }
+
 }
 
 #endif
@@ -32,6 +32,23 @@ namespace ObjectHandler {
         idFull_ = callingRange_->updateID(id_);
     };
 
+    ObjectWrapperXL::ObjectWrapperXL(
+        const std::string &id,
+        const boost::shared_ptr<ValueObject> &valueObject,
+        const boost::shared_ptr<CallingRange> &callingRange)
+            : id_(id), ObjectWrapper(valueObject), callingRange_(callingRange) {
+        idFull_ = callingRange_->updateID(id_);
+    };
+
+    ObjectWrapperXL::ObjectWrapperXL(
+        const std::string &id,
+        const ValueObjectLoader &loader,
+        bool permanent,
+        const boost::shared_ptr<CallingRange> &callingRange)
+            : id_(id), ObjectWrapper(loader, permanent), callingRange_(callingRange) {
+        idFull_ = callingRange_->updateID(id_);
+    };
+
     ObjectWrapperXL::~ObjectWrapperXL() {
         callingRange_->unregisterObject(id_);
     }
@@ -50,6 +67,16 @@ namespace ObjectHandler {
         idFull_ = callingRange_->updateID(id_);
     }
 
+    void ObjectWrapperXL::defer(const boost::shared_ptr<ValueObject> &valueObject) {
+        ObjectWrapper::defer(valueObject);
+        idFull_ = callingRange_->updateID(id_);
+    }
+
+    void ObjectWrapperXL::defer(const ValueObjectLoader &loader, bool permanent) {
+        ObjectWrapper::defer(loader, permanent);
+        idFull_ = callingRange_->updateID(id_);
+    }
+
     std::string ObjectWrapperXL::callerKey() const {
         return callingRange_->key();
     }
@@ -50,6 +50,17 @@ namespace ObjectHandler {
             const std::string &id,
             const boost::shared_ptr<Object> &object,
             const boost::shared_ptr<CallingRange> &callingRange);
+        //! Constructor - accepts ID and the ValueObject of an Object whose creation is deferred.
+        ObjectWrapperXL(
+            const std::string &id,
+            const boost::shared_ptr<ValueObject> &valueObject,
+            const boost::shared_ptr<CallingRange> &callingRange);
+        //! Constructor - as above, the ValueObject is read from the loader when it is first needed.
+        ObjectWrapperXL(
+            const std::string &id,
+            const ValueObjectLoader &loader,
+            bool permanent,
+            const boost::shared_ptr<CallingRange> &callingRange);
         //! Destructor - de-register this object with its CallingRange object.
         virtual ~ObjectWrapperXL();
         //@}
@@ -66,9 +77,6 @@ namespace ObjectHandler {
         //! Get the address of the calling cell.
         /*! Returns the string "VBA" if this object was constructed by VBA code. */
         std::string callerAddress() const;
-        //! Query the value of the "permanent" flag.
-        /*! The request is forwarded to the Object contained by this ObjectWrapperXL. */
-        const virtual bool &permanent() const { return object_->permanent(); }
         //! Calling Range
         boost::shared_ptr<CallingRange>& getCallingRange(){ return callingRange_;}
         //@}
@@ -86,6 +94,10 @@ namespace ObjectHandler {
         //@{
         //! Replace the contained Object with the one provided.
         void reset(boost::shared_ptr<Object> object);
+        //! Discard the contained Object, deferring creation of its replacement.
+        void defer(const boost::shared_ptr<ValueObject> &valueObject);
+        //! As above, the ValueObject of the replacement is read from the loader.
+        void defer(const ValueObjectLoader &loader, bool permanent);
         //! Associate this object with a different calling range.
         void resetCaller(boost::shared_ptr<CallingRange> callingRange);
         //@}
@@ -78,6 +78,9 @@ DLLEXPORT int xlAutoClose() {
         unregisterOhFunctions(xDll);
         // Clear the state of the Repository.
         ObjectHandler::RepositoryXL::instance().clear();
+        // Write any queued log messages and stop the logging thread, which
+        // cannot be joined once the DLL begins to unload.
+        ObjectHandler::logStopAsync();
         // Release the DLL name.
         Excel(xlFree, 0, 1, &xDll);
 
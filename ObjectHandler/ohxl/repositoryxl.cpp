@@ -21,12 +21,19 @@
 
 #include <oh/exception.hpp>
 #include <oh/utilities.hpp>
+#include <oh/objectstore.hpp>
 #include <ohxl/repositoryxl.hpp>
 #include <ohxl/functioncall.hpp>
 #include <ohxl/callingrange.hpp>
 #include <ohxl/rangereference.hpp>
 #include <ohxl/convert_oper.hpp>
 #include <boost/algorithm/string.hpp>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#define OH_REPOSITORY_WRITE_LOCK \
+    boost::recursive_mutex::scoped_lock writerLock(writerMutex());
+#else
+#define OH_REPOSITORY_WRITE_LOCK
+#endif
 /* Use BOOST_MSVC instead of _MSC_VER since some other vendors (Metrowerks,
 for example) also #define _MSC_VER
 */
@@ -48,8 +55,8 @@ namespace ObjectHandler {
     // Below are three structures which must be declared as static variables rather than
     // class members because std::map cannot be exported across DLL boundaries.
 
-    // The object map declared in the cpp file for the base Repository class.
-    extern Repository::ObjectMap objectMap_;
+    // The object store declared in the cpp file for the base Repository class.
+    extern ObjectStore objectStore_;
 
     // A map to associate error messages with Excel range addresses.
     typedef std::map<string, shared_ptr<RangeReference> > ErrorMessageMap;
@@ -69,7 +76,7 @@ namespace ObjectHandler {
     }
 
     void RepositoryXL::clear() {
-        objectMap_.clear();
+        objectStore_.clear();
         errorMessageMap_.clear();
         callingRanges_.clear();
     }
@@ -81,19 +88,20 @@ namespace ObjectHandler {
         boost::shared_ptr<ValueObject> valueObject) {
 
             shared_ptr<CallingRange> callingRange = getCallingRange();
+            OH_REPOSITORY_WRITE_LOCK
             string objectID = callingRange->initializeID(objectIDRaw);
             if (objectIDRaw.empty() && valueObject)
                 valueObject->setProperty("OBJECTID", objectID);
 
             shared_ptr<ObjectWrapperXL> objectWrapperXL;
-            ObjectMap::const_iterator result = objectMap_.find(objectID);
-            if (result == objectMap_.end()) {
+            shared_ptr<ObjectWrapper> result = objectStore_.find(objectID);
+            if (!result) {
                 objectWrapperXL = shared_ptr<ObjectWrapperXL> (
                     new ObjectWrapperXL(objectID, object, callingRange));
-                objectMap_[objectID] = objectWrapperXL;
+                objectStore_.insert(objectID, objectWrapperXL);
                 callingRange->registerObject(objectID, objectWrapperXL);
             } else {
-                objectWrapperXL = boost::static_pointer_cast<ObjectWrapperXL>(result->second);
+                objectWrapperXL = boost::static_pointer_cast<ObjectWrapperXL>(result);
                 if (objectWrapperXL->callerKey() != callingRange->key()) {
                     OH_REQUIRE(overwrite, "Cannot create object with ID '" << objectID <<
                         "' in cell " << callingRange->addressString() <<
@@ -109,6 +117,71 @@ namespace ObjectHandler {
             return objectWrapperXL->idFull();
     }
 
+    string RepositoryXL::deferObject(
+        const string &objectIDRaw,
+        const shared_ptr<ValueObject> &valueObject,
+        bool overwrite) {
+
+            shared_ptr<CallingRange> callingRange = getCallingRange();
+            OH_REPOSITORY_WRITE_LOCK
+            string objectID = callingRange->initializeID(objectIDRaw);
+
+            shared_ptr<ObjectWrapperXL> objectWrapperXL;
+            shared_ptr<ObjectWrapper> result = objectStore_.find(objectID);
+            if (!result) {
+                objectWrapperXL = shared_ptr<ObjectWrapperXL> (
+                    new ObjectWrapperXL(objectID, valueObject, callingRange));
+                objectStore_.insert(objectID, objectWrapperXL);
+                callingRange->registerObject(objectID, objectWrapperXL);
+            } else {
+                objectWrapperXL = boost::static_pointer_cast<ObjectWrapperXL>(result);
+                if (objectWrapperXL->callerKey() != callingRange->key()) {
+                    OH_REQUIRE(overwrite, "Cannot create object with ID '" << objectID <<
+                        "' in cell " << callingRange->addressString() <<
+                        " because an object with that ID already resides in cell " <<
+                        objectWrapperXL->callerAddress());
+                    objectWrapperXL->resetCaller(callingRange);
+                    callingRange->registerObject(objectID, objectWrapperXL);
+                }
+                objectWrapperXL->defer(valueObject);
+            }
+
+            return objectWrapperXL->idFull();
+    }
+
+    string RepositoryXL::deferObject(
+        const string &objectIDRaw,
+        const ValueObjectLoader &loader,
+        bool permanent,
+        bool overwrite) {
+
+            shared_ptr<CallingRange> callingRange = getCallingRange();
+            OH_REPOSITORY_WRITE_LOCK
+            string objectID = callingRange->initializeID(objectIDRaw);
+
+            shared_ptr<ObjectWrapperXL> objectWrapperXL;
+            shared_ptr<ObjectWrapper> result = objectStore_.find(objectID);
+            if (!result) {
+                objectWrapperXL = shared_ptr<ObjectWrapperXL> (
+                    new ObjectWrapperXL(objectID, loader, permanent, callingRange));
+                objectStore_.insert(objectID, objectWrapperXL);
+                callingRange->registerObject(objectID, objectWrapperXL);
+            } else {
+                objectWrapperXL = boost::static_pointer_cast<ObjectWrapperXL>(result);
+                if (objectWrapperXL->callerKey() != callingRange->key()) {
+                    OH_REQUIRE(overwrite, "Cannot create object with ID '" << objectID <<
+                        "' in cell " << callingRange->addressString() <<
+                        " because an object with that ID already resides in cell " <<
+                        objectWrapperXL->callerAddress());
+                    objectWrapperXL->resetCaller(callingRange);
+                    callingRange->registerObject(objectID, objectWrapperXL);
+                }
+                objectWrapperXL->defer(loader, permanent);
+            }
+
+            return objectWrapperXL->idFull();
+    }
+
     void RepositoryXL::setError(
         const string &message,
         const shared_ptr<FunctionCall> &functionCall) {
@@ -293,10 +366,10 @@ namespace ObjectHandler {
         for (std::vector<string>::const_iterator i = objectList.begin();
             i != objectList.end(); ++i) {
                 shared_ptr<ObjectWrapperXL> objectWrapperXL;
-                ObjectMap::const_iterator result = objectMap_.find(CallingRange::getStub(*i));
-                if (result != objectMap_.end()) {
+                shared_ptr<ObjectWrapper> result = objectStore_.find(CallingRange::getStub(*i));
+                if (result) {
 
-                    objectWrapperXL = boost::static_pointer_cast<ObjectWrapperXL>(result->second);
+                    objectWrapperXL = boost::static_pointer_cast<ObjectWrapperXL>(result);
 
                     ret.push_back(!objectWrapperXL->getCallingRange()->valid());
                 }
@@ -316,10 +389,10 @@ namespace ObjectHandler {
             i != objectList.end(); ++i) {
 
                 shared_ptr<ObjectWrapperXL> objectWrapperXL;
-                ObjectMap::const_iterator result = objectMap_.find(CallingRange::getStub(*i));
-                if (result != objectMap_.end()) {
+                shared_ptr<ObjectWrapper> result = objectStore_.find(CallingRange::getStub(*i));
+                if (result) {
 
-                    objectWrapperXL = boost::static_pointer_cast<ObjectWrapperXL>(result->second);
+                    objectWrapperXL = boost::static_pointer_cast<ObjectWrapperXL>(result);
 
                     ret.push_back(objectWrapperXL->getCallingRange()->getUpdateCount());
                 }
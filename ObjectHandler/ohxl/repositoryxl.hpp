@@ -63,6 +63,18 @@ namespace ObjectHandler {
                                         const boost::shared_ptr<Object> &obj,
                                         bool overwrite = false,
                                         boost::shared_ptr<ValueObject> valueObject = boost::shared_ptr<ValueObject>());
+        //! Wrapper for the deferObject function in the base class.
+        /*! As storeObject(), but the ObjectWrapperXL holds only the ValueObject
+            until the Object is first retrieved.
+        */
+        virtual std::string deferObject(const std::string &objectID,
+                                        const boost::shared_ptr<ValueObject> &valueObject,
+                                        bool overwrite = false);
+        //! As above, the ValueObject is read from the loader when it is first needed.
+        virtual std::string deferObject(const std::string &objectID,
+                                        const ValueObjectLoader &loader,
+                                        bool permanent,
+                                        bool overwrite = false);
         //@}
 
         //! \name Error Messages
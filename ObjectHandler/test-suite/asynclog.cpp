@@ -0,0 +1,225 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <oh/config.hpp>
+#endif
+
+#include "asynclog.hpp"
+#include <oh/asynclog.hpp>
+#include <oh/exception.hpp>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#endif
+#include <vector>
+
+using namespace ObjectHandler;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+    // A sink which collects the messages written to it.
+    class Collector {
+      public:
+        explicit Collector(long delay = 0) : delay_(delay) {}
+        void write(int, const std::string &message) {
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+            if (delay_)
+                boost::this_thread::sleep(boost::posix_time::milliseconds(delay_));
+            boost::lock_guard<boost::mutex> lock(mutex_);
+#endif
+            messages_.push_back(message);
+        }
+        std::vector<std::string> messages() {
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+            boost::lock_guard<boost::mutex> lock(mutex_);
+#endif
+            return messages_;
+        }
+      private:
+        long delay_;
+        std::vector<std::string> messages_;
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        boost::mutex mutex_;
+#endif
+    };
+
+    AsyncLog::Sink sink(Collector& collector) {
+        return boost::bind(&Collector::write, &collector, _1, _2);
+    }
+
+}
+
+
+void AsyncLogTest::testFlush() {
+
+    BOOST_TEST_MESSAGE("Testing that flush writes every queued message in order...");
+
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    Collector collector;
+    AsyncLog::Options options;
+    options.queueSize = 16;
+    options.batchSize = 4;
+    options.flushInterval = 10000;
+    AsyncLog log(sink(collector), options);
+
+    const int n = 1000;
+    for (int i=0; i<n; ++i)
+        log.push(4, boost::lexical_cast<std::string>(i));
+    log.flush();
+
+    std::vector<std::string> messages = collector.messages();
+    BOOST_REQUIRE_EQUAL(messages.size(), std::size_t(n));
+    for (int i=0; i<n; ++i)
+        BOOST_CHECK_EQUAL(messages[i], boost::lexical_cast<std::string>(i));
+
+    AsyncLog::Statistics statistics = log.statistics();
+    BOOST_CHECK_EQUAL(statistics.queued, boost::uint64_t(n));
+    BOOST_CHECK_EQUAL(statistics.written, boost::uint64_t(n));
+    BOOST_CHECK_EQUAL(statistics.dropped, boost::uint64_t(0));
+    BOOST_CHECK(statistics.highWater <= boost::uint64_t(options.queueSize));
+
+    // flushing an empty queue returns at once
+    log.flush();
+    BOOST_CHECK_EQUAL(collector.messages().size(), std::size_t(n));
+#endif
+}
+
+void AsyncLogTest::testFlushInterval() {
+
+    BOOST_TEST_MESSAGE("Testing that a partial batch is written after the flush interval...");
+
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    Collector collector;
+    AsyncLog::Options options;
+    options.batchSize = 64;
+    options.flushInterval = 20;
+    AsyncLog log(sink(collector), options);
+
+    log.push(4, "message");
+    // fewer than batchSize messages are written once the interval has
+    // passed, without a call to flush()
+    for (int i=0; i<200 && collector.messages().empty(); ++i)
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    BOOST_CHECK_EQUAL(collector.messages().size(), std::size_t(1));
+#endif
+}
+
+void AsyncLogTest::testDestructorFlush() {
+
+    BOOST_TEST_MESSAGE("Testing that the destructor writes the remaining messages...");
+
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    Collector collector;
+    {
+        AsyncLog::Options options;
+        options.batchSize = 64;
+        options.flushInterval = 10000;
+        AsyncLog log(sink(collector), options);
+        for (int i=0; i<10; ++i)
+            log.push(4, "message");
+        log.push(4, "last");
+    }
+    std::vector<std::string> messages = collector.messages();
+    BOOST_REQUIRE_EQUAL(messages.size(), std::size_t(11));
+    BOOST_CHECK_EQUAL(messages.back(), std::string("last"));
+#endif
+}
+
+void AsyncLogTest::testStop() {
+
+    BOOST_TEST_MESSAGE("Testing that messages pushed after stop are written at once...");
+
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    Collector collector;
+    AsyncLog::Options options;
+    options.batchSize = 64;
+    options.flushInterval = 10000;
+    AsyncLog log(sink(collector), options);
+    for (int i=0; i<10; ++i)
+        log.push(4, "message");
+    log.stop();
+    BOOST_CHECK_EQUAL(collector.messages().size(), std::size_t(10));
+
+    // the background thread is gone, the calling thread writes the message
+    log.push(4, "last");
+    std::vector<std::string> messages = collector.messages();
+    BOOST_REQUIRE_EQUAL(messages.size(), std::size_t(11));
+    BOOST_CHECK_EQUAL(messages.back(), std::string("last"));
+
+    // stopping twice is harmless
+    log.stop();
+    log.flush();
+    BOOST_CHECK_EQUAL(collector.messages().size(), std::size_t(11));
+#endif
+}
+
+void AsyncLogTest::testDropWhenFull() {
+
+    BOOST_TEST_MESSAGE("Testing that messages are counted when dropped from a full queue...");
+
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    // a slow sink fills the queue
+    Collector collector(20);
+    AsyncLog::Options options;
+    options.queueSize = 8;
+    options.batchSize = 8;
+    options.flushInterval = 10;
+    options.dropWhenFull = true;
+    AsyncLog log(sink(collector), options);
+
+    const int n = 100;
+    for (int i=0; i<n; ++i)
+        log.push(4, "message");
+    log.flush();
+
+    AsyncLog::Statistics statistics = log.statistics();
+    BOOST_CHECK(statistics.dropped > 0);
+    BOOST_CHECK_EQUAL(statistics.queued + statistics.dropped, boost::uint64_t(n));
+    BOOST_CHECK_EQUAL(statistics.written, statistics.queued);
+    BOOST_CHECK_EQUAL(collector.messages().size(), std::size_t(statistics.written));
+#endif
+}
+
+void AsyncLogTest::testRequiresThreadSafety() {
+
+    BOOST_TEST_MESSAGE("Testing that AsyncLog requires a thread-safe build...");
+
+#ifndef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    Collector collector;
+    BOOST_CHECK_THROW(AsyncLog(sink(collector), AsyncLog::Options()), Exception);
+#endif
+}
+
+
+test_suite* AsyncLogTest::suite() {
+    test_suite* suite = BOOST_TEST_SUITE("Asynchronous log tests");
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    suite->add(BOOST_TEST_CASE(&AsyncLogTest::testFlush));
+    suite->add(BOOST_TEST_CASE(&AsyncLogTest::testFlushInterval));
+    suite->add(BOOST_TEST_CASE(&AsyncLogTest::testDestructorFlush));
+    suite->add(BOOST_TEST_CASE(&AsyncLogTest::testStop));
+    suite->add(BOOST_TEST_CASE(&AsyncLogTest::testDropWhenFull));
+#else
+    suite->add(BOOST_TEST_CASE(&AsyncLogTest::testRequiresThreadSafety));
+#endif
+    return suite;
+}
@@ -0,0 +1,188 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <oh/config.hpp>
+#endif
+
+#include "deferredcreation.hpp"
+#include "utilities.hpp"
+#include <oh/processor.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <sstream>
+
+using namespace ObjectHandler;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+    // Save two Ranges and a Group of them to an XML string.
+    std::string saveGroup() {
+        std::vector<std::string> list;
+        list.push_back("r1");
+        list.push_back("r2");
+        std::vector<boost::shared_ptr<Object> > objects;
+        objects.push_back(makeRange("r1", 1.0));
+        objects.push_back(makeRange("r2", 2.0));
+        objects.push_back(makeGroup("g", list));
+        std::ostringstream out;
+        SerializationFactory::instance().saveObjectStream(out, objects);
+        Repository::instance().deleteAllObjects(true);
+        return out.str();
+    }
+
+    std::vector<std::string> load(const std::string& xml, bool deferCreation) {
+        std::istringstream in(xml);
+        return SerializationFactory::instance().loadObjectStream(
+            in, false, SerializationFactory::Xml, deferCreation);
+    }
+
+    bool deferred(const std::string& objectID) {
+        std::ostringstream out;
+        Repository::instance().dumpObject(objectID, out);
+        return out.str().find("creation deferred") != std::string::npos;
+    }
+
+    // A ValueObject of a class for which no creator is registered.
+    class UnknownValueObject : public ValueObjects::ohRange {
+      public:
+        UnknownValueObject(const std::string& objectID)
+        : ValueObjects::ohRange(objectID, std::vector<std::vector<double> >(), false) {
+            className_ = "unknownClass";
+        }
+    };
+
+}
+
+
+void DeferredCreationTest::testDeferredLoad() {
+
+    BOOST_TEST_MESSAGE("Testing that loaded objects can be left uncreated...");
+
+    Repository repository;
+    ProcessorFactory processorFactory;
+    TestSerializationFactory factory;
+
+    std::string xml = saveGroup();
+    std::vector<std::string> loaded = load(xml, true);
+
+    BOOST_CHECK_EQUAL(loaded.size(), std::size_t(3));
+    BOOST_CHECK_EQUAL(repository.objectCount(), 3);
+    BOOST_CHECK(deferred("r1"));
+    BOOST_CHECK(deferred("r2"));
+    BOOST_CHECK(deferred("g"));
+
+    // inspectors which need only the ValueObject do not create the Object
+    std::vector<std::string> ids(1, "g");
+    BOOST_CHECK_EQUAL(repository.className(ids)[0], std::string("ohGroup"));
+    BOOST_CHECK(!repository.isPermanent(ids)[0]);
+    BOOST_CHECK(deferred("g"));
+
+    // without deferral the objects are created at load time
+    repository.deleteAllObjects(true);
+    load(xml, false);
+    BOOST_CHECK(!deferred("r1"));
+    BOOST_CHECK(!deferred("g"));
+}
+
+void DeferredCreationTest::testCreationOnRetrieval() {
+
+    BOOST_TEST_MESSAGE("Testing creation of deferred objects on first retrieval...");
+
+    Repository repository;
+    ProcessorFactory processorFactory;
+    TestSerializationFactory factory;
+
+    load(saveGroup(), true);
+
+    boost::shared_ptr<Range> range;
+    repository.retrieveObject(range, "r2");
+    BOOST_CHECK(!deferred("r2"));
+    BOOST_CHECK(deferred("r1"));
+    BOOST_CHECK(deferred("g"));
+
+    // the object is registered with its precedents once it is created
+    boost::shared_ptr<Group> group;
+    repository.retrieveObject(group, "g");
+    BOOST_CHECK_EQUAL(group->list().size(), std::size_t(2));
+    BOOST_CHECK(!deferred("g"));
+    BOOST_CHECK_EQUAL(repository.precedentIDs("g").size(), std::size_t(2));
+
+    // the object is created once
+    boost::shared_ptr<Group> again;
+    repository.retrieveObject(again, "g");
+    BOOST_CHECK(again == group);
+}
+
+void DeferredCreationTest::testCreationFailure() {
+
+    BOOST_TEST_MESSAGE("Testing failure to create a deferred object...");
+
+    Repository repository;
+    ProcessorFactory processorFactory;
+    TestSerializationFactory factory;
+
+    boost::shared_ptr<ValueObject> valueObject(new UnknownValueObject("bad"));
+    repository.deferObject("bad", valueObject);
+    BOOST_CHECK(deferred("bad"));
+
+    // every attempt reports the failure, the object stays deferred
+    for (int i=0; i<2; ++i) {
+        boost::shared_ptr<Object> object;
+        BOOST_CHECK_THROW(repository.retrieveObject(object, "bad"), std::exception);
+        BOOST_CHECK(deferred("bad"));
+    }
+}
+
+void DeferredCreationTest::testSnapshotOfDeferredObjects() {
+
+    BOOST_TEST_MESSAGE("Testing snapshot and restore of deferred objects...");
+
+    Repository repository;
+    ProcessorFactory processorFactory;
+    TestSerializationFactory factory;
+
+    load(saveGroup(), true);
+
+    std::string path = (boost::filesystem::temp_directory_path()
+                        / boost::filesystem::unique_path("oh-%%%%-%%%%.snap")).string();
+
+    // the snapshot is written from the ValueObjects, without creating the objects
+    BOOST_CHECK_EQUAL(repository.snapshot(path, true), 3);
+    BOOST_CHECK(deferred("r1"));
+    BOOST_CHECK(deferred("g"));
+
+    repository.deleteAllObjects(true);
+    BOOST_CHECK_EQUAL(repository.restore(path, false, true).size(), std::size_t(3));
+    BOOST_CHECK(deferred("g"));
+
+    boost::shared_ptr<Group> group;
+    repository.retrieveObject(group, "g");
+    BOOST_CHECK_EQUAL(group->list().size(), std::size_t(2));
+
+    boost::filesystem::remove(path);
+}
+
+
+test_suite* DeferredCreationTest::suite() {
+    test_suite* suite = BOOST_TEST_SUITE("Deferred creation tests");
+    suite->add(BOOST_TEST_CASE(&DeferredCreationTest::testDeferredLoad));
+    suite->add(BOOST_TEST_CASE(&DeferredCreationTest::testCreationOnRetrieval));
+    suite->add(BOOST_TEST_CASE(&DeferredCreationTest::testCreationFailure));
+    suite->add(BOOST_TEST_CASE(&DeferredCreationTest::testSnapshotOfDeferredObjects));
+    return suite;
+}
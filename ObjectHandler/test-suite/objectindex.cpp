@@ -0,0 +1,179 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <oh/config.hpp>
+#endif
+
+#include "objectindex.hpp"
+#include <oh/objectindex.hpp>
+#include <oh/objectwrapper.hpp>
+#include <oh/valueobjects/vo_range.hpp>
+#include <boost/lexical_cast.hpp>
+#include <map>
+
+using namespace ObjectHandler;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+    boost::shared_ptr<ObjectWrapper> wrapper(const std::string& objectID) {
+        boost::shared_ptr<ValueObject> valueObject(new ValueObjects::ohRange(
+            objectID, std::vector<std::vector<double> >(), false));
+        return boost::shared_ptr<ObjectWrapper>(new ObjectWrapper(valueObject));
+    }
+
+    std::string id(int i) {
+        return "obj" + boost::lexical_cast<std::string>(i);
+    }
+
+}
+
+
+void ObjectIndexTest::testLookup() {
+
+    BOOST_TEST_MESSAGE("Testing case-insensitive lookup in the object index...");
+
+    ObjectIndex index;
+    BOOST_CHECK(!index.find("a", foldedHash("a")));
+    BOOST_CHECK(!index.erase("a", foldedHash("a")));
+
+    boost::shared_ptr<ObjectWrapper> a = wrapper("Curve"), b = wrapper("curve");
+    index.insert("Curve", foldedHash("Curve"), a);
+    BOOST_CHECK(index.find("CURVE", foldedHash("CURVE")) == a);
+    BOOST_CHECK(index.find("curve", foldedHash("curve")) == a);
+    BOOST_CHECK(!index.find("curves", foldedHash("curves")));
+
+    // an ID differing only in case replaces the entry
+    index.insert("curve", foldedHash("curve"), b);
+    BOOST_CHECK_EQUAL(index.size(), std::size_t(1));
+    BOOST_CHECK(index.find("Curve", foldedHash("Curve")) == b);
+
+    BOOST_CHECK(index.erase("CuRvE", foldedHash("CuRvE")));
+    BOOST_CHECK_EQUAL(index.size(), std::size_t(0));
+    BOOST_CHECK(!index.find("curve", foldedHash("curve")));
+}
+
+void ObjectIndexTest::testCollidingKeys() {
+
+    BOOST_TEST_MESSAGE("Testing erasure from a run of colliding keys...");
+
+    // Every key has the same hash, so all of them share one probe sequence
+    // and each erasure has to shift the rest of the run back.
+    const std::size_t hash = 3;
+    const int n = 7;
+    ObjectIndex index;
+    std::vector<boost::shared_ptr<ObjectWrapper> > wrappers;
+    for (int i=0; i<n; ++i) {
+        wrappers.push_back(wrapper(id(i)));
+        index.insert(id(i), hash, wrappers.back());
+    }
+    BOOST_CHECK_EQUAL(index.size(), std::size_t(n));
+
+    // a key with the same hash which was never inserted is not found
+    BOOST_CHECK(!index.find("missing", hash));
+    BOOST_CHECK(!index.erase("missing", hash));
+
+    // erase from the middle, the front and the back of the run
+    int order[] = { 3, 0, 6, 1 };
+    std::vector<bool> present(n, true);
+    for (int k=0; k<4; ++k) {
+        BOOST_CHECK(index.erase(id(order[k]), hash));
+        present[order[k]] = false;
+        BOOST_CHECK(!index.erase(id(order[k]), hash));
+        for (int i=0; i<n; ++i) {
+            if (present[i])
+                BOOST_CHECK(index.find(id(i), hash) == wrappers[i]);
+            else
+                BOOST_CHECK(!index.find(id(i), hash));
+        }
+    }
+    BOOST_CHECK_EQUAL(index.size(), std::size_t(n - 4));
+
+    // the freed slots are reused
+    index.insert(id(3), hash, wrappers[3]);
+    BOOST_CHECK(index.find(id(3), hash) == wrappers[3]);
+    BOOST_CHECK(index.find(id(5), hash) == wrappers[5]);
+    BOOST_CHECK_EQUAL(index.size(), std::size_t(n - 3));
+}
+
+void ObjectIndexTest::testEraseWrapsAround() {
+
+    BOOST_TEST_MESSAGE("Testing erasure from a probe sequence which wraps around the table...");
+
+    // The table holds 16 slots until the ninth insertion.  Keys hashed to
+    // the last slot overflow into the first ones, where they mix with keys
+    // hashed to slot 0.
+    ObjectIndex index;
+    std::vector<boost::shared_ptr<ObjectWrapper> > wrappers;
+    std::vector<std::size_t> hashes;
+    for (int i=0; i<6; ++i) {
+        hashes.push_back(i % 2 ? 0 : 15);
+        wrappers.push_back(wrapper(id(i)));
+        index.insert(id(i), hashes.back(), wrappers.back());
+    }
+
+    for (int i=0; i<6; ++i) {
+        BOOST_CHECK(index.erase(id(i), hashes[i]));
+        for (int j=i+1; j<6; ++j)
+            BOOST_CHECK(index.find(id(j), hashes[j]) == wrappers[j]);
+    }
+    BOOST_CHECK_EQUAL(index.size(), std::size_t(0));
+}
+
+void ObjectIndexTest::testAgainstMap() {
+
+    BOOST_TEST_MESSAGE("Testing the object index against a std::map...");
+
+    // Hashes drawn from a small range collide often, and the table is
+    // rehashed several times as it grows.
+    ObjectIndex index;
+    std::map<int, boost::shared_ptr<ObjectWrapper> > reference;
+    unsigned long seed = 42;
+    for (int step=0; step<20000; ++step) {
+        seed = seed * 1103515245UL + 12345UL;
+        int key = static_cast<int>((seed >> 8) % 300);
+        std::size_t hash = key % 37;
+        if ((seed >> 20) % 3) {
+            boost::shared_ptr<ObjectWrapper> w = wrapper(id(key));
+            index.insert(id(key), hash, w);
+            reference[key] = w;
+        } else {
+            BOOST_CHECK_EQUAL(index.erase(id(key), hash), reference.erase(key) == 1);
+        }
+    }
+    BOOST_CHECK_EQUAL(index.size(), reference.size());
+    for (int key=0; key<300; ++key) {
+        std::map<int, boost::shared_ptr<ObjectWrapper> >::const_iterator i =
+            reference.find(key);
+        boost::shared_ptr<ObjectWrapper> found = index.find(id(key), key % 37);
+        if (i == reference.end())
+            BOOST_CHECK(!found);
+        else
+            BOOST_CHECK(found == i->second);
+    }
+}
+
+
+test_suite* ObjectIndexTest::suite() {
+    test_suite* suite = BOOST_TEST_SUITE("Object index tests");
+    suite->add(BOOST_TEST_CASE(&ObjectIndexTest::testLookup));
+    suite->add(BOOST_TEST_CASE(&ObjectIndexTest::testCollidingKeys));
+    suite->add(BOOST_TEST_CASE(&ObjectIndexTest::testEraseWrapsAround));
+    suite->add(BOOST_TEST_CASE(&ObjectIndexTest::testAgainstMap));
+    return suite;
+}
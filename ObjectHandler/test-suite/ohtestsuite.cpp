@@ -0,0 +1,45 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <oh/config.hpp>
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "asynclog.hpp"
+#include "deferredcreation.hpp"
+#include "objectindex.hpp"
+#include "parallelloop.hpp"
+#include "recreatedirty.hpp"
+#include "snapshot.hpp"
+
+using namespace boost::unit_test_framework;
+
+test_suite* init_unit_test_suite(int, char* []) {
+
+    test_suite* test = BOOST_TEST_SUITE("ObjectHandler test suite");
+
+    test->add(AsyncLogTest::suite());
+    test->add(DeferredCreationTest::suite());
+    test->add(ObjectIndexTest::suite());
+    test->add(ParallelLoopTest::suite());
+    test->add(RecreateDirtyTest::suite());
+    test->add(SnapshotTest::suite());
+
+    return test;
+}
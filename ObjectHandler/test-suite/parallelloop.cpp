@@ -0,0 +1,258 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <oh/config.hpp>
+#endif
+
+#include "parallelloop.hpp"
+#include <oh/parallelloop.hpp>
+#include <boost/lexical_cast.hpp>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#endif
+#include <algorithm>
+#include <utility>
+
+using namespace ObjectHandler;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    typedef boost::mutex Mutex;
+    typedef boost::lock_guard<Mutex> Lock;
+#else
+    struct Mutex {};
+    struct Lock { explicit Lock(Mutex &) {} };
+#endif
+
+    // Records the chunks it is given and counts the visits to each index.
+    class RecordChunks {
+      public:
+        explicit RecordChunks(std::size_t size, std::size_t failAt = std::size_t(-1))
+        : visits_(size, 0), failAt_(failAt) {}
+        void operator()(std::size_t begin, std::size_t end) {
+            {
+                Lock lock(mutex_);
+                chunks_.push_back(std::make_pair(begin, end));
+            }
+            for (std::size_t i = begin; i < end; ++i) {
+                OH_REQUIRE(i != failAt_, "failed at " << i);
+                ++visits_[i];
+            }
+        }
+        const std::vector<int> &visits() const { return visits_; }
+        std::vector<std::pair<std::size_t, std::size_t> > chunks() const {
+            std::vector<std::pair<std::size_t, std::size_t> > ret = chunks_;
+            std::sort(ret.begin(), ret.end());
+            return ret;
+        }
+      private:
+        std::vector<int> visits_;
+        std::size_t failAt_;
+        std::vector<std::pair<std::size_t, std::size_t> > chunks_;
+        Mutex mutex_;
+    };
+
+    // Runs a parallelFor of its own over each chunk.
+    class NestedChunks {
+      public:
+        explicit NestedChunks(std::size_t size) : inner_(size) {}
+        void operator()(std::size_t begin, std::size_t end) {
+            parallelFor(begin, end, inner_, 1);
+        }
+        const std::vector<int> &visits() const { return inner_.visits(); }
+      private:
+        RecordChunks inner_;
+    };
+
+    // Doubles its input, fails for multiples of seven, and records the
+    // inputs with which it is called.
+    class Doubler {
+      public:
+        double operator()(long x) {
+            {
+                Lock lock(mutex_);
+                calls_.push_back(x);
+            }
+            OH_REQUIRE(x % 7 != 0, "multiple of seven: " << x);
+            return 2.0 * x;
+        }
+        const std::vector<long> &calls() const { return calls_; }
+      private:
+        std::vector<long> calls_;
+        Mutex mutex_;
+    };
+
+    class Counter {
+      public:
+        Counter() : count_(0) {}
+        void operator()(long x) {
+            OH_REQUIRE(x >= 0, "negative input");
+            Lock lock(mutex_);
+            ++count_;
+        }
+        long count() const { return count_; }
+      private:
+        long count_;
+        Mutex mutex_;
+    };
+
+}
+
+
+void ParallelLoopTest::testChunks() {
+
+    BOOST_TEST_MESSAGE("Testing that parallelFor covers its range once in chunks of at least the grain size...");
+
+    std::size_t sizes[] = { 0, 1, 5, 8, 9, 100, 1001, 10000 };
+    std::size_t grains[] = { 1, 4, 64 };
+    for (int s=0; s<8; ++s) {
+        for (int g=0; g<3; ++g) {
+            std::size_t begin = 3, end = begin + sizes[s];
+            RecordChunks record(end);
+            parallelFor(begin, end, record, grains[g]);
+
+            for (std::size_t i=0; i<end; ++i)
+                BOOST_CHECK_EQUAL(record.visits()[i], i < begin ? 0 : 1);
+
+            // the chunks are consecutive, and only the last may be short
+            std::vector<std::pair<std::size_t, std::size_t> > chunks = record.chunks();
+            std::size_t next = begin;
+            for (std::size_t c=0; c<chunks.size(); ++c) {
+                BOOST_CHECK_EQUAL(chunks[c].first, next);
+                BOOST_CHECK(chunks[c].second > chunks[c].first);
+                if (c + 1 < chunks.size())
+                    BOOST_CHECK(chunks[c].second - chunks[c].first >= grains[g]);
+                next = chunks[c].second;
+            }
+            BOOST_CHECK_EQUAL(next, end);
+        }
+    }
+}
+
+void ParallelLoopTest::testChunkFailure() {
+
+    BOOST_TEST_MESSAGE("Testing that parallelFor reports an error thrown by a chunk...");
+
+    for (std::size_t failAt = 0; failAt < 1000; failAt += 333) {
+        RecordChunks record(1000, failAt);
+        try {
+            parallelFor(0, 1000, record, 4);
+            BOOST_ERROR("parallelFor did not report the error");
+        } catch (const Exception& e) {
+            BOOST_CHECK_EQUAL(std::string(e.what()),
+                              "failed at " + boost::lexical_cast<std::string>(failAt));
+        }
+        // no index is visited twice, and none after the failure in its chunk
+        for (std::size_t i=0; i<1000; ++i)
+            BOOST_CHECK(record.visits()[i] <= 1);
+        BOOST_CHECK_EQUAL(record.visits()[failAt], 0);
+    }
+
+    // the pool is still usable
+    RecordChunks record(1000);
+    parallelFor(0, 1000, record, 4);
+    BOOST_CHECK_EQUAL(std::count(record.visits().begin(), record.visits().end(), 1), 1000);
+}
+
+void ParallelLoopTest::testNestedLoops() {
+
+    BOOST_TEST_MESSAGE("Testing parallelFor called from within parallelFor...");
+
+    NestedChunks nested(5000);
+    parallelFor(0, 5000, nested, 16);
+    BOOST_CHECK_EQUAL(std::count(nested.visits().begin(), nested.visits().end(), 1), 5000);
+}
+
+void ParallelLoopTest::testResultOrder() {
+
+    BOOST_TEST_MESSAGE("Testing that evaluateLoop keeps results and errors in input order...");
+
+    const long n = 2000;
+    std::vector<long> inputs(n);
+    std::vector<LoopResult<double> > results(n);
+    for (long i=0; i<n; ++i)
+        inputs[i] = i;
+    // inputs which failed to convert are skipped
+    results[0].failed = true;
+    results[0].error = "conversion failed";
+    results[1].failed = true;
+    results[1].error = "conversion failed";
+    results[1500].failed = true;
+    results[1500].error = "conversion failed";
+
+    Doubler doubler;
+    evaluateLoop(doubler, inputs, results);
+
+    // the first iteration runs alone, before any other
+    BOOST_REQUIRE(!doubler.calls().empty());
+    BOOST_CHECK_EQUAL(doubler.calls().front(), 2L);
+    BOOST_CHECK_EQUAL(doubler.calls().size(), std::size_t(n - 3));
+    std::vector<long> calls = doubler.calls();
+    std::sort(calls.begin(), calls.end());
+    BOOST_CHECK(std::adjacent_find(calls.begin(), calls.end()) == calls.end());
+
+    for (long i=0; i<n; ++i) {
+        if (i == 0 || i == 1 || i == 1500) {
+            BOOST_CHECK(results[i].failed);
+            BOOST_CHECK_EQUAL(results[i].error, std::string("conversion failed"));
+        } else if (i % 7 == 0) {
+            BOOST_CHECK(results[i].failed);
+            BOOST_CHECK_EQUAL(results[i].error,
+                              "multiple of seven: " + boost::lexical_cast<std::string>(i));
+        } else {
+            BOOST_CHECK(!results[i].failed);
+            BOOST_CHECK_EQUAL(results[i].value, 2.0 * i);
+        }
+    }
+
+    std::vector<LoopResult<double> > tooFew(n - 1);
+    BOOST_CHECK_THROW(evaluateLoop(doubler, inputs, tooFew), Exception);
+}
+
+void ParallelLoopTest::testVoidResults() {
+
+    BOOST_TEST_MESSAGE("Testing evaluateLoop with a function returning void...");
+
+    std::vector<long> inputs(500, 1);
+    inputs[3] = -1;
+    std::vector<LoopResult<void> > results(inputs.size());
+    Counter counter;
+    evaluateLoop(counter, inputs, results);
+
+    BOOST_CHECK_EQUAL(counter.count(), long(inputs.size() - 1));
+    for (std::size_t i=0; i<inputs.size(); ++i) {
+        BOOST_CHECK_EQUAL(results[i].failed, i == 3);
+        if (!results[i].failed)
+            BOOST_CHECK(results[i].value);
+    }
+    BOOST_CHECK_EQUAL(results[3].error, std::string("negative input"));
+}
+
+
+test_suite* ParallelLoopTest::suite() {
+    test_suite* suite = BOOST_TEST_SUITE("Parallel loop tests");
+    suite->add(BOOST_TEST_CASE(&ParallelLoopTest::testChunks));
+    suite->add(BOOST_TEST_CASE(&ParallelLoopTest::testChunkFailure));
+    suite->add(BOOST_TEST_CASE(&ParallelLoopTest::testNestedLoops));
+    suite->add(BOOST_TEST_CASE(&ParallelLoopTest::testResultOrder));
+    suite->add(BOOST_TEST_CASE(&ParallelLoopTest::testVoidResults));
+    return suite;
+}
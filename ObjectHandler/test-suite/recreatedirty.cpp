@@ -0,0 +1,193 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <oh/config.hpp>
+#endif
+
+#include "recreatedirty.hpp"
+#include "utilities.hpp"
+#include <oh/processor.hpp>
+#include <oh/conversions/convert2.hpp>
+#include <boost/lexical_cast.hpp>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#endif
+#include <algorithm>
+
+using namespace ObjectHandler;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+    // The IDs of the Groups in the order in which they were created.
+    std::vector<std::string> created;
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+    boost::mutex createdMutex;
+#endif
+
+    // Create a Group and record its ID.  The Group with ID "bad" cannot
+    // be created.
+    boost::shared_ptr<Object> createGroup(
+                            const boost::shared_ptr<ValueObject>& valueObject) {
+        OH_REQUIRE(valueObject->objectId() != "bad", "cannot create bad");
+        std::vector<std::string> list = vector::convert2<std::string>(
+            valueObject->getProperty("OBJECTIDLIST"), "OBJECTIDLIST");
+        {
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+            boost::lock_guard<boost::mutex> lock(createdMutex);
+#endif
+            created.push_back(valueObject->objectId());
+        }
+        return boost::shared_ptr<Object>(new Group(valueObject, list, false));
+    }
+
+    class RecordingSerializationFactory : public TestSerializationFactory {
+      public:
+        RecordingSerializationFactory() {
+            registerCreator("ohGroup", createGroup);
+        }
+    };
+
+    std::string id(const std::string& prefix, int i) {
+        return prefix + boost::lexical_cast<std::string>(i);
+    }
+
+    std::vector<std::string> list(const std::string& objectID) {
+        return std::vector<std::string>(1, objectID);
+    }
+
+    // A Range on which hang a fan of Groups, a chain of Groups hanging
+    // from one of them, and a Group of the whole fan.
+    std::vector<std::string> makeGraph(int fan, int chain) {
+        std::vector<std::string> groups, all;
+        makeRange("curve", 1.0);
+        makeGroup("g", list("curve"));
+        groups.push_back("g");
+        for (int i=0; i<fan; ++i) {
+            makeGroup(id("f", i), list("g"));
+            groups.push_back(id("f", i));
+            all.push_back(id("f", i));
+        }
+        makeGroup(id("c", 0), list(id("f", fan / 2)));
+        groups.push_back(id("c", 0));
+        for (int i=1; i<chain; ++i) {
+            makeGroup(id("c", i), list(id("c", i - 1)));
+            groups.push_back(id("c", i));
+        }
+        makeGroup("all", all);
+        groups.push_back("all");
+        return groups;
+    }
+
+    // Check that every Group was created once, after its precedents.
+    void checkOrder(const std::vector<std::string>& expected) {
+        std::vector<std::string> order = created;
+        BOOST_REQUIRE_EQUAL(order.size(), expected.size());
+        for (std::vector<std::string>::const_iterator i = order.begin();
+             i != order.end(); ++i) {
+            BOOST_CHECK_EQUAL(std::count(order.begin(), order.end(), *i), 1);
+            std::vector<std::string> precedents =
+                Repository::instance().precedentIDs(*i);
+            for (std::size_t j=0; j<precedents.size(); ++j) {
+                std::vector<std::string>::const_iterator p =
+                    std::find(order.begin(), order.end(), precedents[j]);
+                if (p != order.end() && p > i)
+                    BOOST_ERROR(*i << " was created before its precedent " << *p);
+            }
+        }
+        for (std::size_t i=0; i<expected.size(); ++i)
+            BOOST_CHECK(std::find(order.begin(), order.end(), expected[i]) != order.end());
+    }
+
+}
+
+
+void RecreateDirtyTest::testOrder() {
+
+    BOOST_TEST_MESSAGE("Testing that dirty objects are recreated after their precedents...");
+
+    Repository repository;
+    ProcessorFactory processorFactory;
+    RecordingSerializationFactory factory;
+
+    std::vector<std::string> groups = makeGraph(50, 10);
+    // nothing is dirty yet
+    created.clear();
+    BOOST_CHECK_EQUAL(repository.recreateDirty(), 0);
+    BOOST_CHECK(created.empty());
+
+    long threads[] = { 1, 4, 0 };
+    for (int k=0; k<3; ++k) {
+        // replacing the Range makes every Group dirty
+        makeRange("curve", 2.0 + k);
+        created.clear();
+        BOOST_CHECK_EQUAL(repository.recreateDirty(threads[k]), long(groups.size()));
+        checkOrder(groups);
+
+        // each object was recreated once, none is dirty any longer
+        created.clear();
+        BOOST_CHECK_EQUAL(repository.recreateDirty(threads[k]), 0);
+        BOOST_CHECK(created.empty());
+    }
+
+    BOOST_CHECK_THROW(repository.recreateDirty(-1), Exception);
+
+    repository.deleteAllObjects(true);
+}
+
+void RecreateDirtyTest::testFailure() {
+
+    BOOST_TEST_MESSAGE("Testing that the dependants of an object which cannot be recreated stay dirty...");
+
+    Repository repository;
+    ProcessorFactory processorFactory;
+    RecordingSerializationFactory factory;
+
+    std::vector<std::string> groups = makeGraph(10, 3);
+    makeGroup("bad", list("curve"));
+    makeGroup("afterBad", list("bad"));
+    makeRange("curve", 2.0);
+
+    created.clear();
+    try {
+        repository.recreateDirty(2);
+        BOOST_ERROR("recreateDirty did not report the failure");
+    } catch (const Exception& e) {
+        std::string what = e.what();
+        BOOST_CHECK(what.find("bad") != std::string::npos);
+        BOOST_CHECK(what.find("1 object(s)") != std::string::npos);
+    }
+    // the other objects are recreated
+    checkOrder(groups);
+
+    // the dependant of the failed object is still dirty and fails again
+    created.clear();
+    BOOST_CHECK_THROW(repository.recreateDirty(), Exception);
+    BOOST_CHECK(created.empty());
+
+    repository.deleteAllObjects(true);
+}
+
+
+test_suite* RecreateDirtyTest::suite() {
+    test_suite* suite = BOOST_TEST_SUITE("Recreation of dirty objects tests");
+    suite->add(BOOST_TEST_CASE(&RecreateDirtyTest::testOrder));
+    suite->add(BOOST_TEST_CASE(&RecreateDirtyTest::testFailure));
+    return suite;
+}
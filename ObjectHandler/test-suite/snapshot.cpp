@@ -0,0 +1,322 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <oh/config.hpp>
+#endif
+
+#include "snapshot.hpp"
+#include "utilities.hpp"
+#include <oh/processor.hpp>
+#include <oh/conversions/convert2.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/cstdint.hpp>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+
+using namespace ObjectHandler;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+    // The offsets of some fields of a snapshot file, see class Snapshot.
+    const std::size_t versionOffset = 8;
+    const std::size_t countOffset = 16;
+    const std::size_t headerSize = 48;
+    const std::size_t idOffsetOffset = headerSize;
+    const std::size_t idLengthOffset = headerSize + 8;
+    const std::size_t valueObjectOffsetOffset = headerSize + 16;
+    const std::size_t valueObjectLengthOffset = headerSize + 24;
+
+    // A directory which is removed with its contents at the end of a test.
+    class TemporaryDirectory {
+      public:
+        TemporaryDirectory()
+        : path_(boost::filesystem::temp_directory_path()
+                / boost::filesystem::unique_path("oh-%%%%-%%%%")) {
+            boost::filesystem::create_directory(path_);
+        }
+        ~TemporaryDirectory() {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all(path_, ec);
+        }
+        std::string file(const std::string& name) const {
+            return (path_ / name).string();
+        }
+        std::size_t count() const {
+            return std::distance(boost::filesystem::directory_iterator(path_),
+                                 boost::filesystem::directory_iterator());
+        }
+      private:
+        boost::filesystem::path path_;
+    };
+
+    // Store two Ranges and a Group of them.
+    void makeObjects() {
+        std::vector<std::string> list;
+        list.push_back("r2");
+        list.push_back("r1");
+        makeRange("r1", 1.0);
+        makeRange("r2", 2.0);
+        makeGroup("g", list);
+    }
+
+    double rangeValue(const std::string& objectID) {
+        boost::shared_ptr<Range> range;
+        Repository::instance().retrieveObject(range, objectID);
+        return matrix::convert2<double>(
+            range->properties()->getProperty("VALUES"), "VALUES")[0][0];
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in),
+                           std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const std::string& path, const std::string& bytes) {
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size());
+    }
+
+    template <class T>
+    std::string patch(std::string bytes, std::size_t offset, T value) {
+        std::memcpy(&bytes[offset], &value, sizeof(T));
+        return bytes;
+    }
+
+    // Check that restoring the given bytes fails with the given message
+    // and creates no object.
+    void checkRejected(const TemporaryDirectory& directory,
+                       const std::string& bytes,
+                       const std::string& message) {
+        std::string path = directory.file("bad.snap");
+        writeFile(path, bytes);
+        Repository::instance().deleteAllObjects(true);
+        try {
+            Repository::instance().restore(path);
+            BOOST_ERROR("corrupt snapshot restored, expected: " << message);
+        } catch (const std::exception& e) {
+            std::string what = e.what();
+            if (what.find(message) == std::string::npos)
+                BOOST_ERROR("unexpected error: " << what
+                            << ", expected: " << message);
+        }
+        BOOST_CHECK_EQUAL(Repository::instance().objectCount(), 0);
+    }
+
+}
+
+
+void SnapshotTest::testRoundTrip() {
+
+    BOOST_TEST_MESSAGE("Testing snapshot and restore of the repository...");
+
+    Repository repository;
+    ProcessorFactory processorFactory;
+    TestSerializationFactory factory;
+    TemporaryDirectory directory;
+    std::string path = directory.file("repository.snap");
+
+    makeObjects();
+    BOOST_CHECK_EQUAL(repository.snapshot(path), 3);
+
+    repository.deleteAllObjects(true);
+    std::vector<std::string> restored = repository.restore(path);
+    BOOST_REQUIRE_EQUAL(restored.size(), std::size_t(3));
+    // precedents are restored first
+    BOOST_CHECK_EQUAL(restored.back(), std::string("g"));
+    BOOST_CHECK_EQUAL(repository.objectCount(), 3);
+
+    BOOST_CHECK_EQUAL(rangeValue("r1"), 1.0);
+    BOOST_CHECK_EQUAL(rangeValue("r2"), 2.0);
+    boost::shared_ptr<Group> group;
+    repository.retrieveObject(group, "g");
+    BOOST_REQUIRE_EQUAL(group->list().size(), std::size_t(2));
+    BOOST_CHECK_EQUAL(group->list()[0], std::string("r2"));
+    BOOST_CHECK_EQUAL(group->list()[1], std::string("r1"));
+    BOOST_CHECK_EQUAL(repository.precedentIDs("g").size(), std::size_t(2));
+
+    // an empty repository gives an empty snapshot
+    repository.deleteAllObjects(true);
+    BOOST_CHECK_EQUAL(repository.snapshot(path, true), 0);
+    BOOST_CHECK(repository.restore(path).empty());
+}
+
+void SnapshotTest::testOverwrite() {
+
+    BOOST_TEST_MESSAGE("Testing replacement of an existing snapshot file...");
+
+    Repository repository;
+    ProcessorFactory processorFactory;
+    TestSerializationFactory factory;
+    TemporaryDirectory directory;
+    std::string path = directory.file("repository.snap");
+
+    makeObjects();
+    repository.snapshot(path);
+    std::string before = readFile(path);
+
+    // an existing file is not replaced unless requested
+    makeRange("r1", 10.0);
+    BOOST_CHECK_THROW(repository.snapshot(path), Exception);
+    BOOST_CHECK(readFile(path) == before);
+
+    BOOST_CHECK_EQUAL(repository.snapshot(path, true), 3);
+    BOOST_CHECK(readFile(path) != before);
+    // no temporary file is left behind
+    BOOST_CHECK_EQUAL(directory.count(), std::size_t(1));
+
+    repository.deleteAllObjects(true);
+    repository.restore(path);
+    BOOST_CHECK_EQUAL(rangeValue("r1"), 10.0);
+
+    repository.deleteAllObjects(true);
+}
+
+void SnapshotTest::testTruncatedFiles() {
+
+    BOOST_TEST_MESSAGE("Testing that truncated snapshot files are rejected...");
+
+    Repository repository;
+    ProcessorFactory processorFactory;
+    TestSerializationFactory factory;
+    TemporaryDirectory directory;
+    std::string path = directory.file("repository.snap");
+
+    makeObjects();
+    repository.snapshot(path);
+    std::string bytes = readFile(path);
+
+    checkRejected(directory, bytes.substr(0, 4), "is not an ObjectHandler snapshot");
+    checkRejected(directory, bytes.substr(0, headerSize - 1), "is not an ObjectHandler snapshot");
+    checkRejected(directory, bytes.substr(0, headerSize), "truncated or corrupt");
+    checkRejected(directory, bytes.substr(0, bytes.size() / 2), "truncated or corrupt");
+    checkRejected(directory, bytes.substr(0, bytes.size() - 1), "truncated or corrupt");
+    checkRejected(directory, bytes + '\0', "truncated or corrupt");
+}
+
+void SnapshotTest::testCorruptFiles() {
+
+    BOOST_TEST_MESSAGE("Testing that corrupt snapshot files are rejected...");
+
+    Repository repository;
+    ProcessorFactory processorFactory;
+    TestSerializationFactory factory;
+    TemporaryDirectory directory;
+    std::string path = directory.file("repository.snap");
+
+    makeObjects();
+    repository.snapshot(path);
+    std::string bytes = readFile(path);
+
+    std::string notSnapshot(bytes);
+    notSnapshot[0] = 'X';
+    checkRejected(directory, notSnapshot, "is not an ObjectHandler snapshot");
+    boost::uint32_t version;
+    std::memcpy(&version, &bytes[versionOffset], sizeof(version));
+    checkRejected(directory,
+                  patch<boost::uint32_t>(bytes, versionOffset, version + 1),
+                  "format version");
+
+    // sizes which would overflow an offset if they were added to it, the
+    // first count wraps around to the same data offset as the true one
+    boost::uint64_t count;
+    std::memcpy(&count, &bytes[countOffset], sizeof(count));
+    checkRejected(directory,
+                  patch(bytes, countOffset, count + (boost::uint64_t(1) << 59)),
+                  "truncated or corrupt");
+    const boost::uint64_t huge = ~boost::uint64_t(0) - 7;
+    checkRejected(directory, patch(bytes, countOffset, huge), "truncated or corrupt");
+    checkRejected(directory, patch(bytes, countOffset, boost::uint64_t(4)),
+                  "truncated or corrupt");
+    checkRejected(directory, patch(bytes, idLengthOffset, huge), "truncated or corrupt");
+    boost::uint64_t idOffset;
+    std::memcpy(&idOffset, &bytes[idOffsetOffset], sizeof(idOffset));
+    checkRejected(directory,
+                  patch(patch(bytes, idLengthOffset, huge),
+                        valueObjectOffsetOffset, idOffset + huge),
+                  "truncated or corrupt");
+    checkRejected(directory, patch(bytes, valueObjectLengthOffset, huge),
+                  "truncated or corrupt");
+
+    // a damaged archive is reported when its object is restored
+    std::string damaged(bytes);
+    std::size_t archive = damaged.rfind("serialization::archive");
+    BOOST_REQUIRE(archive != std::string::npos);
+    damaged[archive] = 'X';
+    writeFile(path, damaged);
+    repository.deleteAllObjects(true);
+    BOOST_CHECK_THROW(repository.restore(path), Exception);
+
+    repository.deleteAllObjects(true);
+}
+
+void SnapshotTest::testDeferredRestore() {
+
+    BOOST_TEST_MESSAGE("Testing that deferred objects are read from the snapshot on demand...");
+
+    Repository repository;
+    ProcessorFactory processorFactory;
+    TestSerializationFactory factory;
+    TemporaryDirectory directory;
+    std::string path = directory.file("repository.snap");
+
+    makeObjects();
+    repository.snapshot(path);
+
+    // damage the archive of the last object, the group
+    std::string damaged = readFile(path);
+    std::size_t archive = damaged.rfind("serialization::archive");
+    BOOST_REQUIRE(archive != std::string::npos);
+    damaged[archive] = 'X';
+    writeFile(path, damaged);
+
+    // the archives are not read while the objects are restored
+    repository.deleteAllObjects(true);
+    std::vector<std::string> restored = repository.restore(path, false, true);
+    BOOST_CHECK_EQUAL(restored.size(), std::size_t(3));
+    BOOST_CHECK_EQUAL(repository.objectCount(), 3);
+    // nor to delete the transient objects
+    repository.deleteAllObjects();
+    BOOST_CHECK_EQUAL(repository.objectCount(), 0);
+
+    repository.restore(path, false, true);
+    BOOST_CHECK_EQUAL(rangeValue("r1"), 1.0);
+    boost::shared_ptr<Group> group;
+    BOOST_CHECK_THROW(repository.retrieveObject(group, "g"), Exception);
+
+#if !defined(_WIN32)
+    // the file stays mapped until every archive has been read
+    boost::filesystem::remove(path);
+    BOOST_CHECK_EQUAL(rangeValue("r2"), 2.0);
+#endif
+
+    repository.deleteAllObjects(true);
+}
+
+
+test_suite* SnapshotTest::suite() {
+    test_suite* suite = BOOST_TEST_SUITE("Snapshot tests");
+    suite->add(BOOST_TEST_CASE(&SnapshotTest::testRoundTrip));
+    suite->add(BOOST_TEST_CASE(&SnapshotTest::testOverwrite));
+    suite->add(BOOST_TEST_CASE(&SnapshotTest::testTruncatedFiles));
+    suite->add(BOOST_TEST_CASE(&SnapshotTest::testCorruptFiles));
+    suite->add(BOOST_TEST_CASE(&SnapshotTest::testDeferredRestore));
+    return suite;
+}
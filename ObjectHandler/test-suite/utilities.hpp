@@ -0,0 +1,91 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#ifndef oh_test_utilities_hpp
+#define oh_test_utilities_hpp
+
+#include <oh/repository.hpp>
+#include <oh/serializationfactory.hpp>
+#include <oh/range.hpp>
+#include <oh/group.hpp>
+#include <oh/valueobjects/vo_range.hpp>
+#include <oh/valueobjects/vo_group.hpp>
+#include <boost/archive/xml_oarchive.hpp>
+#include <boost/archive/xml_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+
+// utilities
+
+namespace ObjectHandler {
+
+    // A SerializationFactory for the Objects of ObjectHandler itself.
+    class TestSerializationFactory : public SerializationFactory {
+      protected:
+        virtual void register_out(boost::archive::xml_oarchive &ar,
+            std::vector<boost::shared_ptr<ValueObject> >& valueObjects) {
+            ar.register_type<ValueObjects::ohRange>();
+            ar.register_type<ValueObjects::ohGroup>();
+            ar << boost::serialization::make_nvp("object_list", valueObjects);
+        }
+        virtual void register_in(boost::archive::xml_iarchive &ar,
+            std::vector<boost::shared_ptr<ValueObject> >& valueObjects) {
+            ar.register_type<ValueObjects::ohRange>();
+            ar.register_type<ValueObjects::ohGroup>();
+            ar >> boost::serialization::make_nvp("object_list", valueObjects);
+        }
+        virtual void register_out(boost::archive::binary_oarchive &ar,
+            std::vector<boost::shared_ptr<ValueObject> >& valueObjects) {
+            ar.register_type<ValueObjects::ohRange>();
+            ar.register_type<ValueObjects::ohGroup>();
+            ar << boost::serialization::make_nvp("object_list", valueObjects);
+        }
+        virtual void register_in(boost::archive::binary_iarchive &ar,
+            std::vector<boost::shared_ptr<ValueObject> >& valueObjects) {
+            ar.register_type<ValueObjects::ohRange>();
+            ar.register_type<ValueObjects::ohGroup>();
+            ar >> boost::serialization::make_nvp("object_list", valueObjects);
+        }
+    };
+
+    // Store a Range holding the single value x under the given ID.
+    inline boost::shared_ptr<Object> makeRange(const std::string &objectID, double x) {
+        std::vector<std::vector<double> > values(1, std::vector<double>(1, x));
+        boost::shared_ptr<ValueObject> valueObject(
+            new ValueObjects::ohRange(objectID, values, false));
+        boost::shared_ptr<Object> object(new Range(valueObject, values, false));
+        Repository::instance().storeObject(objectID, object, true);
+        return object;
+    }
+
+    // Store a Group of the given Objects under the given ID.
+    inline boost::shared_ptr<Object> makeGroup(const std::string &objectID,
+                                               const std::vector<std::string> &list) {
+        boost::shared_ptr<ValueObject> valueObject(
+            new ValueObjects::ohGroup(objectID, list, false));
+        for (std::size_t i=0; i<list.size(); ++i)
+            valueObject->processPrecedentID(list[i]);
+        boost::shared_ptr<Object> object(new Group(valueObject, list, false));
+        Repository::instance().storeObject(objectID, object, true);
+        return object;
+    }
+
+}
+
+#endif
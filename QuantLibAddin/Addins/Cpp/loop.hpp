@@ -23,6 +23,7 @@
 #ifndef qlcpp_loop_hpp
 #define qlcpp_loop_hpp
 
+#include <oh/parallelloop.hpp>
 #include <vector>
 
 namespace QuantLibAddinCpp {
@@ -41,6 +42,30 @@ namespace QuantLibAddinCpp {
         return vOut;
     }
 
+    //! As loop(), but the iterations are distributed over a pool of threads.
+    /*! Generated for looping functions marked threadSafe in the gensrc
+        metadata.  If any iterations fail then the error of the first of
+        them in the order of the input is thrown, as it would have been by
+        loop().
+    */
+    template<class LoopFunction, class InputType, class OutputType>
+    std::vector<OutputType> parallelLoop(
+        LoopFunction &loopFunction, 
+        const std::vector<InputType> &vIn) {
+
+        std::vector<ObjectHandler::LoopResult<OutputType> > results(vIn.size());
+        ObjectHandler::evaluateLoop(loopFunction, vIn, results);
+
+        std::vector<OutputType> vOut;
+        vOut.reserve(vIn.size());
+        typename std::vector<ObjectHandler::LoopResult<OutputType> >::const_iterator i;
+        for (i = results.begin(); i != results.end(); ++i) {
+            OH_REQUIRE(!i->failed, i->error);
+            vOut.push_back(i->value);
+        }
+        return vOut;
+    }
+
 }
 
 #endif
@@ -33,7 +33,7 @@ int main() {
 
         initializeAddin();
 
-        ohLogSetFile("qlademo.log", 4L, OH_NULL);
+        ohLogSetFile("qlademo.log", 4L, OH_NULL, OH_NULL);
         ohLogSetConsole(1, 4L, OH_NULL);
         LOG_MESSAGE("Begin example program.");
         LOG_MESSAGE("QuantLibAddin version = " << qlAddinVersion(OH_NULL));
@@ -69,7 +69,7 @@ int main(int argc, char** argv) {
 
         initializeAddin();
 
-        ohLogSetFile("qla_demo.log", 4L, OH_NULL);
+        ohLogSetFile("qla_demo.log", 4L, OH_NULL, OH_NULL);
         ohLogSetConsole(1, 4L, OH_NULL);
         LOG_MESSAGE("Begin example program.");
         LOG_MESSAGE("QuantLibAddin version = " << qlAddinVersion(OH_NULL));
@@ -82,9 +82,9 @@ int main(int argc, char** argv) {
         // Deserialize the objects
         for(unsigned int index = 0; index < vecMaketfiles.size(); ++index) {
             ohObjectLoad("MarketData", vecMaketfiles[index],
-                false, OH_NULL, OH_NULL);
+                false, OH_NULL, OH_NULL, OH_NULL);
         }
-        ohObjectLoad("Models", tradeFile, false, OH_NULL, OH_NULL);
+        ohObjectLoad("Models", tradeFile, false, OH_NULL, OH_NULL, OH_NULL);
 
         // Output the PV of the deal
 
@@ -401,6 +401,44 @@ code218 = '''\
         std::vector<QuantLib::Handle<QuantLib::Quote> > %(nameConverted)s =
             ObjectHandler::vector::convert2<QuantLib::Handle<QuantLib::Quote> >(%(name)s, "%(name)s");\n'''
 
+code219 = '''\
+        std::vector<boost::shared_ptr<%(type)s> > %(nameConverted)sBatch =
+            ObjectHandler::getObjects<%(type)s>(%(name)s);\n'''
+
+code220 = '''\
+        std::vector<boost::shared_ptr<%(namespaceLibrary)s::%(classname)s> > %(nameConverted)sBatch =
+            ObjectHandler::getLibraryObjects<
+                %(namespaceObjects)s::%(classname)s, %(namespaceLibrary)s::%(classname)s>(%(name)s);\n'''
+
+code221 = '''\
+        std::vector<boost::shared_ptr<ObjectHandler::Object> > %(name)sBatch =
+            ObjectHandler::getObjects<ObjectHandler::Object>(%(name)s);\n'''
+
+code222 = '''\
+            const boost::shared_ptr<%(type)s> &%(nameConverted)s = %(nameConverted)sBatch[i];\n'''
+
+code223 = '''\
+            const boost::shared_ptr<%(namespaceLibrary)s::%(classname)s> &%(nameConverted)s =
+                %(nameConverted)sBatch[i];\n'''
+
+code224 = '''\
+            boost::shared_ptr<%(namespaceLibrary)s::%(classname)s> %(nameConverted)s =
+                %(namespaceObjects)s::CoerceTermStructure<
+                    %(namespaceObjects)s::%(classname)s,
+                    %(namespaceLibrary)s::%(classname)s>()(
+                        %(name)sBatch[i]);\n'''
+
+code225 = '''\
+            returnValues.push_back(static_cast<long>(%(namespaceObjects)s::libraryToScalar(returnValue)));'''
+
+code226 = '''\
+            returnValues.push_back(%(namespaceObjects)s::libraryToScalar(returnValue));'''
+
+code227 = '''\
+            std::ostringstream os;
+            os << returnValue;
+            returnValues.push_back(os.str());'''
+
 ##########################################################################
 # code for Calc
 ##########################################################################
@@ -697,59 +735,68 @@ codeCalc218 = '''\
 ##########################################################################
 
 code66 = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            return %(name)s_;\n'''
+            case %(propertyIndex)s:
+                return %(name)s_;\n'''
 
 code66a = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            return %(name)s_;\n'''
+            case %(propertyIndex)s:
+                return %(name)s_;\n'''
 
 code67a = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = value;\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = value;
+                break;\n'''
 
 code67b = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::convert2<std::string>(value);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::convert2<std::string>(value);
+                break;\n'''
 
 code67c = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::convert2<%(nativeType)s>(value);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::convert2<%(nativeType)s>(value);
+                break;\n'''
 
 code67d = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::vector::convert2<ObjectHandler::property_t>(value, nameUpper);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::vector::convert2<ObjectHandler::property_t>(value, "%(nameUpper)s");
+                break;\n'''
 
 code67e = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::vector::convert2<std::string>(value, nameUpper);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::vector::convert2<std::string>(value, "%(nameUpper)s");
+                break;\n'''
 
 code67f = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::vector::convert2<%(nativeType)s>(value, nameUpper);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::vector::convert2<%(nativeType)s>(value, "%(nameUpper)s");
+                break;\n'''
 
 code67g = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::matrix::convert2<ObjectHandler::property_t>(value, nameUpper);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::matrix::convert2<ObjectHandler::property_t>(value, "%(nameUpper)s");
+                break;\n'''
 
 code67h = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::matrix::convert2<std::string>(value, nameUpper);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::matrix::convert2<std::string>(value, "%(nameUpper)s");
+                break;\n'''
 
 code67i = '''\
-        else if(strcmp(nameUpper.c_str(), "%(nameUpper)s")==0)
-            %(name)s_ = ObjectHandler::matrix::convert2<%(nativeType)s>(value, nameUpper);\n'''
+            case %(propertyIndex)s:
+                %(name)s_ = ObjectHandler::matrix::convert2<%(nativeType)s>(value, "%(nameUpper)s");
+                break;\n'''
 
 code68 = '''\
-            processVariant(%(name)s);'''
+        processVariant(%(name)s_);'''
 
 code69 = '''\
-            processPrecedentID(%(name)s);'''
+        processPrecedentID(%(name)s_);'''
 
 code70 = '''\
-            for (std::vector<std::string>::const_iterator i = %(name)s.begin();
-                    i != %(name)s.end(); ++i)
-                processPrecedentID(*i);'''
+        for (std::vector<std::string>::const_iterator i = %(name)s_->begin();
+                i != %(name)s_->end(); ++i)
+            processPrecedentID(*i);'''
 
 code68b = '''\
         valueObject->processVariant(%(name)s);'''
@@ -769,53 +816,53 @@ code70b = '''\
 
 code110 = '''\
         ObjectHandler::property_t %(name)s =
-            valueObject->getProperty("%(name)s");\n'''
+            valueObject->getSystemProperty(%(propertyIndex)s);\n'''
 
 code111 = '''\
         std::string %(name)s =
-            ObjectHandler::convert2<std::string>(valueObject->getProperty("%(name)s"));\n'''
+            ObjectHandler::convert2<std::string>(valueObject->getSystemProperty(%(propertyIndex)s));\n'''
 
 code112 = '''\
         %(nativeType)s %(name)s =
-            ObjectHandler::convert2<%(nativeType)s>(valueObject->getProperty("%(name)s"));\n'''
+            ObjectHandler::convert2<%(nativeType)s>(valueObject->getSystemProperty(%(propertyIndex)s));\n'''
 
 code113 = '''\
         std::vector<%(nativeType)s> %(name)s =
-            ObjectHandler::vector::convert2<%(nativeType)s>(valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+            ObjectHandler::vector::convert2<%(nativeType)s>(valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 
 #code114 = '''\
 #        std::vector<ObjectHandler::property_t> %(name)s =
-#            ObjectHandler::convert2<std::vector<ObjectHandler::property_t> >(valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+#            ObjectHandler::convert2<std::vector<ObjectHandler::property_t> >(valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 code114 = '''\
         std::vector<ObjectHandler::property_t> %(name)s =
-            ObjectHandler::vector::convert2<ObjectHandler::property_t>(valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+            ObjectHandler::vector::convert2<ObjectHandler::property_t>(valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 
 code115 = '''\
         std::vector<std::string> %(name)s =
-            ObjectHandler::vector::convert2<std::string>(valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+            ObjectHandler::vector::convert2<std::string>(valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 
 code116 = '''\
         std::vector<std::vector<std::string> > %(name)s =
-            ObjectHandler::matrix::convert2<std::string>(valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+            ObjectHandler::matrix::convert2<std::string>(valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 
 code117 = '''\
         std::vector<std::vector<%(nativeType)s> > %(name)s =
-            ObjectHandler::matrix::convert2<%(nativeType)s>(valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+            ObjectHandler::matrix::convert2<%(nativeType)s>(valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 
 code118 = '''\
         std::vector<std::vector<ObjectHandler::property_t> > %(name)s =
-            ObjectHandler::matrix::convert2<ObjectHandler::property_t>(valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+            ObjectHandler::matrix::convert2<ObjectHandler::property_t>(valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 
 code121a = '''\
         %(type)s %(nameConverted)s = %(name)s;\n'''
 
 code121 = '''\
         %(type)s %(nameConverted)s = ObjectHandler::convert2<%(type)s>(
-            valueObject->getProperty("%(name)s"), "%(name)s");\n'''
+            valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s");\n'''
 
 code122 = '''\
         %(type)s %(nameConverted)s = ObjectHandler::convert2<%(type)s>(
-            valueObject->getProperty("%(name)s"), "%(name)s", %(defaultValue)s);\n'''
+            valueObject->getSystemProperty(%(propertyIndex)s), "%(name)s", %(defaultValue)s);\n'''
 
 code123 = '''\
         std::string %(name)sCpp = ObjectHandler::convert2<std::string>(
@@ -36,6 +36,11 @@
 #include <qlo/enumerations/factories/historicalforwardratesanalysisfactory.hpp>
 
 namespace QuantLibAddin {
+
+    namespace {
+        // Memo of the Create<> call site in HistoricalForwardRatesAnalysis.
+        ObjectHandler::CreateCache historicalForwardRatesAnalysisCache;
+    }
       
     //Correlation model
     LmLinearExponentialCorrelationModel::LmLinearExponentialCorrelationModel(
@@ -114,7 +119,8 @@ namespace QuantLibAddin {
         bool permanent) : ObjectHandler::LibraryObject<QuantLib::HistoricalForwardRatesAnalysis>(properties, permanent)
     {
         libraryObject_ = ObjectHandler::Create<boost::shared_ptr<
-            QuantLib::HistoricalForwardRatesAnalysis> >()(traitsID,
+            QuantLib::HistoricalForwardRatesAnalysis> >()(historicalForwardRatesAnalysisCache,
+                                              traitsID,
                                               interpolatorID,
                                               stats,
                                               startDate,
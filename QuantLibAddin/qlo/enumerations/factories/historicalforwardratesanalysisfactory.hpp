@@ -69,9 +69,39 @@ namespace ObjectHandler {
                 const std::vector<boost::shared_ptr<QuantLib::SwapIndex> >& swapIndexes,
                 const QuantLib::DayCounter& yieldCurveDayCounter,
                 QuantLib::Real yieldCurveAccuracy) {
-            KeyPair key(traitsID, interpolatorID);
             HistoricalForwardRatesAnalysisConstructor historicalForwardRatesAnalysisConstructor =
-                reinterpret_cast<HistoricalForwardRatesAnalysisConstructor>(getType(key));
+                reinterpret_cast<HistoricalForwardRatesAnalysisConstructor>(getType(traitsID, interpolatorID));
+            return historicalForwardRatesAnalysisConstructor(
+                stats,
+                startDate,
+                endDate,
+                step,
+                fwdIndex,
+                initialGap,
+                horizon,
+                iborIndexes,
+                swapIndexes,
+                yieldCurveDayCounter,
+                yieldCurveAccuracy);
+        }
+        //! As above, through the memo of the call site.
+        boost::shared_ptr<QuantLib::HistoricalForwardRatesAnalysis> operator() (
+                CreateCache& cache,
+                const std::string& traitsID,
+                const std::string& interpolatorID,
+                const boost::shared_ptr<QuantLib::SequenceStatistics>& stats,
+                const QuantLib::Date& startDate,
+                const QuantLib::Date& endDate,
+                const QuantLib::Period& step,
+                const boost::shared_ptr<QuantLib::InterestRateIndex>& fwdIndex,
+                const QuantLib::Period& initialGap,
+                const QuantLib::Period& horizon,
+                const std::vector<boost::shared_ptr<QuantLib::IborIndex> >& iborIndexes,
+                const std::vector<boost::shared_ptr<QuantLib::SwapIndex> >& swapIndexes,
+                const QuantLib::DayCounter& yieldCurveDayCounter,
+                QuantLib::Real yieldCurveAccuracy) {
+            HistoricalForwardRatesAnalysisConstructor historicalForwardRatesAnalysisConstructor =
+                reinterpret_cast<HistoricalForwardRatesAnalysisConstructor>(getType(cache, traitsID, interpolatorID));
             return historicalForwardRatesAnalysisConstructor(
                 stats,
                 startDate,
@@ -69,9 +69,29 @@ namespace ObjectHandler {
                 const QuantLib::Real accuracy,
                 const QuantLib::MixedInterpolation::Behavior behavior,
                 const QuantLib::Size n) {
-            KeyPair key(traitsID, interpolatorID);
             YieldTermStructureConstructor yieldTermStructureConstructor =
-                reinterpret_cast<YieldTermStructureConstructor>(getType(key));
+                reinterpret_cast<YieldTermStructureConstructor>(getType(traitsID, interpolatorID));
+            return yieldTermStructureConstructor(nDays, calendar,
+                                                 rh, dayCounter,
+                                                 jumps, jumpDates,
+                                                 accuracy, behavior, n);
+        }
+        //! As above, through the memo of the call site.
+        boost::shared_ptr<QuantLib::YieldTermStructure> operator() (
+                CreateCache& cache,
+                const std::string& traitsID,
+                const std::string& interpolatorID,
+                QuantLib::Natural nDays,
+                const QuantLib::Calendar& calendar,
+                const std::vector<boost::shared_ptr<QuantLib::RateHelper> >& rh,
+                const QuantLib::DayCounter& dayCounter,
+                const std::vector<QuantLib::Handle<QuantLib::Quote> >& jumps,
+                const std::vector<QuantLib::Date>& jumpDates,
+                const QuantLib::Real accuracy,
+                const QuantLib::MixedInterpolation::Behavior behavior,
+                const QuantLib::Size n) {
+            YieldTermStructureConstructor yieldTermStructureConstructor =
+                reinterpret_cast<YieldTermStructureConstructor>(getType(cache, traitsID, interpolatorID));
             return yieldTermStructureConstructor(nDays, calendar,
                                                  rh, dayCounter,
                                                  jumps, jumpDates,
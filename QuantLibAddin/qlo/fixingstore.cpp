@@ -0,0 +1,305 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <qlo/config.hpp>
+#endif
+
+#include <qlo/fixingstore.hpp>
+
+#include <ql/index.hpp>
+#include <ql/timeseries.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/algorithm/string/case_conv.hpp>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+
+using QuantLib::Date;
+using QuantLib::Real;
+using QuantLib::Size;
+using boost::int32_t;
+using boost::uint32_t;
+using boost::uint64_t;
+
+namespace QuantLibAddin {
+
+    namespace {
+
+        // The layout of the file, in the byte order of the machine which
+        // wrote it, which is recorded by the byteOrder field:
+        //     FileHeader
+        //     FileEntry[count], in order of name
+        //     for each entry, double[size] at valuesOffset and
+        //         int32_t[size] at datesOffset, each aligned to 8 bytes
+
+        const char fileMagic[8] = { 'Q', 'L', 'A', 'F', 'I', 'X', '\0', '\0' };
+        const uint32_t fileVersion = 2;
+        const uint32_t byteOrderMark = 0x01020304;
+
+        struct FileHeader {
+            char magic[8];
+            uint32_t byteOrder;
+            uint32_t version;
+            uint32_t count;
+            uint32_t reserved;
+        };
+
+        struct FileEntry {
+            char name[64];
+            uint64_t datesOffset;
+            uint64_t valuesOffset;
+            uint64_t size;
+        };
+
+        struct EntryLess {
+            bool operator()(const FileEntry& e, const std::string& name) const {
+                return std::strcmp(e.name, name.c_str()) < 0;
+            }
+        };
+
+        std::string tag(const std::string& name) {
+            return boost::algorithm::to_upper_copy(name);
+        }
+
+        uint64_t aligned(uint64_t offset) {
+            return (offset + 7) & ~uint64_t(7);
+        }
+
+        void pad(std::ofstream& out, uint64_t& offset) {
+            static const char zeros[8] = { 0 };
+            uint64_t next = aligned(offset);
+            out.write(zeros, static_cast<std::streamsize>(next - offset));
+            offset = next;
+        }
+
+    }
+
+    class FixingStore::Mapping {
+      public:
+        explicit Mapping(const std::string& fileName)
+        : file_(fileName.c_str(), boost::interprocess::read_only),
+          region_(file_, boost::interprocess::read_only) {
+            const char* data = static_cast<const char*>(region_.get_address());
+            Size size = region_.get_size();
+            QL_REQUIRE(size >= sizeof(FileHeader),
+                       "FixingStore: file " << fileName << " is too short");
+            const FileHeader* header = reinterpret_cast<const FileHeader*>(data);
+            QL_REQUIRE(std::memcmp(header->magic, fileMagic, sizeof(fileMagic)) == 0,
+                       "FixingStore: file " << fileName << " is not a fixing store");
+            QL_REQUIRE(header->byteOrder == byteOrderMark,
+                       "FixingStore: file " << fileName
+                       << " was written on a machine of different byte order");
+            QL_REQUIRE(header->version == fileVersion,
+                       "FixingStore: file " << fileName << " has version "
+                       << header->version << ", expected " << fileVersion);
+            QL_REQUIRE(header->count <= (size - sizeof(FileHeader)) / sizeof(FileEntry),
+                       "FixingStore: file " << fileName << " is truncated");
+            begin_ = reinterpret_cast<const FileEntry*>(data + sizeof(FileHeader));
+            end_ = begin_ + header->count;
+            for (const FileEntry* e = begin_; e != end_; ++e) {
+                // bound e->size before multiplying, so that the product
+                // cannot overflow
+                QL_REQUIRE(e->name[sizeof(e->name) - 1] == '\0'
+                           && e->size <= size / sizeof(double)
+                           && e->datesOffset % sizeof(int32_t) == 0
+                           && e->datesOffset <= size
+                           && e->size * sizeof(int32_t) <= size - e->datesOffset
+                           && e->valuesOffset % sizeof(double) == 0
+                           && e->valuesOffset <= size
+                           && e->size * sizeof(double) <= size - e->valuesOffset,
+                           "FixingStore: file " << fileName << " is corrupt");
+            }
+            data_ = data;
+        }
+
+        const FileEntry* begin() const { return begin_; }
+        const FileEntry* end() const { return end_; }
+
+        const FileEntry* find(const std::string& name) const {
+            std::string t = tag(name);
+            const FileEntry* e = std::lower_bound(begin_, end_, t, EntryLess());
+            return e != end_ && t == e->name ? e : 0;
+        }
+
+        History history(const FileEntry& e) const {
+            History h;
+            h.dates = reinterpret_cast<const int32_t*>(data_ + e.datesOffset);
+            h.values = reinterpret_cast<const double*>(data_ + e.valuesOffset);
+            h.size = static_cast<Size>(e.size);
+            return h;
+        }
+
+      private:
+        boost::interprocess::file_mapping file_;
+        boost::interprocess::mapped_region region_;
+        const char* data_;
+        const FileEntry* begin_;
+        const FileEntry* end_;
+    };
+
+    FixingStore::FixingStore(
+        const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+        const std::string& fileName,
+        bool permanent)
+    : ObjectHandler::Object(properties, permanent) {
+        try {
+            mapping_ = boost::shared_ptr<Mapping>(new Mapping(fileName));
+        } catch (const boost::interprocess::interprocess_exception& e) {
+            QL_FAIL("FixingStore: unable to map file " << fileName << ": " << e.what());
+        }
+    }
+
+    std::vector<std::string> FixingStore::names() const {
+        std::vector<std::string> ret;
+        ret.reserve(mapping_->end() - mapping_->begin());
+        for (const FileEntry* e = mapping_->begin(); e != mapping_->end(); ++e)
+            ret.push_back(e->name);
+        return ret;
+    }
+
+    bool FixingStore::hasHistory(const std::string& name) const {
+        return mapping_->find(name) != 0;
+    }
+
+    FixingStore::History FixingStore::history(const std::string& name) const {
+        const FileEntry* e = mapping_->find(name);
+        QL_REQUIRE(e, "FixingStore: no fixings for index " << name);
+        return mapping_->history(*e);
+    }
+
+    std::vector<Date> FixingStore::dates(const std::string& name) const {
+        History h = history(name);
+        std::vector<Date> ret;
+        ret.reserve(h.size);
+        for (Size i=0; i<h.size; ++i)
+            ret.push_back(Date(h.dates[i]));
+        return ret;
+    }
+
+    std::vector<Real> FixingStore::values(const std::string& name) const {
+        History h = history(name);
+        return std::vector<Real>(h.values, h.values + h.size);
+    }
+
+    Real FixingStore::fixing(const std::string& name, const Date& date) const {
+        History h = history(name);
+        const int32_t* d = std::lower_bound(h.dates, h.dates + h.size,
+                                            static_cast<int32_t>(date.serialNumber()));
+        QL_REQUIRE(d != h.dates + h.size && *d == date.serialNumber(),
+                   "FixingStore: no fixing for index " << name << " on " << date);
+        return h.values[d - h.dates];
+    }
+
+    void writeFixingStore(const std::string& fileName,
+                          const std::vector<boost::shared_ptr<QuantLib::Index> >& indexes) {
+
+        // the histories by name, in the order of the entries
+        typedef std::map<std::string, std::pair<std::vector<int32_t>, std::vector<double> > > Histories;
+        Histories histories;
+        for (Size i=0; i<indexes.size(); ++i) {
+            std::string name = tag(indexes[i]->name());
+            QL_REQUIRE(name.size() < sizeof(FileEntry().name),
+                       "FixingStore: index name " << name << " is too long");
+            if (histories.find(name) != histories.end())
+                continue;
+            std::pair<std::vector<int32_t>, std::vector<double> >& h = histories[name];
+            const QuantLib::TimeSeries<Real>& series = indexes[i]->timeSeries();
+            h.first.reserve(series.size());
+            h.second.reserve(series.size());
+            for (QuantLib::TimeSeries<Real>::const_iterator s = series.begin();
+                 s != series.end(); ++s) {
+                if (s->second != QuantLib::Null<Real>()) {
+                    h.first.push_back(static_cast<int32_t>(s->first.serialNumber()));
+                    h.second.push_back(s->second);
+                }
+            }
+        }
+
+        FileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+        header.byteOrder = byteOrderMark;
+        header.version = fileVersion;
+        header.count = static_cast<uint32_t>(histories.size());
+
+        std::vector<FileEntry> entries;
+        entries.reserve(histories.size());
+        uint64_t offset = sizeof(FileHeader) + histories.size() * sizeof(FileEntry);
+        for (Histories::const_iterator i = histories.begin(); i != histories.end(); ++i) {
+            FileEntry e;
+            std::memset(&e, 0, sizeof(e));
+            std::strcpy(e.name, i->first.c_str());
+            e.size = i->second.first.size();
+            e.valuesOffset = aligned(offset);
+            e.datesOffset = e.valuesOffset + e.size * sizeof(double);
+            offset = e.datesOffset + e.size * sizeof(int32_t);
+            entries.push_back(e);
+        }
+
+        std::string tempName = fileName + ".tmp";
+        {
+            std::ofstream out(tempName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            QL_REQUIRE(out, "FixingStore: unable to open file " << tempName);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            if (!entries.empty())
+                out.write(reinterpret_cast<const char*>(&entries[0]),
+                          static_cast<std::streamsize>(entries.size() * sizeof(FileEntry)));
+            offset = sizeof(FileHeader) + entries.size() * sizeof(FileEntry);
+            for (Histories::const_iterator i = histories.begin(); i != histories.end(); ++i) {
+                const std::vector<int32_t>& d = i->second.first;
+                const std::vector<double>& v = i->second.second;
+                pad(out, offset);
+                if (!d.empty()) {
+                    out.write(reinterpret_cast<const char*>(&v[0]),
+                              static_cast<std::streamsize>(v.size() * sizeof(double)));
+                    out.write(reinterpret_cast<const char*>(&d[0]),
+                              static_cast<std::streamsize>(d.size() * sizeof(int32_t)));
+                }
+                offset += v.size() * sizeof(double) + d.size() * sizeof(int32_t);
+            }
+            QL_REQUIRE(out, "FixingStore: error writing file " << tempName);
+        }
+
+#if defined(_WIN32)
+        // rename() does not replace an existing file on Windows, replace it
+        // in a single step so that the file is never missing
+        QL_REQUIRE(MoveFileExA(tempName.c_str(), fileName.c_str(),
+                               MOVEFILE_REPLACE_EXISTING) != 0,
+                   "FixingStore: unable to replace " << fileName << " with "
+                   << tempName << " (error " << GetLastError()
+                   << "), it may be mapped by another process");
+#else
+        QL_REQUIRE(std::rename(tempName.c_str(), fileName.c_str()) == 0,
+                   "FixingStore: unable to rename " << tempName << " to " << fileName);
+#endif
+    }
+
+}
+
@@ -0,0 +1,93 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+/*! \file
+    \brief Class FixingStore - Fixing histories in a file mapped read-only
+*/
+
+#ifndef qla_fixingstore_hpp
+#define qla_fixingstore_hpp
+
+#include <oh/object.hpp>
+
+#include <ql/types.hpp>
+
+#include <boost/cstdint.hpp>
+#include <string>
+#include <vector>
+
+namespace QuantLib {
+    class Date;
+    class Index;
+}
+
+namespace QuantLibAddin {
+
+    //! Fixing histories of any number of indexes in a file mapped read-only.
+    /*! The file holds, for each index name, a sorted array of date serial
+        numbers and the corresponding array of fixings.  The file is mapped
+        into memory rather than read, so that the processes on a machine
+        which open the same file share a single copy of the histories, and
+        fixings are looked up by binary search in the mapped arrays.
+
+        Files are written by writeFixingStore().  Index names are matched
+        without regard to case, as by QuantLib::IndexManager.
+    */
+    class FixingStore : public ObjectHandler::Object {
+      public:
+        FixingStore(const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+                    const std::string& fileName,
+                    bool permanent);
+
+        //! The history of one index, pointing into the mapped file.
+        struct History {
+            History() : dates(0), values(0), size(0) {}
+            const boost::int32_t* dates;
+            const double* values;
+            QuantLib::Size size;
+        };
+
+        //! The names of the indexes in the file, in alphabetical order.
+        std::vector<std::string> names() const;
+        bool hasHistory(const std::string& name) const;
+        //! The history of the given index, which must be in the file.
+        History history(const std::string& name) const;
+        std::vector<QuantLib::Date> dates(const std::string& name) const;
+        std::vector<QuantLib::Real> values(const std::string& name) const;
+        //! The fixing of the given index on the given date, which must be in the file.
+        QuantLib::Real fixing(const std::string& name, const QuantLib::Date& date) const;
+
+      private:
+        class Mapping;
+        boost::shared_ptr<Mapping> mapping_;
+    };
+
+    //! Write the fixing histories of the given indexes to a FixingStore file.
+    /*! The file is written under a temporary name and then renamed, so
+        that processes which have mapped the previous version of the file
+        are not disturbed.  On Windows a file which is mapped cannot be
+        replaced, and writing it fails until the FixingStore objects which
+        map it are deleted.  Indexes which share a name share a history and
+        are written once.
+    */
+    void writeFixingStore(const std::string& fileName,
+                          const std::vector<boost::shared_ptr<QuantLib::Index> >& indexes);
+
+}
+
+#endif
+
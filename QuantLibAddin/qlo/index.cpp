@@ -25,12 +25,51 @@
 #endif
 
 #include <qlo/index.hpp>
+#include <qlo/fixingstore.hpp>
 
 #include <ql/timeseries.hpp>
 #include <ql/index.hpp>
 
 namespace QuantLibAddin {
 
+    namespace {
+
+        // Append the numbers held by a fixing history property, a vector
+        // held either contiguously or as a (shared) vector of property_t.
+        void appendValues(const ObjectHandler::property_base& p,
+                          std::vector<double>& values) {
+            typedef ObjectHandler::SharedValue<std::vector<double> > Shared;
+            typedef ObjectHandler::SharedValue<std::vector<ObjectHandler::property_t> >
+                SharedProperties;
+            if (const Shared* shared = boost::get<Shared>(&p)) {
+                values.insert(values.end(), (*shared)->begin(), (*shared)->end());
+            } else if (const ObjectHandler::property_t::vector* v =
+                           boost::get<ObjectHandler::property_t::vector>(&p)) {
+                for (ObjectHandler::property_t::vector::const_iterator i = v->begin();
+                     i != v->end(); ++i)
+                    appendValues(*i, values);
+            } else if (const SharedProperties* shared = boost::get<SharedProperties>(&p)) {
+                for (std::vector<ObjectHandler::property_t>::const_iterator i = (*shared)->begin();
+                     i != (*shared)->end(); ++i)
+                    appendValues(*i, values);
+            } else if (const long* l = boost::get<long>(&p)) {
+                values.push_back(*l);
+            } else if (const int* n = boost::get<int>(&p)) {
+                values.push_back(*n);
+            } else if (const double* d = boost::get<double>(&p)) {
+                values.push_back(*d);
+            } else {
+                QL_FAIL("unexpected value in fixing history");
+            }
+        }
+
+    }
+
+    Index::Index(const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+                 bool permanent)
+    : ObjectHandler::LibraryObject<QuantLib::Index>(properties, permanent),
+      fixingsChanged_(false) {}
+
     void Index::addFixings(const std::vector<QuantLib::Date>& dates,
                            const std::vector<QuantLib::Real>& values,
                            bool forceOverwrite, bool updateValuObject) {
@@ -39,6 +78,8 @@ namespace QuantLibAddin {
                    ") and values (" << values.size() << ")");
         std::vector<QuantLib::Date> d;
         std::vector<QuantLib::Real> v;
+        d.reserve(dates.size());
+        v.reserve(values.size());
         for (QuantLib::Size i=0; i<values.size(); ++i) {
             // skip null fixings
             if (values[i]!=QuantLib::Null<QuantLib::Real>()) {
@@ -50,18 +91,59 @@ namespace QuantLibAddin {
                                    v.begin(), forceOverwrite);
 
         if (updateValuObject) {
-            std::vector<long> fixingDates;
-            std::vector<QuantLib::Real> fixingRates;
-            const QuantLib::TimeSeries<QuantLib::Real>& history = libraryObject_->timeSeries();
-            for (QuantLib::TimeSeries<QuantLib::Real>::const_iterator hi = history.begin();
-                 hi != history.end(); ++hi) {
-                fixingDates.push_back(hi->first.serialNumber());
-                fixingRates.push_back(hi->second);
-            }
-            boost::shared_ptr<ObjectHandler::ValueObject> inst_properties = properties();
-            inst_properties->setProperty("IndexFixingDates", fixingDates);
-            inst_properties->setProperty("IndexFixingRates", fixingRates);
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+            boost::mutex::scoped_lock lock(mutex_);
+#endif
+            fixingsChanged_ = true;
+        }
+    }
+
+    void Index::loadFixings(const ObjectHandler::property_t& dates,
+                            const ObjectHandler::property_t& rates) {
+        std::vector<double> serials, values;
+        appendValues(dates, serials);
+        appendValues(rates, values);
+        QL_REQUIRE(serials.size()==values.size(),
+                   "size mismatch between fixing dates (" << serials.size() <<
+                   ") and rates (" << values.size() << ")");
+        std::vector<QuantLib::Date> d;
+        d.reserve(serials.size());
+        for (std::vector<double>::const_iterator i = serials.begin(); i != serials.end(); ++i)
+            d.push_back(QuantLib::Date(static_cast<QuantLib::BigInteger>(*i)));
+        addFixings(d, values, true);
+    }
+
+    void Index::addFixingsFromStore(const boost::shared_ptr<FixingStore>& store,
+                                    bool forceOverwrite) {
+        FixingStore::History history = store->history(libraryObject_->name());
+        std::vector<QuantLib::Date> d;
+        d.reserve(history.size);
+        for (QuantLib::Size i=0; i<history.size; ++i)
+            d.push_back(QuantLib::Date(history.dates[i]));
+        addFixings(d, std::vector<QuantLib::Real>(history.values, history.values + history.size),
+                   forceOverwrite);
+    }
+
+    void Index::publishProperties() const {
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        boost::mutex::scoped_lock lock(mutex_);
+#endif
+        if (!fixingsChanged_)
+            return;
+        const QuantLib::TimeSeries<QuantLib::Real>& history = libraryObject_->timeSeries();
+        std::vector<long> fixingDates;
+        std::vector<QuantLib::Real> fixingRates;
+        fixingDates.reserve(history.size());
+        fixingRates.reserve(history.size());
+        for (QuantLib::TimeSeries<QuantLib::Real>::const_iterator hi = history.begin();
+             hi != history.end(); ++hi) {
+            fixingDates.push_back(hi->first.serialNumber());
+            fixingRates.push_back(hi->second);
         }
+        boost::shared_ptr<ObjectHandler::ValueObject> inst_properties = properties();
+        inst_properties->setProperty("IndexFixingDates", fixingDates);
+        inst_properties->setProperty("IndexFixingRates", fixingRates);
+        fixingsChanged_ = false;
     }
 
 }
@@ -24,9 +24,14 @@
 #define qla_index_hpp
 
 #include <oh/libraryobject.hpp>
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+#include <boost/thread/mutex.hpp>
+#endif
 
 #include <ql/types.hpp>
 
+#include <vector>
+
 namespace QuantLib {
     class Date;
     class Index;
@@ -34,13 +39,42 @@ namespace QuantLib {
 
 namespace QuantLibAddin {
 
-    class Index : public ObjectHandler::LibraryObject<QuantLib::Index> {
+    class FixingStore;
+
+    //! Addin wrapper of QuantLib::Index which records the fixing history in its ValueObject.
+    /*! addFixings() does not copy the history into the ValueObject, it only
+        records that the copy is out of date.  The properties
+        IndexFixingDates and IndexFixingRates are rebuilt from
+        QuantLib::Index::timeSeries(), as flat vectors of date serial
+        numbers and of rates, when the ValueObject is next read, e.g. to be
+        serialized, see ObjectHandler::PropertyPublisher.  Any number of
+        calls to addFixings() therefore copy the whole history once.
+    */
+    class Index : public ObjectHandler::LibraryObject<QuantLib::Index>,
+                  public ObjectHandler::PropertyPublisher {
       public:
         void addFixings(const std::vector<QuantLib::Date>& dates,
                         const std::vector<QuantLib::Real>& values,
                         bool forceOverwrite, bool updateValuObject = true);
+        //! Restore a history saved in the IndexFixingDates and IndexFixingRates properties.
+        /*! The fixings are passed to the library in a single call.
+        */
+        void loadFixings(const ObjectHandler::property_t& dates,
+                         const ObjectHandler::property_t& rates);
+        //! Add the fixings of this index held by the given FixingStore.
+        void addFixingsFromStore(const boost::shared_ptr<FixingStore>& store,
+                                 bool forceOverwrite);
+        //! Write the fixing history to the ValueObject if it has changed.
+        void publishProperties() const;
       public:
-        OH_LIB_CTOR(Index, QuantLib::Index);
+        Index(const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+              bool permanent);
+      private:
+        // Whether the fixing history has changed since it was last published.
+        mutable bool fixingsChanged_;
+#ifdef OH_ENABLE_THREAD_SAFE_REPOSITORY
+        mutable boost::mutex mutex_;
+#endif
     };
 
 }
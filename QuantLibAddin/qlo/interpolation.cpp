@@ -22,11 +22,17 @@
 #endif
 #include <qlo/interpolation.hpp>
 #include <qlo/enumerations/factories/interpolationsfactory.hpp>
+#include <qlo/conversions/varianttoquotehandle.hpp>
 
 #include <ql/math/interpolations/linearinterpolation.hpp>
 #include <ql/math/interpolations/backwardflatinterpolation.hpp>
 #include <ql/math/interpolations/forwardflatinterpolation.hpp>
 
+#include <boost/algorithm/string/predicate.hpp>
+
+#include <algorithm>
+#include <cmath>
+
 // fix for gcc
 #ifdef __GNUC__
 namespace QuantLib {
@@ -35,7 +41,6 @@ namespace QuantLib {
 };
 #endif
 
-using std::pair;
 using std::vector;
 
 using boost::shared_ptr;
@@ -43,6 +48,7 @@ using boost::dynamic_pointer_cast;
 
 using ObjectHandler::ValueObject;
 using ObjectHandler::Create;
+using ObjectHandler::property_t;
 
 using QuantLib::Real;
 using QuantLib::Size;
@@ -54,22 +60,174 @@ using QuantLib::Quote;
 namespace QuantLibAddin {
 
     namespace {
-        class QuoteHandleSorter {
+        // Order the indexes of a vector of points by the points.
+        class PointSorter {
           public:
-            bool operator()(const pair<Real, Handle<Quote> >& h1,
-                            const pair<Real, Handle<Quote> >& h2) const {
-                if (h1.first >= h2.first)
-                    return false;
-                return true;
+            explicit PointSorter(const vector<Real>& x) : x_(x) {}
+            bool operator()(Size i, Size j) const {
+                return x_[i] < x_[j];
             }
+          private:
+            const vector<Real>& x_;
         };
+
+        // Point h at the quote identified by the given property, unless the
+        // property is a literal value, which cannot have been recreated.
+        void resolveQuote(Handle<Quote>& h, const property_t& id) {
+            if (id.type() == typeid(std::string))
+                h = ObjectHandler::convert2<Handle<Quote> >(id);
+        }
+
+        // The kernels below are written as simple loops over contiguous
+        // arrays, free of calls and of data-dependent branches, so that
+        // the compiler is able to vectorize them.
+
+        // y[i] + (x-x[i])*s[i], as QuantLib::LinearInterpolation
+        void linearKernel(const vector<Real>& xGrid, const vector<Real>& yGrid,
+                          const vector<Real>& x, const vector<Size>& intervals,
+                          vector<Real>& result) {
+            Size n = xGrid.size(), m = x.size();
+            vector<Real> slopes(n-1);
+            for (Size i=0; i<n-1; ++i)
+                slopes[i] = (yGrid[i+1]-yGrid[i])/(xGrid[i+1]-xGrid[i]);
+            const Real* xg = &xGrid[0];
+            const Real* yg = &yGrid[0];
+            const Real* s = &slopes[0];
+            const Size* interval = &intervals[0];
+            const Real* xp = &x[0];
+            Real* r = &result[0];
+            for (Size k=0; k<m; ++k) {
+                Size i = interval[k];
+                r[k] = yg[i] + (xp[k]-xg[i])*s[i];
+            }
+        }
+
+        // y[0] below the grid, otherwise y[i] at a node and y[i+1]
+        // within an interval, as QuantLib::BackwardFlatInterpolation
+        void backwardFlatKernel(const vector<Real>& xGrid, const vector<Real>& yGrid,
+                                const vector<Real>& x, const vector<Size>& intervals,
+                                vector<Real>& result) {
+            Size m = x.size();
+            const Real* xg = &xGrid[0];
+            const Real* yg = &yGrid[0];
+            const Size* interval = &intervals[0];
+            const Real* xp = &x[0];
+            Real* r = &result[0];
+            Real x0 = xg[0];
+            for (Size k=0; k<m; ++k) {
+                Size i = interval[k];
+                Size j = (xp[k] <= x0) ? 0 : (xp[k] == xg[i] ? i : i+1);
+                r[k] = yg[j];
+            }
+        }
+
+        // y[n-1] above the grid, otherwise y[i], as
+        // QuantLib::ForwardFlatInterpolation
+        void forwardFlatKernel(const vector<Real>& xGrid, const vector<Real>& yGrid,
+                               const vector<Real>& x, const vector<Size>& intervals,
+                               vector<Real>& result) {
+            Size n = xGrid.size(), m = x.size();
+            const Real* yg = &yGrid[0];
+            const Size* interval = &intervals[0];
+            const Real* xp = &x[0];
+            Real* r = &result[0];
+            Real xn = xGrid[n-1];
+            for (Size k=0; k<m; ++k) {
+                Size j = (xp[k] >= xn) ? n-1 : interval[k];
+                r[k] = yg[j];
+            }
+        }
+    }
+
+    void locateIntervals(const vector<Real>& grid,
+                         const vector<Real>& x,
+                         vector<Size>& intervals) {
+        Size n = grid.size(), m = x.size();
+        QL_REQUIRE(n >= 2, "at least two grid points required, " << n << " given");
+        intervals.resize(m);
+
+        // visit the points in ascending order
+        vector<Size> order;
+        bool sorted = true;
+        for (Size k=1; k<m && sorted; ++k)
+            sorted = !(x[k] < x[k-1]);
+        if (!sorted) {
+            order.resize(m);
+            for (Size k=0; k<m; ++k)
+                order[k] = k;
+            std::sort(order.begin(), order.end(), PointSorter(x));
+        }
+
+        // i is the last node not above the current point, but not beyond
+        // the start of the last interval
+        Size i = 0;
+        for (Size k=0; k<m; ++k) {
+            Size p = sorted ? k : order[k];
+            while (i < n-2 && grid[i+1] <= x[p])
+                ++i;
+            intervals[p] = i;
+        }
+    }
+
+    vector<Real> Interpolation::values(const vector<Real>& x,
+                                       bool allowExtrapolation) const {
+        calculate();
+        Size m = x.size();
+        vector<Real> result(m);
+        if (m == 0)
+            return result;
+
+        // Points out of range are passed to the library, so that the
+        // error raised is the same as that for a single point.
+        if (!allowExtrapolation && !qlInterpolation_->allowsExtrapolation()) {
+            for (Size k=0; k<m; ++k) {
+                if (!qlInterpolation_->isInRange(x[k]))
+                    qlInterpolation_->operator()(x[k], false);
+            }
+        }
+
+        if (kernel_ == Library || n_ < 2) {
+            for (Size k=0; k<m; ++k)
+                result[k] = qlInterpolation_->operator()(x[k], true);
+            return result;
+        }
+
+        vector<Size> intervals;
+        locateIntervals(x_, x, intervals);
+        switch (kernel_) {
+          case Linear:
+            linearKernel(x_, y_, x, intervals, result);
+            break;
+          case LogLinear:
+            {
+                vector<Real> logY(n_);
+                for (Size i=0; i<n_; ++i) {
+                    QL_REQUIRE(y_[i]>0.0,
+                               "invalid value (" << y_[i] << ") at index " << i);
+                    logY[i] = std::log(y_[i]);
+                }
+                linearKernel(x_, logY, x, intervals, result);
+                for (Size k=0; k<m; ++k)
+                    result[k] = std::exp(result[k]);
+            }
+            break;
+          case BackwardFlat:
+            backwardFlatKernel(x_, y_, x, intervals, result);
+            break;
+          case ForwardFlat:
+            forwardFlatKernel(x_, y_, x, intervals, result);
+            break;
+          default:
+            QL_FAIL("unknown interpolation kernel (" << kernel_ << ")");
+        }
+        return result;
     }
 
     Interpolation::Interpolation(const shared_ptr<ValueObject>& prop,
                                  const vector<Real>& x,
                                  const vector<Handle<Quote> >& yh,
                                  bool permanent)
-    : Extrapolator(prop, permanent)
+    : Extrapolator(prop, permanent), kernel_(Library)
     {
         QL_REQUIRE(!x.empty(), "empty x vector");
         Size n = x.size();
@@ -79,26 +237,24 @@ namespace QuantLibAddin {
         x_.reserve(n);
         yh_.reserve(n);
         y_.reserve(n);
+        order_.reserve(n);
+        inputSize_ = n;
 
-        vector<pair<Real, Handle<Quote> > > pairs(n);
+        vector<Size> order(n);
         for (Size i=0; i<n; ++i)
-            pairs[i] = std::make_pair(x[i], yh[i]);
-        std::sort(pairs.begin(), pairs.end(), QuoteHandleSorter());
-
-        vector<pair<Real, Handle<Quote> > >::iterator j=pairs.begin();
-        x_.push_back(j->first);
-        yh_.push_back(j->second);
-        registerWith(yh_.back());
-        yh_.back()->isValid() ? y_.push_back(yh_.back()->value())
-                              : y_.push_back(1.0);
-        for (j=pairs.begin()+1; j<pairs.end(); ++j) {
-            if (x_.back() == j->first) {
-                QL_ENSURE(yh_.back() == j->second,
-                          "duplicated x value (" << j->first <<
+            order[i] = i;
+        std::sort(order.begin(), order.end(), PointSorter(x));
+
+        for (vector<Size>::const_iterator j=order.begin(); j<order.end(); ++j) {
+            if (!x_.empty() && x_.back() == x[*j]) {
+                QL_ENSURE(yh_.back() == yh[*j],
+                          "duplicated x value (" << x[*j] <<
                           ") with different y values");
+                duplicates_.push_back(std::make_pair(*j, x_.size()-1));
             } else {
-                x_.push_back(j->first);
-                yh_.push_back(j->second);
+                x_.push_back(x[*j]);
+                yh_.push_back(yh[*j]);
+                order_.push_back(*j);
                 registerWith(yh_.back());
                 yh_.back()->isValid() ? y_.push_back(yh_.back()->value())
                                       : y_.push_back(1.0);
@@ -113,6 +269,37 @@ namespace QuantLibAddin {
         qlInterpolation_->update();
     }
 
+    bool Interpolation::refresh(const ValueObject& valueObject) {
+        vector<property_t> yArray =
+            ObjectHandler::vector::convert2<property_t>(
+                valueObject.getProperty("YArray"), "YArray");
+        if (yArray.size() != inputSize_)
+            return false;
+
+        // resolve every quote before changing anything, so that the object
+        // is left alone if it has to be recreated
+        vector<Handle<Quote> > yh(yh_);
+        for (Size i=0; i<n_; ++i)
+            resolveQuote(yh[i], yArray[order_[i]]);
+        for (vector<std::pair<Size, Size> >::const_iterator d = duplicates_.begin();
+             d != duplicates_.end(); ++d) {
+            Handle<Quote> h = yh[d->second];
+            resolveQuote(h, yArray[d->first]);
+            if (h.currentLink() != yh[d->second].currentLink())
+                return false;
+        }
+
+        for (Size i=0; i<n_; ++i) {
+            if (yh[i].currentLink() != yh_[i].currentLink()) {
+                unregisterWith(yh_[i]);
+                yh_[i] = yh[i];
+                registerWith(yh_[i]);
+            }
+        }
+        update();
+        return true;
+    }
+
     GenericInterp::GenericInterp(const shared_ptr<ValueObject>& p,
                                  const std::string& type,
                                  const vector<Real>& x,
@@ -124,6 +311,15 @@ namespace QuantLibAddin {
             (type, x_.begin(), x_.end(), y_.begin());
         qlInterpolation_ = dynamic_pointer_cast<QuantLib::Interpolation>(
             libraryObject_);
+
+        if (boost::algorithm::iequals(type, "Linear"))
+            kernel_ = Linear;
+        else if (boost::algorithm::iequals(type, "LogLinear"))
+            kernel_ = LogLinear;
+        else if (boost::algorithm::iequals(type, "BackwardFlat"))
+            kernel_ = BackwardFlat;
+        else if (boost::algorithm::iequals(type, "ForwardFlat"))
+            kernel_ = ForwardFlat;
     }
 
     MixedLinearCubicInterpolation::MixedLinearCubicInterpolation(
@@ -246,6 +442,7 @@ namespace QuantLibAddin {
             libraryObject_);
         qlSABRInterpolation_ = dynamic_pointer_cast<QuantLib::SABRInterpolation>(
             libraryObject_);
+        registerWith(forwardh_);
     }
 
 }
@@ -44,6 +44,18 @@ namespace QuantLib {
 
 namespace QuantLibAddin {
 
+    //! Find the interval of the grid which holds each of the given points.
+    /*! On return intervals[k] is the index i of the interval
+        [grid[i], grid[i+1]) which holds x[k], clamped to the first and last
+        intervals, as located by QuantLib::Interpolation.  The grid must be
+        sorted and hold at least two points.  If x is sorted, the points are
+        located in a single sweep through the grid, otherwise the points are
+        sorted first.
+    */
+    void locateIntervals(const std::vector<QuantLib::Real>& grid,
+                         const std::vector<QuantLib::Real>& x,
+                         std::vector<QuantLib::Size>& intervals);
+
     class Interpolation : public Extrapolator, public QuantLib::LazyObject {
       public:
         QuantLib::Real operator()(QuantLib::Real x,
@@ -66,16 +78,46 @@ namespace QuantLibAddin {
             calculate();
             return qlInterpolation_->secondDerivative(x, allowExtrapolation);
         }
+        //! Interpolated values at the given points, in the order given.
+        /*! Equivalent to calling operator() on each point, but the points
+            are located in a single sweep, and linear, log-linear and flat
+            interpolations are evaluated over whole arrays without going
+            through the library.
+        */
+        std::vector<QuantLib::Real> values(const std::vector<QuantLib::Real>& x,
+                                           bool allowExtrapolation) const;
         void performCalculations() const;
+        //! Relink the y quotes whose objects have been recreated.
+        /*! The points keep their sorted order and the quotes which have
+            not changed keep their registrations, only the handles of the
+            changed quotes are replaced.  The interpolation is recalculated
+            from the new values on next use.
+
+            Returns false, leaving the object unchanged, if points which
+            share an x value no longer share their quote, so that the
+            object is recreated and the constructor reports the error.
+            Only classes whose y quotes are their only precedents may opt
+            in to refresh.
+        */
+        bool refresh(const ObjectHandler::ValueObject& valueObject);
       protected:
         Interpolation(const boost::shared_ptr<ObjectHandler::ValueObject>&,
                       const std::vector<QuantLib::Real>& x,
                       const std::vector<QuantLib::Handle<QuantLib::Quote> >& yh,
                       bool permanent);
+        //! The evaluation used by values(), Library unless set by a derived class.
+        enum Kernel { Library, Linear, LogLinear, BackwardFlat, ForwardFlat };
+        Kernel kernel_;
         QuantLib::Size n_;
         std::vector<QuantLib::Real> x_;
         std::vector<QuantLib::Handle<QuantLib::Quote> > yh_;
         mutable std::vector<QuantLib::Real> y_;
+        //! The position in the constructor arguments of each point of x_.
+        std::vector<QuantLib::Size> order_;
+        //! The position in the constructor arguments of each repeated
+        //! point, and the point of x_ which it repeats.
+        std::vector<std::pair<QuantLib::Size, QuantLib::Size> > duplicates_;
+        QuantLib::Size inputSize_;
         boost::shared_ptr<QuantLib::Interpolation> qlInterpolation_;
     };
 
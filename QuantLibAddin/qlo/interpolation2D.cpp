@@ -21,10 +21,13 @@
     #include <qlo/config.hpp>
 #endif
 #include <qlo/interpolation2D.hpp>
+#include <qlo/interpolation.hpp>
 #include <ql/math/interpolations/bilinearinterpolation.hpp>
 #include <ql/math/interpolations/bicubicsplineinterpolation.hpp>
 #include <qlo/enumerations/factories/interpolationsfactory.hpp>
 
+#include <boost/algorithm/string/predicate.hpp>
+
 namespace QuantLibAddin {
 
     Interpolation2D::Interpolation2D(
@@ -53,7 +56,54 @@ namespace QuantLibAddin {
         //    boost::any_cast<QuantLib::Matrix>(propertyValue("ZMATRIX"));
         libraryObject_ = ObjectHandler::Create<boost::shared_ptr<QuantLib::Interpolation2D> >()
             (interpolation2DType, x_.begin(), x_.end(), y_.begin(), y_.end(), dataMatrix_);
+        qlInterpolation2D_ =
+            boost::dynamic_pointer_cast<QuantLib::Interpolation2D>(libraryObject_);
+        bilinear_ = boost::algorithm::iequals(interpolation2DType, "BiLinear");
+    }
+
+    std::vector<QuantLib::Real> Interpolation2D::values(
+        const std::vector<QuantLib::Real>& x,
+        const std::vector<QuantLib::Real>& y,
+        bool allowExtrapolation) const {
+        QL_REQUIRE(x.size()==y.size(),
+                   "size mismatch between x (" << x.size() <<
+                   ") and y (" << y.size() << ")");
+        QuantLib::Size m = x.size();
+        std::vector<QuantLib::Real> result(m);
+        if (m == 0)
+            return result;
+
+        // Points out of range are passed to the library, so that the
+        // error raised is the same as that for a single point.
+        if (!allowExtrapolation && !qlInterpolation2D_->allowsExtrapolation()) {
+            for (QuantLib::Size k=0; k<m; ++k) {
+                if (!qlInterpolation2D_->isInRange(x[k], y[k]))
+                    qlInterpolation2D_->operator()(x[k], y[k], false);
+            }
+        }
+
+        if (!bilinear_ || x_.size() < 2 || y_.size() < 2) {
+            for (QuantLib::Size k=0; k<m; ++k)
+                result[k] = qlInterpolation2D_->operator()(x[k], y[k], true);
+            return result;
+        }
 
+        // as QuantLib::BilinearInterpolation
+        std::vector<QuantLib::Size> columns, rows;
+        locateIntervals(x_, x, columns);
+        locateIntervals(y_, y, rows);
+        for (QuantLib::Size k=0; k<m; ++k) {
+            QuantLib::Size i = columns[k], j = rows[k];
+            QuantLib::Real z1 = dataMatrix_[j][i];
+            QuantLib::Real z2 = dataMatrix_[j][i+1];
+            QuantLib::Real z3 = dataMatrix_[j+1][i];
+            QuantLib::Real z4 = dataMatrix_[j+1][i+1];
+            QuantLib::Real t = (x[k]-x_[i])/(x_[i+1]-x_[i]);
+            QuantLib::Real u = (y[k]-y_[j])/(y_[j+1]-y_[j]);
+            result[k] = (1.0-t)*(1.0-u)*z1 + t*(1.0-u)*z2
+                      + (1.0-t)*u*z3 + t*u*z4;
+        }
+        return result;
     }
   
 }
@@ -24,6 +24,10 @@
 #include <qlo/extrapolator.hpp>
 #include <ql/math/matrix.hpp>
 
+namespace QuantLib {
+    class Interpolation2D;
+}
+
 namespace QuantLibAddin {
 
     class Interpolation2D : public Extrapolator 
@@ -35,9 +39,20 @@ namespace QuantLibAddin {
                         const std::vector<double>& y,
                         const QuantLib::Matrix& dataMatrix,
                         bool permanent);
+        //! Interpolated values at the points (x[k], y[k]), in the order given.
+        /*! Equivalent to calling operator() on each point, but the x and
+            y values are each located in a single sweep, and bilinear
+            interpolations are evaluated over whole arrays without going
+            through the library.
+        */
+        std::vector<QuantLib::Real> values(const std::vector<QuantLib::Real>& x,
+                                           const std::vector<QuantLib::Real>& y,
+                                           bool allowExtrapolation) const;
       protected:
         std::vector<QuantLib::Real> x_, y_;
         QuantLib::Matrix dataMatrix_;
+        boost::shared_ptr<QuantLib::Interpolation2D> qlInterpolation2D_;
+        bool bilinear_;
     };
     
 }
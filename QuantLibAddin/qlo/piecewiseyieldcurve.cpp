@@ -33,6 +33,17 @@
 
 namespace QuantLibAddin {
 
+    namespace {
+        // Memos of the Create<> call sites in the constructors below,
+        // one for each call.
+        ObjectHandler::CreateCache mixedCurveCache;
+        ObjectHandler::CreateCache mixedTraitsCache;
+        ObjectHandler::CreateCache mixedInterpolatorCache;
+        ObjectHandler::CreateCache curveCache;
+        ObjectHandler::CreateCache traitsCache;
+        ObjectHandler::CreateCache interpolatorCache;
+    }
+
     // Constructor
 
     PiecewiseYieldCurve::PiecewiseYieldCurve(
@@ -52,7 +63,8 @@ namespace QuantLibAddin {
     : YieldTermStructure(properties, permanent)
     {
         libraryObject_ = ObjectHandler::Create<boost::shared_ptr<
-            QuantLib::YieldTermStructure> >()(traitsID,
+            QuantLib::YieldTermStructure> >()(mixedCurveCache,
+                                              traitsID,
                                               interpolatorID,
                                               nDays,
                                               calendar,
@@ -66,9 +78,9 @@ namespace QuantLibAddin {
 
 		// convert input strings to enumerated datatypes
 		InterpolatedYieldCurve::Traits traits =
-            ObjectHandler::Create<InterpolatedYieldCurve::Traits>()(traitsID);
+            ObjectHandler::Create<InterpolatedYieldCurve::Traits>()(mixedTraitsCache, traitsID);
 		InterpolatedYieldCurve::Interpolator interpolator=
-			ObjectHandler::Create<InterpolatedYieldCurve::Interpolator>()(interpolatorID);
+			ObjectHandler::Create<InterpolatedYieldCurve::Interpolator>()(mixedInterpolatorCache, interpolatorID);
 
 		pair_ = InterpolatedYieldCurvePair(traits, interpolator);
     }
@@ -88,7 +100,8 @@ namespace QuantLibAddin {
     : YieldTermStructure(properties, permanent)
     {
         libraryObject_ = ObjectHandler::Create<boost::shared_ptr<
-            QuantLib::YieldTermStructure> >()(traitsID,
+            QuantLib::YieldTermStructure> >()(curveCache,
+                                              traitsID,
                                               interpolatorID,
                                               nDays,
                                               calendar,
@@ -102,9 +115,9 @@ namespace QuantLibAddin {
 
         // convert input strings to enumerated datatypes
         InterpolatedYieldCurve::Traits traits =
-            ObjectHandler::Create<InterpolatedYieldCurve::Traits>()(traitsID);
+            ObjectHandler::Create<InterpolatedYieldCurve::Traits>()(traitsCache, traitsID);
         InterpolatedYieldCurve::Interpolator interpolator =
-            ObjectHandler::Create<InterpolatedYieldCurve::Interpolator>()(interpolatorID);
+            ObjectHandler::Create<InterpolatedYieldCurve::Interpolator>()(interpolatorCache, interpolatorID);
 
         pair_ = InterpolatedYieldCurvePair(traits, interpolator);
     }
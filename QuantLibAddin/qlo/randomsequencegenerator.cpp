@@ -22,6 +22,8 @@
 #endif
 #include <qlo/randomsequencegenerator.hpp>
 
+#include <oh/parallelloop.hpp>
+
 namespace QuantLibAddin {
 
     static QuantLib::MersenneTwisterUniformRng rng_;
@@ -34,16 +36,102 @@ namespace QuantLibAddin {
         rng_ = QuantLib::MersenneTwisterUniformRng(seed);
     }
 
+    namespace {
+
+        // The number of variates drawn at a time into a column-major
+        // buffer, which are drawn by rows and then transposed.
+        const QuantLib::Size blockSize = 32768;
+
+        // Sobol sequences are drawn in parallel only above this many
+        // samples, and in chunks of at least half as many, below it the
+        // cost of the threads and of the generators is not recovered.
+        const QuantLib::Size minimumParallelSamples = 1024;
+
+        // Draw a chunk of a Sobol sequence with a generator of its own,
+        // skipped ahead to the first sample of the chunk.  In column-major
+        // layout each chunk writes its own span of every column of a
+        // buffer holding samples sequences.
+        class SobolChunk {
+          public:
+            SobolChunk(QuantLib::Size dimension, unsigned long seed,
+                       unsigned long first, QuantLib::Size samples,
+                       RandomSequenceGenerator::Layout layout, double* buffer)
+            : dimension_(dimension), seed_(seed), first_(first),
+              samples_(samples), layout_(layout), buffer_(buffer) {}
+            void operator()(std::size_t begin, std::size_t end) {
+                QuantLib::SobolRsg rsg(dimension_, seed_);
+                rsg.skipTo(first_ + begin);
+                for (std::size_t i=begin; i<end; ++i) {
+                    const std::vector<QuantLib::Real>& s = rsg.nextSequence().value;
+                    if (layout_ == RandomSequenceGenerator::RowMajor) {
+                        std::copy(s.begin(), s.end(), buffer_ + i*dimension_);
+                    } else {
+                        for (QuantLib::Size j=0; j<dimension_; ++j)
+                            buffer_[j*samples_ + i] = s[j];
+                    }
+                }
+            }
+          private:
+            QuantLib::Size dimension_;
+            unsigned long seed_;
+            unsigned long first_;
+            QuantLib::Size samples_;
+            RandomSequenceGenerator::Layout layout_;
+            double* buffer_;
+        };
+
+    }
+
     std::vector<std::vector<double> >
-    RandomSequenceGenerator::variates(long samples)
+    RandomSequenceGenerator::variates(long samples, bool transposed, bool parallel)
     {
-        std::vector<std::vector<double> > rtn;
-        rtn.reserve(samples);
-        for (long i=0 ; i < samples ; ++i)
-            rtn.push_back(nextSequence());
+        QL_REQUIRE(samples >= 0, "negative number of samples: " << samples);
+        QuantLib::Size n = samples, dimension = this->dimension();
+        std::vector<double> buffer(n*dimension);
+        if (!buffer.empty())
+            fillVariates(samples, &buffer[0],
+                         transposed ? ColumnMajor : RowMajor, parallel);
+
+        QuantLib::Size rows = transposed ? dimension : n;
+        QuantLib::Size columns = transposed ? n : dimension;
+        std::vector<std::vector<double> > rtn(rows);
+        for (QuantLib::Size i=0; i<rows; ++i)
+            rtn[i].assign(buffer.begin() + i*columns,
+                          buffer.begin() + (i+1)*columns);
         return rtn;
     }
 
+    void RandomSequenceGenerator::fillVariates(long samples, double* buffer,
+                                               Layout layout, bool parallel)
+    {
+        QL_REQUIRE(samples >= 0, "negative number of samples: " << samples);
+        QuantLib::Size n = samples, dimension = this->dimension();
+        if (n == 0 || dimension == 0)
+            return;
+
+        if (layout == RowMajor)
+            drawSequences(n, buffer, parallel);
+        else
+            drawColumns(n, buffer, parallel);
+    }
+
+    void RandomSequenceGenerator::drawColumns(QuantLib::Size samples, double* buffer,
+                                              bool parallel)
+    {
+        QuantLib::Size dimension = this->dimension();
+        QuantLib::Size block = std::max<QuantLib::Size>(1, blockSize / dimension);
+        std::vector<double> rows(std::min(samples, block) * dimension);
+        for (QuantLib::Size first=0; first<samples; first+=block) {
+            QuantLib::Size m = std::min(block, samples - first);
+            drawSequences(m, &rows[0], parallel);
+            for (QuantLib::Size j=0; j<dimension; ++j) {
+                double* column = buffer + j*samples + first;
+                for (QuantLib::Size i=0; i<m; ++i)
+                    column[i] = rows[i*dimension + j];
+            }
+        }
+    }
+
     MersenneTwisterRsg::MersenneTwisterRsg(
             const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
             long dimension,
@@ -70,7 +158,39 @@ namespace QuantLibAddin {
             long dimension,
             long seed,
             bool permanent)
-    : LowDiscrepancySequenceGenerator<rsg_type>(properties, rsg_type(dimension, seed), permanent) {}
+    : LowDiscrepancySequenceGenerator<rsg_type>(properties, rsg_type(dimension, seed), permanent),
+      dimension_(dimension), seed_(seed) {}
+
+    void SobolRsg::drawSequences(QuantLib::Size samples, double* buffer,
+                                 bool parallel) {
+        if (!parallel || samples < minimumParallelSamples)
+            LowDiscrepancySequenceGenerator<rsg_type>::drawSequences(
+                samples, buffer, parallel);
+        else
+            drawParallel(samples, buffer, RowMajor);
+    }
 
-}
+    // Unlike the default, which transposes one block at a time, the whole
+    // range is split into chunks at once, so that samples/dimension does
+    // not fall below the parallel threshold for high dimensions.
+    void SobolRsg::drawColumns(QuantLib::Size samples, double* buffer,
+                               bool parallel) {
+        if (!parallel || samples < minimumParallelSamples)
+            LowDiscrepancySequenceGenerator<rsg_type>::drawColumns(
+                samples, buffer, parallel);
+        else
+            drawParallel(samples, buffer, ColumnMajor);
+    }
+
+    void SobolRsg::drawParallel(QuantLib::Size samples, double* buffer,
+                                Layout layout) {
+        SobolChunk chunk(dimension_, seed_, sequencesDrawn_, samples, layout, buffer);
+        ObjectHandler::parallelFor(0, samples, chunk, minimumParallelSamples / 2);
+        sequencesDrawn_ += samples;
+        // carry on from the end of the last chunk with a fresh generator
+        // skipped ahead, as the chunks were
+        ursg_ = rsg_type(dimension_, seed_);
+        ursg_.skipTo(sequencesDrawn_);
+    }
 
+}
@@ -29,6 +29,7 @@
 #include <ql/math/randomnumbers/sobolrsg.hpp>
 #include <ql/math/randomnumbers/haltonrsg.hpp>
 
+#include <algorithm>
 #include <vector>
 
 namespace QuantLibAddin {
@@ -39,10 +40,42 @@ namespace QuantLibAddin {
 
     class RandomSequenceGenerator : public ObjectHandler::Object {
       public:
-        std::vector<std::vector<double> > variates(long samples);
+        //! The layout of a buffer of variates, whose rows are the samples.
+        enum Layout { RowMajor, ColumnMajor };
+        //! The next samples sequences, one per row.
+        /*! If transposed is true then the result has instead one row per
+            dimension and one column per sample.  See fillVariates() for the
+            meaning of parallel.
+        */
+        std::vector<std::vector<double> > variates(long samples,
+                                                   bool transposed = false,
+                                                   bool parallel = false);
+        //! Write the next samples sequences into a contiguous buffer.
+        /*! The buffer must hold samples*dimension() elements.  In row-major
+            layout each sequence occupies dimension() consecutive elements,
+            in column-major layout each dimension occupies samples
+            consecutive elements.
+
+            If parallel is true then generators which can skip ahead in
+            their sequence, i.e. Sobol, draw the samples on several threads.
+            The contents of the buffer and the state of the generator
+            afterwards are the same either way.
+        */
+        void fillVariates(long samples, double* buffer,
+                          Layout layout = RowMajor, bool parallel = false);
         virtual std::vector<double> nextSequence() const = 0;
+        virtual QuantLib::Size dimension() const = 0;
       protected:
         OH_OBJ_CTOR(RandomSequenceGenerator, ObjectHandler::Object);
+        //! Write the next samples sequences into consecutive rows of the buffer.
+        virtual void drawSequences(QuantLib::Size samples, double* buffer,
+                                   bool parallel) = 0;
+        //! Write the next samples sequences into consecutive columns of the buffer.
+        /*! By default the sequences are drawn a block at a time by
+            drawSequences() and transposed into the buffer.
+        */
+        virtual void drawColumns(QuantLib::Size samples, double* buffer,
+                                 bool parallel);
     };
 
     // Pseudo Random Sequences
@@ -62,6 +95,21 @@ namespace QuantLibAddin {
             return ursg_.nextSequence().value;
         }
 
+        virtual QuantLib::Size dimension() const {
+            return ursg_.dimension();
+        }
+
+      protected:
+        // The uniform generators cannot skip ahead, so the sequences are
+        // always drawn in order on the calling thread.
+        virtual void drawSequences(QuantLib::Size samples, double* buffer, bool) {
+            QuantLib::Size dimension = ursg_.dimension();
+            for (QuantLib::Size i=0; i<samples; ++i) {
+                const std::vector<QuantLib::Real>& s = ursg_.nextSequence().value;
+                std::copy(s.begin(), s.end(), buffer + i*dimension);
+            }
+        }
+
       private:
         typename QuantLib::GenericPseudoRandom<URNG, QuantLib::InverseCumulativeNormal>::ursg_type ursg_;
     };
@@ -86,14 +134,33 @@ namespace QuantLibAddin {
             const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
             const URSG& ursg,
             bool permanent) 
-            : RandomSequenceGenerator(properties, permanent), ursg_(ursg) {}
+            : RandomSequenceGenerator(properties, permanent), ursg_(ursg),
+              sequencesDrawn_(0) {}
 
         virtual std::vector<double> nextSequence() const {
+            ++sequencesDrawn_;
             return ursg_.nextSequence().value;
         }
 
-      private:
+        virtual QuantLib::Size dimension() const {
+            return ursg_.dimension();
+        }
+
+      protected:
+        // Drawn in order on the calling thread, SobolRsg overrides this
+        // to draw in parallel.
+        virtual void drawSequences(QuantLib::Size samples, double* buffer, bool) {
+            QuantLib::Size dimension = ursg_.dimension();
+            for (QuantLib::Size i=0; i<samples; ++i) {
+                const std::vector<QuantLib::Real>& s = ursg_.nextSequence().value;
+                std::copy(s.begin(), s.end(), buffer + i*dimension);
+            }
+            sequencesDrawn_ += samples;
+        }
+
         typename QuantLib::GenericLowDiscrepancy<URSG, QuantLib::InverseCumulativeNormal>::ursg_type ursg_;
+        //! The number of sequences drawn since construction.
+        mutable unsigned long sequencesDrawn_;
     };
 
     class FaureRsg : public LowDiscrepancySequenceGenerator<QuantLib::FaureRsg> {
@@ -123,6 +190,17 @@ namespace QuantLibAddin {
             long dimension,
             long seed,
             bool permanent);
+      protected:
+        //! Split the samples into chunks, each drawn by a generator skipped to its start.
+        virtual void drawSequences(QuantLib::Size samples, double* buffer,
+                                   bool parallel);
+        //! As drawSequences(), each chunk writing its own columns of the buffer.
+        virtual void drawColumns(QuantLib::Size samples, double* buffer,
+                                 bool parallel);
+      private:
+        void drawParallel(QuantLib::Size samples, double* buffer, Layout layout);
+        QuantLib::Size dimension_;
+        unsigned long seed_;
     };
 
 }
@@ -98,13 +98,8 @@ namespace QuantLibAddin {
         boost::shared_ptr<Index> index = boost::dynamic_pointer_cast<Index>(object.second);
         if(index) {
             try {
-                ObjectHandler::property_t dates = valueObject->getProperty("IndexFixingDates");
-                ObjectHandler::property_t fixings = valueObject->getProperty("IndexFixingRates");
-                std::vector<QuantLib::Date> vct_dates = 
-                    ObjectHandler::vector::convert2<QuantLib::Date>(dates, "IndexFixingDates");
-                std::vector<QuantLib::Rate> vct_fixings =
-                    ObjectHandler::vector::convert2<QuantLib::Rate>(fixings, "IndexFixingRates");
-                index->addFixings(vct_dates, vct_fixings, true, false);
+                index->loadFixings(valueObject->getProperty("IndexFixingDates"),
+                                   valueObject->getProperty("IndexFixingRates"));
             }
             catch(const std::exception& ) {}
         }
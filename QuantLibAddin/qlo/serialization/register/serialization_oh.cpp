@@ -75,5 +75,31 @@ namespace QuantLibAddin {
 
     }
     
+    void register_oh(boost::archive::binary_oarchive &ar) {
+    
+        // class ID 0 in the boost serialization framework
+        ar.register_type<boost::shared_ptr<ObjectHandler::ValueObject> >();
+        // class ID 1 in the boost serialization framework
+        ar.register_type<std::vector<boost::shared_ptr<ObjectHandler::ValueObject> > >();
+        // class ID 2 in the boost serialization framework
+        ar.register_type<ObjectHandler::ValueObjects::ohGroup>();
+        // class ID 3 in the boost serialization framework
+        ar.register_type<ObjectHandler::ValueObjects::ohRange>();
+
+    }
+    
+    void register_oh(boost::archive::binary_iarchive &ar) {
+    
+        // class ID 0 in the boost serialization framework
+        ar.register_type<boost::shared_ptr<ObjectHandler::ValueObject> >();
+        // class ID 1 in the boost serialization framework
+        ar.register_type<std::vector<boost::shared_ptr<ObjectHandler::ValueObject> > >();
+        // class ID 2 in the boost serialization framework
+        ar.register_type<ObjectHandler::ValueObjects::ohGroup>();
+        // class ID 3 in the boost serialization framework
+        ar.register_type<ObjectHandler::ValueObjects::ohRange>();
+
+    }
+    
 }
 
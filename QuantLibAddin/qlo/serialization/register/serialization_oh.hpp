@@ -21,11 +21,15 @@
 
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/archive/xml_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
 
 namespace QuantLibAddin {
 
     void register_oh(boost::archive::xml_oarchive &ar);
     void register_oh(boost::archive::xml_iarchive &ar);
+    void register_oh(boost::archive::binary_oarchive &ar);
+    void register_oh(boost::archive::binary_iarchive &ar);
     
 }
 
@@ -73,6 +73,20 @@ namespace QuantLibAddin {
             ar >> boost::serialization::make_nvp("object_list", valueObjects);
     }
 
+    void SerializationFactory::register_out(boost::archive::binary_oarchive &ar,
+        std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects){
+
+            tpl_register_classes(ar);
+            ar << boost::serialization::make_nvp("object_list", valueObjects);
+    }
+
+    void SerializationFactory::register_in(boost::archive::binary_iarchive &ar,
+        std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects){
+
+            tpl_register_classes(ar);
+            ar >> boost::serialization::make_nvp("object_list", valueObjects);
+    }
+
 
 }
 
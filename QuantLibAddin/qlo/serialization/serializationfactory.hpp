@@ -39,6 +39,10 @@ namespace QuantLibAddin {
             std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects);
         virtual void register_in(boost::archive::xml_iarchive &ar,
             std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects);
+        virtual void register_out(boost::archive::binary_oarchive &ar,
+            std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects);
+        virtual void register_in(boost::archive::binary_iarchive &ar,
+            std::vector<boost::shared_ptr<ObjectHandler::ValueObject> >& valueObjects);
 
     };
 
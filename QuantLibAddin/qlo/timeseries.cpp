@@ -22,6 +22,7 @@
 #endif
 
 #include <qlo/timeseries.hpp>
+#include <qlo/fixingstore.hpp>
 
 #include <ql/timeseries.hpp>
 #include <ql/index.hpp>
@@ -71,6 +72,23 @@ namespace QuantLibAddin {
             QuantLib::TimeSeriesDef(index->timeSeries()));
     }
 
+   TimeSeriesDef::TimeSeriesDef(const shared_ptr<ValueObject>& prop,
+                                const shared_ptr<FixingStore>& store,
+                                const std::string& indexName,
+                                bool perm)
+    : LibraryObject<QuantLib::TimeSeriesDef>(prop, perm)
+    {
+        FixingStore::History history = store->history(indexName);
+        vector<Date> d;
+        d.reserve(history.size);
+        for (Size i=0; i<history.size; ++i)
+            d.push_back(Date(history.dates[i]));
+        libraryObject_ = shared_ptr<QuantLib::TimeSeriesDef>(new
+            QuantLib::TimeSeriesDef(d.begin(),
+                                    d.end(),
+                                    history.values));
+    }
+
     QuantLib::Real TimeSeriesDef::subscriptWrapper(const QuantLib::Date& d) {
         return libraryObject_->operator[](d);
     }
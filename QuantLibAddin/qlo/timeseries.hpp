@@ -38,6 +38,8 @@ namespace QuantLib {
 
 namespace QuantLibAddin {
 
+    class FixingStore;
+
     class TimeSeriesDef : public ObjectHandler::LibraryObject<QuantLib::TimeSeriesDef> {
       public:
         TimeSeriesDef(
@@ -50,6 +52,12 @@ namespace QuantLibAddin {
             const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
             const boost::shared_ptr<QuantLib::Index>& index,
             bool permanent);
+        // The history of the named index in a FixingStore
+        TimeSeriesDef(
+            const boost::shared_ptr<ObjectHandler::ValueObject>& properties,
+            const boost::shared_ptr<FixingStore>& store,
+            const std::string& indexName,
+            bool permanent);
         // Addin function qlTimeSeriesValue() requires address of QuantLib::TimeSeries::operator[]
         // but the autogenerated code causes VC7 to crash (VC7 doesn't support address of operator
         // of template class?) so here we wrap [] and let VC7 use the adddress of the wrapper.
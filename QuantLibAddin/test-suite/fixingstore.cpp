@@ -0,0 +1,237 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <qlo/config.hpp>
+#endif
+
+#include "fixingstore.hpp"
+#include <qlo/fixingstore.hpp>
+#include <qlo/valueobjects/vo_timeseries.hpp>
+#include <ql/index.hpp>
+#include <ql/time/calendars/nullcalendar.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+    // An index with a fixing on any date, taken from its history.
+    class TestIndex : public Index {
+      public:
+        explicit TestIndex(const std::string& name) : name_(name) {}
+        std::string name() const { return name_; }
+        Calendar fixingCalendar() const { return NullCalendar(); }
+        bool isValidFixingDate(const Date&) const { return true; }
+        Real fixing(const Date& d, bool) const { return timeSeries()[d]; }
+      private:
+        std::string name_;
+    };
+
+    struct CommonVars {
+        std::vector<boost::shared_ptr<Index> > indexes;
+        std::string fileName;
+
+        CommonVars() {
+            boost::shared_ptr<Index> euribor(new TestIndex("Euribor6M"));
+            boost::shared_ptr<Index> libor(new TestIndex("libor3m"));
+            boost::shared_ptr<Index> eonia(new TestIndex("EONIA"));
+            Date start(4, January, 2010);
+            for (Size i=0; i<100; ++i)
+                euribor->addFixing(start + 2*i, 0.01 + i*1.0e-4);
+            for (Size i=0; i<200; ++i)
+                libor->addFixing(start + i, 0.02 / (i+1));
+            indexes.push_back(euribor);
+            indexes.push_back(libor);
+            indexes.push_back(eonia);
+            // a second instance of the same index
+            indexes.push_back(boost::shared_ptr<Index>(new TestIndex("EURIBOR6M")));
+
+            fileName = (boost::filesystem::temp_directory_path()
+                        / boost::filesystem::unique_path("qlo-%%%%-%%%%.fix")).string();
+            QuantLibAddin::writeFixingStore(fileName, indexes);
+        }
+
+        ~CommonVars() {
+            for (Size i=0; i<indexes.size(); ++i)
+                indexes[i]->clearFixings();
+            boost::system::error_code ec;
+            boost::filesystem::remove(fileName, ec);
+        }
+
+        boost::shared_ptr<QuantLibAddin::FixingStore> open(const std::string& file) const {
+            boost::shared_ptr<ObjectHandler::ValueObject> properties(
+                new QuantLibAddin::ValueObjects::qlFixingStore("store", file, false));
+            return boost::shared_ptr<QuantLibAddin::FixingStore>(
+                new QuantLibAddin::FixingStore(properties, file, false));
+        }
+
+        boost::shared_ptr<QuantLibAddin::FixingStore> open() const {
+            return open(fileName);
+        }
+
+        // write the file with the given bytes overwritten
+        std::string corrupt(std::size_t offset, const void* bytes, std::size_t n) const {
+            std::ifstream in(fileName.c_str(), std::ios::binary);
+            std::string contents((std::istreambuf_iterator<char>(in)),
+                                 std::istreambuf_iterator<char>());
+            if (offset + n > contents.size())
+                contents.resize(offset + n);
+            std::memcpy(&contents[offset], bytes, n);
+            std::string corrupted = fileName + ".bad";
+            std::ofstream out(corrupted.c_str(), std::ios::binary | std::ios::trunc);
+            out.write(contents.data(), contents.size());
+            return corrupted;
+        }
+    };
+
+}
+
+void FixingStoreTest::testRoundTrip() {
+
+    BOOST_TEST_MESSAGE("Testing fixing store round trip...");
+
+    CommonVars vars;
+    boost::shared_ptr<QuantLibAddin::FixingStore> store = vars.open();
+
+    std::vector<std::string> names = store->names();
+    BOOST_REQUIRE_EQUAL(names.size(), 3U);
+    BOOST_CHECK_EQUAL(names[0], "EONIA");
+    BOOST_CHECK_EQUAL(names[1], "EURIBOR6M");
+    BOOST_CHECK_EQUAL(names[2], "LIBOR3M");
+
+    BOOST_CHECK(store->hasHistory("Libor3M"));
+    BOOST_CHECK(!store->hasHistory("Euribor3M"));
+    BOOST_CHECK_EQUAL(store->history("eonia").size, 0U);
+    BOOST_CHECK_THROW(store->history("Euribor3M"), std::exception);
+
+    for (Size k=0; k<2; ++k) {
+        const TimeSeries<Real>& series = vars.indexes[k]->timeSeries();
+        std::vector<Date> dates = store->dates(vars.indexes[k]->name());
+        std::vector<Real> values = store->values(vars.indexes[k]->name());
+        BOOST_REQUIRE_EQUAL(dates.size(), series.size());
+        BOOST_REQUIRE_EQUAL(values.size(), series.size());
+        Size i = 0;
+        for (TimeSeries<Real>::const_iterator s = series.begin();
+             s != series.end(); ++s, ++i) {
+            if (dates[i] != s->first || values[i] != s->second)
+                BOOST_ERROR("fixing " << i << " of " << vars.indexes[k]->name()
+                            << " read as " << values[i] << " on " << dates[i]
+                            << ", written as " << s->second << " on " << s->first);
+            if (store->fixing(vars.indexes[k]->name(), s->first) != s->second)
+                BOOST_ERROR("fixing of " << vars.indexes[k]->name() << " on "
+                            << s->first << " looked up as "
+                            << store->fixing(vars.indexes[k]->name(), s->first)
+                            << ", written as " << s->second);
+        }
+    }
+
+    // Euribor fixings are every other day
+    BOOST_CHECK_THROW(store->fixing("EURIBOR6M", Date(5, January, 2010)),
+                      std::exception);
+    BOOST_CHECK_THROW(store->fixing("EURIBOR6M", Date(1, January, 2010)),
+                      std::exception);
+    BOOST_CHECK_THROW(store->fixing("EURIBOR6M", Date(1, January, 2020)),
+                      std::exception);
+}
+
+void FixingStoreTest::testReplaceWhileMapped() {
+
+    BOOST_TEST_MESSAGE("Testing replacement of a mapped fixing store...");
+
+    CommonVars vars;
+    boost::shared_ptr<QuantLibAddin::FixingStore> store = vars.open();
+
+    vars.indexes[0]->addFixing(Date(4, January, 2011), 0.05);
+#if defined(_WIN32)
+    // a mapped file cannot be replaced on Windows
+    BOOST_CHECK_THROW(QuantLibAddin::writeFixingStore(vars.fileName, vars.indexes),
+                      std::exception);
+    store.reset();
+#endif
+    QuantLibAddin::writeFixingStore(vars.fileName, vars.indexes);
+
+#if !defined(_WIN32)
+    // the previous version of the file is still mapped
+    BOOST_CHECK_EQUAL(store->history("EURIBOR6M").size, 100U);
+    BOOST_CHECK_THROW(store->fixing("EURIBOR6M", Date(4, January, 2011)),
+                      std::exception);
+#endif
+
+    boost::shared_ptr<QuantLibAddin::FixingStore> replaced = vars.open();
+    BOOST_CHECK_EQUAL(replaced->history("EURIBOR6M").size, 101U);
+    BOOST_CHECK_EQUAL(replaced->fixing("EURIBOR6M", Date(4, January, 2011)), 0.05);
+}
+
+void FixingStoreTest::testCorruptFiles() {
+
+    BOOST_TEST_MESSAGE("Testing rejection of corrupt fixing stores...");
+
+    CommonVars vars;
+
+    BOOST_CHECK_THROW(vars.open(vars.fileName + ".missing"), std::exception);
+
+    // the offsets of the fields of the header and of the first entry
+    const std::size_t magicOffset = 0, byteOrderOffset = 8, versionOffset = 12,
+                      countOffset = 16, firstEntry = 24, sizeOffset = firstEntry + 80,
+                      valuesOffset = firstEntry + 72;
+
+    const char text[] = "Not a fixing store";
+    BOOST_CHECK_THROW(vars.open(vars.corrupt(magicOffset, text, sizeof(text))),
+                      std::exception);
+
+    boost::uint32_t swapped = 0x04030201;
+    BOOST_CHECK_THROW(vars.open(vars.corrupt(byteOrderOffset, &swapped, sizeof(swapped))),
+                      std::exception);
+
+    boost::uint32_t version = 1;
+    BOOST_CHECK_THROW(vars.open(vars.corrupt(versionOffset, &version, sizeof(version))),
+                      std::exception);
+
+    boost::uint32_t count = 1000000;
+    BOOST_CHECK_THROW(vars.open(vars.corrupt(countOffset, &count, sizeof(count))),
+                      std::exception);
+
+    // a size which overflows when multiplied by that of a double
+    boost::uint64_t size = (~boost::uint64_t(0)) / sizeof(double) * 2 + 1;
+    BOOST_CHECK_THROW(vars.open(vars.corrupt(sizeOffset, &size, sizeof(size))),
+                      std::exception);
+
+    boost::uint64_t offset = ~boost::uint64_t(7);
+    BOOST_CHECK_THROW(vars.open(vars.corrupt(valuesOffset, &offset, sizeof(offset))),
+                      std::exception);
+
+    // the unmodified file is accepted
+    BOOST_CHECK_NO_THROW(vars.open(vars.corrupt(0, text, 0)));
+
+    boost::system::error_code ec;
+    boost::filesystem::remove(vars.fileName + ".bad", ec);
+}
+
+test_suite* FixingStoreTest::suite() {
+    test_suite* suite = BOOST_TEST_SUITE("Fixing store tests");
+    suite->add(BOOST_TEST_CASE(&FixingStoreTest::testRoundTrip));
+    suite->add(BOOST_TEST_CASE(&FixingStoreTest::testReplaceWhileMapped));
+    suite->add(BOOST_TEST_CASE(&FixingStoreTest::testCorruptFiles));
+    return suite;
+}
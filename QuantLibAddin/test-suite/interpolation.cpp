@@ -0,0 +1,322 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <qlo/config.hpp>
+#endif
+
+#include "interpolation.hpp"
+#include <qlo/interpolation.hpp>
+#include <qlo/quotes.hpp>
+#include <qlo/conversions/varianttoquotehandle.hpp>
+#include <qlo/valueobjects/vo_interpolation.hpp>
+#include <qlo/valueobjects/vo_quotes.hpp>
+#include <oh/repository.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+    // Unsorted points with a repeated x value, the same quote being
+    // given for both.
+    struct CommonVars {
+        std::vector<Real> x, y;
+        std::vector<Handle<Quote> > quotes;
+
+        CommonVars() {
+            Real xs[] = { 3.0, 1.0, 2.5, 7.0, 4.0, 1.5, 2.5 };
+            Real ys[] = { 0.95, 0.99, 0.97, 0.80, 0.90, 0.985, 0.97 };
+            x.assign(xs, xs + 7);
+            y.assign(ys, ys + 7);
+            for (Size i=0; i<6; ++i)
+                quotes.push_back(Handle<Quote>(
+                    boost::shared_ptr<Quote>(new SimpleQuote(y[i]))));
+            quotes.push_back(quotes[2]);
+        }
+
+        boost::shared_ptr<QuantLibAddin::Interpolation>
+        interpolation(const std::string& type, Size points) const {
+            std::vector<Real> xs(x.begin(), x.begin() + points);
+            std::vector<ObjectHandler::property_t> yArray(y.begin(), y.begin() + points);
+            std::vector<Handle<Quote> > yh(quotes.begin(), quotes.begin() + points);
+            boost::shared_ptr<ObjectHandler::ValueObject> properties(
+                new QuantLibAddin::ValueObjects::qlInterpolation(
+                    "interpolation", type, xs, yArray, false));
+            return boost::shared_ptr<QuantLibAddin::Interpolation>(
+                new QuantLibAddin::GenericInterp(properties, type, xs, yh, false));
+        }
+
+        // nodes, points between and beyond them, in no particular order
+        std::vector<Real> points() const {
+            std::vector<Real> p(x);
+            for (Size i=0; i<=900; ++i)
+                p.push_back((i*37 % 901) * 0.01 - 0.5);
+            p.push_back(-100.0);
+            p.push_back(100.0);
+            return p;
+        }
+    };
+
+    // the interval of the grid holding x, as located by QuantLib::Interpolation
+    Size interval(const std::vector<Real>& grid, Real x) {
+        Size i = std::upper_bound(grid.begin(), grid.end(), x) - grid.begin();
+        return std::min<Size>(std::max<Size>(i, 1), grid.size()-1) - 1;
+    }
+
+    // Quotes held in the repository, as for an interpolation built by an
+    // addin, whose y values may be given by ID or as literal values.
+    struct RepositoryVars {
+        std::vector<Real> x;
+
+        RepositoryVars() {
+            Real xs[] = { 2.0, 1.0, 3.0, 1.0, 4.0 };
+            x.assign(xs, xs + 5);
+        }
+
+        ~RepositoryVars() {
+            ObjectHandler::Repository::instance().deleteAllObjects(true);
+        }
+
+        boost::shared_ptr<QuantLibAddin::SimpleQuote>
+        storeQuote(const std::string& id, Real value) const {
+            boost::shared_ptr<ObjectHandler::ValueObject> properties(
+                new QuantLibAddin::ValueObjects::qlSimpleQuote(id, value, 0.0, false));
+            boost::shared_ptr<QuantLibAddin::SimpleQuote> quote(
+                new QuantLibAddin::SimpleQuote(properties, value, 0.0, false));
+            ObjectHandler::Repository::instance().storeObject(id, quote, true);
+            return quote;
+        }
+
+        boost::shared_ptr<ObjectHandler::ValueObject>
+        properties(const std::vector<ObjectHandler::property_t>& yArray) const {
+            return boost::shared_ptr<ObjectHandler::ValueObject>(
+                new QuantLibAddin::ValueObjects::qlInterpolation(
+                    "interpolation", "Linear", x, yArray, false));
+        }
+
+        boost::shared_ptr<QuantLibAddin::Interpolation>
+        interpolation(const std::vector<ObjectHandler::property_t>& yArray) const {
+            // points given the same ID share a handle, which the
+            // constructor requires of points with the same x value
+            std::map<std::string, Handle<Quote> > handles;
+            std::vector<Handle<Quote> > yh;
+            for (Size i=0; i<yArray.size(); ++i) {
+                if (yArray[i].type() != typeid(std::string)) {
+                    yh.push_back(ObjectHandler::convert2<Handle<Quote> >(yArray[i]));
+                    continue;
+                }
+                std::string id = boost::get<std::string>(yArray[i]);
+                if (handles.find(id) == handles.end())
+                    handles[id] = ObjectHandler::convert2<Handle<Quote> >(yArray[i]);
+                yh.push_back(handles[id]);
+            }
+            return boost::shared_ptr<QuantLibAddin::Interpolation>(
+                new QuantLibAddin::GenericInterp(properties(yArray), "Linear",
+                                                 x, yh, false));
+        }
+    };
+
+    // y quotes q2, q1, q3, q1 and a literal value
+    std::vector<ObjectHandler::property_t> yArray(const std::string& repeated = "q1") {
+        std::vector<ObjectHandler::property_t> y;
+        y.push_back(ObjectHandler::property_t(std::string("q2")));
+        y.push_back(ObjectHandler::property_t(std::string("q1")));
+        y.push_back(ObjectHandler::property_t(std::string("q3")));
+        y.push_back(ObjectHandler::property_t(repeated));
+        y.push_back(ObjectHandler::property_t(0.5));
+        return y;
+    }
+
+}
+
+void InterpolationTest::testLocateIntervals() {
+
+    BOOST_TEST_MESSAGE("Testing interval location...");
+
+    CommonVars vars;
+    std::vector<Real> grid(vars.x.begin(), vars.x.end() - 1);
+    std::sort(grid.begin(), grid.end());
+    std::vector<Real> x = vars.points();
+
+    for (Size k=0; k<2; ++k) {
+        std::vector<Size> intervals;
+        QuantLibAddin::locateIntervals(grid, x, intervals);
+        BOOST_REQUIRE_EQUAL(intervals.size(), x.size());
+        for (Size i=0; i<x.size(); ++i) {
+            if (intervals[i] != interval(grid, x[i]))
+                BOOST_ERROR("point " << x[i] << " located in interval "
+                            << intervals[i] << ", expected "
+                            << interval(grid, x[i]));
+        }
+        // again, taking the sweep through sorted points
+        std::sort(x.begin(), x.end());
+    }
+
+    std::vector<Size> intervals;
+    QuantLibAddin::locateIntervals(grid, std::vector<Real>(), intervals);
+    BOOST_CHECK(intervals.empty());
+    BOOST_CHECK_THROW(QuantLibAddin::locateIntervals(
+                          std::vector<Real>(1, 1.0), x, intervals),
+                      std::exception);
+}
+
+void InterpolationTest::testValues() {
+
+    BOOST_TEST_MESSAGE("Testing interpolated values against single points...");
+
+    CommonVars vars;
+    // the types evaluated by values() itself, and one left to the library
+    std::vector<std::string> types;
+    types.push_back("Linear");
+    types.push_back("LogLinear");
+    types.push_back("BackwardFlat");
+    types.push_back("ForwardFlat");
+    types.push_back("CubicNaturalSpline");
+    // a single interval, and several with a repeated node
+    std::vector<Size> sizes;
+    sizes.push_back(2);
+    sizes.push_back(7);
+    std::vector<Real> x = vars.points();
+    std::vector<Real> sorted(x);
+    std::sort(sorted.begin(), sorted.end());
+
+    for (Size i=0; i<types.size(); ++i) {
+        for (Size j=0; j<sizes.size(); ++j) {
+            boost::shared_ptr<QuantLibAddin::Interpolation> f =
+                vars.interpolation(types[i], sizes[j]);
+            for (Size k=0; k<2; ++k) {
+                const std::vector<Real>& p = (k == 0 ? x : sorted);
+                std::vector<Real> values = f->values(p, true);
+                BOOST_REQUIRE_EQUAL(values.size(), p.size());
+                for (Size l=0; l<p.size(); ++l) {
+                    // the same bits, not merely close
+                    Real expected = (*f)(p[l], true);
+                    if (values[l] != expected)
+                        BOOST_ERROR(types[i] << " interpolation on "
+                                    << sizes[j] << " points at " << p[l]
+                                    << std::setprecision(17)
+                                    << ":\n    values():   " << values[l]
+                                    << "\n    operator(): " << expected);
+                }
+            }
+            BOOST_CHECK(f->values(std::vector<Real>(), true).empty());
+        }
+    }
+}
+
+void InterpolationTest::testValuesOutOfRange() {
+
+    BOOST_TEST_MESSAGE("Testing interpolated values out of range...");
+
+    CommonVars vars;
+    boost::shared_ptr<QuantLibAddin::Interpolation> f =
+        vars.interpolation("Linear", 7);
+
+    std::vector<Real> x(vars.x);
+    std::vector<Real> values = f->values(x, false);
+    for (Size i=0; i<x.size(); ++i)
+        BOOST_CHECK_EQUAL(values[i], (*f)(x[i], false));
+
+    x.push_back(7.5);
+    BOOST_CHECK_THROW(f->values(x, false), std::exception);
+    BOOST_CHECK_THROW((*f)(7.5, false), std::exception);
+    f->enableExtrapolation(true);
+    BOOST_CHECK_NO_THROW(f->values(x, false));
+}
+
+void InterpolationTest::testRefresh() {
+
+    BOOST_TEST_MESSAGE("Testing refresh of interpolations...");
+
+    RepositoryVars vars;
+    boost::shared_ptr<QuantLibAddin::SimpleQuote> q1 = vars.storeQuote("q1", 1.0);
+    vars.storeQuote("q2", 2.0);
+    vars.storeQuote("q3", 3.0);
+    boost::shared_ptr<QuantLibAddin::Interpolation> f =
+        vars.interpolation(yArray());
+    BOOST_CHECK_EQUAL((*f)(2.0, false), 2.0);
+
+    // recreate q2, the interpolation still points at the previous one
+    boost::shared_ptr<QuantLibAddin::SimpleQuote> q2 = vars.storeQuote("q2", 20.0);
+    BOOST_CHECK_EQUAL((*f)(2.0, false), 2.0);
+
+    BOOST_REQUIRE(f->refresh(*vars.properties(yArray())));
+    BOOST_CHECK_EQUAL((*f)(1.0, false), 1.0);
+    BOOST_CHECK_EQUAL((*f)(2.0, false), 20.0);
+    BOOST_CHECK_EQUAL((*f)(3.0, false), 3.0);
+    BOOST_CHECK_EQUAL((*f)(4.0, false), 0.5);
+
+    // the interpolation observes the new q2 and still observes q1
+    q2->setValue(30.0);
+    BOOST_CHECK_EQUAL((*f)(2.0, false), 30.0);
+    q1->setValue(10.0);
+    BOOST_CHECK_EQUAL((*f)(1.0, false), 10.0);
+
+    std::vector<Real> x(1, 2.0);
+    x.push_back(1.0);
+    std::vector<Real> values = f->values(x, false);
+    BOOST_CHECK_EQUAL(values[0], 30.0);
+    BOOST_CHECK_EQUAL(values[1], 10.0);
+
+    // a different number of points calls for the object to be recreated
+    std::vector<ObjectHandler::property_t> y = yArray();
+    y.pop_back();
+    BOOST_CHECK(!f->refresh(*vars.properties(y)));
+}
+
+void InterpolationTest::testRefreshWithRepeatedNodes() {
+
+    BOOST_TEST_MESSAGE("Testing refresh of interpolations with repeated nodes...");
+
+    RepositoryVars vars;
+    vars.storeQuote("q1", 1.0);
+    vars.storeQuote("q2", 2.0);
+    vars.storeQuote("q3", 3.0);
+    boost::shared_ptr<QuantLibAddin::Interpolation> f =
+        vars.interpolation(yArray());
+
+    // both points at x = 1 follow q1 when it is recreated
+    vars.storeQuote("q1", 10.0);
+    BOOST_REQUIRE(f->refresh(*vars.properties(yArray())));
+    BOOST_CHECK_EQUAL((*f)(1.0, false), 10.0);
+
+    // the points at x = 1 no longer share their quote, the object is
+    // left unchanged to be recreated
+    vars.storeQuote("q2", 20.0);
+    BOOST_CHECK(!f->refresh(*vars.properties(yArray("q3"))));
+    BOOST_CHECK_EQUAL((*f)(1.0, false), 10.0);
+    BOOST_CHECK_EQUAL((*f)(2.0, false), 2.0);
+
+    // and the constructor rejects them
+    BOOST_CHECK_THROW(vars.interpolation(yArray("q3")), std::exception);
+}
+
+test_suite* InterpolationTest::suite() {
+    test_suite* suite = BOOST_TEST_SUITE("Interpolation tests");
+    suite->add(BOOST_TEST_CASE(&InterpolationTest::testLocateIntervals));
+    suite->add(BOOST_TEST_CASE(&InterpolationTest::testValues));
+    suite->add(BOOST_TEST_CASE(&InterpolationTest::testValuesOutOfRange));
+    suite->add(BOOST_TEST_CASE(&InterpolationTest::testRefresh));
+    suite->add(BOOST_TEST_CASE(&InterpolationTest::testRefreshWithRepeatedNodes));
+    return suite;
+}
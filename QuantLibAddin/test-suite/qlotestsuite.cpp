@@ -0,0 +1,55 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <qlo/config.hpp>
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <oh/repository.hpp>
+#include <oh/processor.hpp>
+#include <oh/enumerations/enumregistry.hpp>
+#include <qlo/enumerations/register/register_all.hpp>
+#include <qlo/serialization/serializationfactory.hpp>
+
+#include "fixingstore.hpp"
+#include "interpolation.hpp"
+#include "randomsequencegenerator.hpp"
+
+using namespace boost::unit_test_framework;
+
+test_suite* init_unit_test_suite(int, char* []) {
+
+    // the singletons which the addins instantiate on initialization
+    static ObjectHandler::Repository repository;
+    static ObjectHandler::ProcessorFactory processorFactory;
+    static QuantLibAddin::SerializationFactory factory;
+    static ObjectHandler::EnumTypeRegistry enumTypeRegistry;
+    static ObjectHandler::EnumClassRegistry enumClassRegistry;
+    static ObjectHandler::EnumPairRegistry enumPairRegistry;
+    QuantLibAddin::registerEnumerations();
+
+    test_suite* test = BOOST_TEST_SUITE("QuantLibAddin test suite");
+
+    test->add(FixingStoreTest::suite());
+    test->add(InterpolationTest::suite());
+    test->add(RandomSequenceGeneratorTest::suite());
+
+    return test;
+}
@@ -0,0 +1,175 @@
+/* -*- mode: c++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+/*
+ This file is part of QuantLib, a free-software/open-source library
+ for financial quantitative analysts and developers - http://quantlib.org/
+
+ QuantLib is free software: you can redistribute it and/or modify it
+ under the terms of the QuantLib license.  You should have received a
+ copy of the license along with this program; if not, please email
+ <quantlib-dev@lists.sf.net>. The license is also available online at
+ <http://quantlib.org/license.shtml>.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+
+#if defined(HAVE_CONFIG_H)     // Dynamically created by configure
+    #include <qlo/config.hpp>
+#endif
+
+#include "randomsequencegenerator.hpp"
+#include <qlo/randomsequencegenerator.hpp>
+#include <qlo/valueobjects/vo_randomsequencegenerator.hpp>
+
+using QuantLib::Size;
+using namespace QuantLibAddin;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+    boost::shared_ptr<RandomSequenceGenerator> sobol(long dimension) {
+        boost::shared_ptr<ObjectHandler::ValueObject> properties(
+            new ValueObjects::qlSobolRsg("rsg", dimension, 42, false));
+        return boost::shared_ptr<RandomSequenceGenerator>(
+            new SobolRsg(properties, dimension, 42, false));
+    }
+
+    boost::shared_ptr<RandomSequenceGenerator> mersenneTwister(long dimension) {
+        boost::shared_ptr<ObjectHandler::ValueObject> properties(
+            new ValueObjects::qlMersenneTwisterRsg("rsg", dimension, 42, false));
+        return boost::shared_ptr<RandomSequenceGenerator>(
+            new MersenneTwisterRsg(properties, dimension, 42, false));
+    }
+
+    typedef boost::shared_ptr<RandomSequenceGenerator> (*Factory)(long);
+
+    // Check that drawing in blocks, in either layout and on any number of
+    // threads, interleaved with single sequences, gives the sequences that
+    // a generator with the same seed gives one at a time.
+    void checkVariates(const std::string& name, Factory factory) {
+        // enough samples for Sobol sequences to be drawn in parallel, and
+        // dimensions for which column-major variates are transposed in one
+        // block or in several
+        const long samples = 5000;
+        long dimensions[] = { 1, 4, 40 };
+        for (long d=0; d<3; ++d) {
+            long dimension = dimensions[d];
+            boost::shared_ptr<RandomSequenceGenerator> reference = factory(dimension);
+            std::vector<std::vector<double> > expected;
+            for (long i=0; i<4*samples+4; ++i)
+                expected.push_back(reference->nextSequence());
+
+            for (Size p=0; p<2; ++p) {
+                bool parallel = (p == 1);
+                boost::shared_ptr<RandomSequenceGenerator> rsg = factory(dimension);
+                long drawn = 0;
+                std::vector<double> buffer(samples*dimension);
+
+                for (long i=0; i<2; ++i, ++drawn) {
+                    if (rsg->nextSequence() != expected[drawn])
+                        BOOST_FAIL(name << " sequence " << drawn << " differs");
+                }
+
+                rsg->fillVariates(samples, &buffer[0],
+                                  RandomSequenceGenerator::RowMajor, parallel);
+                for (long i=0; i<samples; ++i) {
+                    for (long j=0; j<dimension; ++j) {
+                        if (buffer[i*dimension + j] != expected[drawn+i][j])
+                            BOOST_FAIL(name << " row-major variates differ at sample "
+                                       << drawn+i << ", dimension " << j
+                                       << " of " << dimension
+                                       << (parallel ? ", drawn in parallel" : ""));
+                    }
+                }
+                drawn += samples;
+
+                if (rsg->nextSequence() != expected[drawn])
+                    BOOST_FAIL(name << " sequence " << drawn
+                               << " after row-major variates differs");
+                ++drawn;
+
+                rsg->fillVariates(samples, &buffer[0],
+                                  RandomSequenceGenerator::ColumnMajor, parallel);
+                for (long i=0; i<samples; ++i) {
+                    for (long j=0; j<dimension; ++j) {
+                        if (buffer[j*samples + i] != expected[drawn+i][j])
+                            BOOST_FAIL(name << " column-major variates differ at sample "
+                                       << drawn+i << ", dimension " << j
+                                       << " of " << dimension
+                                       << (parallel ? ", drawn in parallel" : ""));
+                    }
+                }
+                drawn += samples;
+
+                if (rsg->nextSequence() != expected[drawn])
+                    BOOST_FAIL(name << " sequence " << drawn
+                               << " after column-major variates differs");
+                ++drawn;
+
+                // a draw too small to be split
+                rsg->fillVariates(1, &buffer[0],
+                                  RandomSequenceGenerator::RowMajor, parallel);
+                for (long j=0; j<dimension; ++j) {
+                    if (buffer[j] != expected[drawn][j])
+                        BOOST_FAIL(name << " single sample " << drawn << " differs");
+                }
+                ++drawn;
+
+                std::vector<std::vector<double> > variates =
+                    rsg->variates(samples, false, parallel);
+                BOOST_REQUIRE_EQUAL(variates.size(), Size(samples));
+                for (long i=0; i<samples; ++i) {
+                    if (variates[i] != expected[drawn+i])
+                        BOOST_FAIL(name << " variates differ at sample " << drawn+i
+                                   << (parallel ? ", drawn in parallel" : ""));
+                }
+            }
+        }
+    }
+
+}
+
+void RandomSequenceGeneratorTest::testSobolVariates() {
+    BOOST_TEST_MESSAGE("Testing reproducibility of Sobol variates...");
+    checkVariates("Sobol", sobol);
+}
+
+void RandomSequenceGeneratorTest::testMersenneTwisterVariates() {
+    BOOST_TEST_MESSAGE("Testing reproducibility of Mersenne Twister variates...");
+    checkVariates("Mersenne Twister", mersenneTwister);
+}
+
+void RandomSequenceGeneratorTest::testVariatesLayout() {
+
+    BOOST_TEST_MESSAGE("Testing layout of variates...");
+
+    const long samples = 3, dimension = 2;
+    boost::shared_ptr<RandomSequenceGenerator> rows = sobol(dimension);
+    boost::shared_ptr<RandomSequenceGenerator> columns = sobol(dimension);
+
+    std::vector<std::vector<double> > v = rows->variates(samples, false);
+    std::vector<std::vector<double> > t = columns->variates(samples, true);
+    BOOST_REQUIRE_EQUAL(v.size(), Size(samples));
+    BOOST_REQUIRE_EQUAL(t.size(), Size(dimension));
+    for (long i=0; i<samples; ++i) {
+        BOOST_REQUIRE_EQUAL(v[i].size(), Size(dimension));
+        for (long j=0; j<dimension; ++j) {
+            BOOST_REQUIRE_EQUAL(t[j].size(), Size(samples));
+            BOOST_CHECK_EQUAL(v[i][j], t[j][i]);
+        }
+    }
+
+    BOOST_CHECK(rows->variates(0, false).empty());
+    BOOST_CHECK_THROW(rows->variates(-1, false), std::exception);
+}
+
+test_suite* RandomSequenceGeneratorTest::suite() {
+    test_suite* suite = BOOST_TEST_SUITE("Random sequence generator tests");
+    suite->add(BOOST_TEST_CASE(&RandomSequenceGeneratorTest::testSobolVariates));
+    suite->add(BOOST_TEST_CASE(&RandomSequenceGeneratorTest::testMersenneTwisterVariates));
+    suite->add(BOOST_TEST_CASE(&RandomSequenceGeneratorTest::testVariatesLayout));
+    return suite;
+}
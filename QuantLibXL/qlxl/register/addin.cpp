@@ -158,6 +158,9 @@ DLLEXPORT int xlAutoClose() {
 
 #ifdef XLL_STATIC
         ObjectHandler::RepositoryXL::instance().clear();
+        // Write any queued log messages and stop the logging thread, which
+        // cannot be joined once the DLL begins to unload.
+        ObjectHandler::logStopAsync();
 #endif
 
         Excel(xlFree, 0, 1, &xDll);
@@ -20,6 +20,7 @@
 
 from gensrc.addins import addin
 from gensrc.addins import cppexceptions
+from gensrc.functions import exceptions
 from gensrc.configuration import environment
 from gensrc.categories import category
 from gensrc.utilities import outputfile
@@ -70,6 +71,9 @@ class CppAddin(addin.Addin):
             for func in cat.functions(self.name_): 
                 bufferCpp += self.generateFunction(func)
                 bufferHpp += self.generateDeclaration(func)
+                if func.batch():
+                    bufferCpp += self.generateBatchFunction(func)
+                    bufferHpp += self.generateBatchDeclaration(func)
             self.bufferBody_.set({
                 'bufferCpp' : bufferCpp,
                 'categoryIncludes' : categoryIncludes })
@@ -105,6 +109,55 @@ class CppAddin(addin.Addin):
             'functionDeclaration' : func.parameterList().generate(self.functionDeclaration_),
             'functionName' : func.name() })
 
+    def generateBatchFunction(self, func):
+        """Generate source code for the batch variant of a Member function.
+
+        The batch variant is an overload which takes a vector of object IDs
+        in place of the single ID.  The other inputs are converted once, the
+        objects are retrieved in a single call to the Repository, and the
+        member function is invoked on each object in turn within a single
+        try block."""
+        objectIdParam = func.objectIdParameter()
+        batchConversions = self.batchConversions_.apply(objectIdParam)
+        if not batchConversions:
+            raise exceptions.BehaviorBatchObjectException(
+                func.name(), objectIdParam.fullType().value(), self.name_)
+        # The body of the scalar function is reused inside the loop.
+        functionBody = '\n'.join([ line and '    ' + line
+            for line in func.generateBody(self).rstrip().split('\n') ])
+        parameterList = func.parameterList()
+        return self.bufferBatch_.set({
+            'batchConversions' : batchConversions,
+            'batchElement' : self.batchElement_.apply(objectIdParam),
+            'batchReturn' : self.batchReturnConversion_.apply(func.returnValue()),
+            'cppConversions' : parameterList.generate(self.cppConversions_, True),
+            'enumConversions' : parameterList.generate(self.enumConversions_, True),
+            'functionBody' : functionBody,
+            'functionDeclaration' : self.batchDeclaration(func),
+            'functionName' : func.name(),
+            'libConversions' : parameterList.generate(self.libraryConversions_, True),
+            'objectConversions' : parameterList.generate(self.objectConversions_, True),
+            'objectIdName' : objectIdParam.name(),
+            'refConversions' : parameterList.generate(self.referenceConversions_, True),
+            'returnType' : self.functionReturnType_.apply(func.returnValue()) })
+
+    def generateBatchDeclaration(self, func):
+        """Generate the declaration of the batch variant of a Member function."""
+        return self.bufferDeclaration_.set({
+            'functionReturnType' : 'std::vector<%s>' %
+                self.functionReturnType_.apply(func.returnValue()),
+            'functionDeclaration' : self.batchDeclaration(func),
+            'functionName' : func.name() })
+
+    def batchDeclaration(self, func):
+        """Return the parameter list of the batch variant of a Member function,
+        in which the object ID is replaced by a vector of IDs."""
+        ret = '\n' + self.batchDeclaration_.apply(func.objectIdParameter())
+        otherParams = func.parameterList().generate(self.functionDeclaration_, True)
+        if otherParams:
+            ret += ',' + otherParams
+        return ret
+
     def loopName(self, param):
         """Return the variable name for a loop parameter."""
         if param.type() == common.STRING:
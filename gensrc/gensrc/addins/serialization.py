@@ -39,6 +39,8 @@ class Serialization(addin.Addin):
         const boost::shared_ptr<ObjectHandler::ValueObject>&);\n\n'''
     REGISTER_CREATOR = '''\
         registerCreator("%(functionName)s", create_%(functionName)s);\n'''
+    REGISTER_REFRESH = '''\
+        registerRefresh("%(functionName)s");\n'''
     REGISTER_TYPE = '''\
         // %(categoryDisplayName)s\n
         register_%(categoryName)s(ar);\n\n'''
@@ -81,6 +83,9 @@ class Serialization(addin.Addin):
 
                 bufferCreators += Serialization.REGISTER_CREATOR % {
                     'functionName' : func.name() }
+                if func.refresh():
+                    bufferCreators += Serialization.REGISTER_REFRESH % {
+                        'functionName' : func.name() }
 
         self.bufferFactory_.set({
             'bufferCreators' : bufferCreators,
@@ -36,6 +36,16 @@ class ValueObjects(addin.Addin):
     PROCESSOR_NAME = '''\
         virtual std::string processorName() { return "%(processorName)s"; }'''
 
+    PROPERTY_CASE = '''\
+            case 0x%(hash)08xU:
+%(tests)s                break;
+'''
+
+    PROPERTY_TEST = '''\
+                if (ObjectHandler::foldedEqual(name, "%(nameUpper)s"))
+                    return %(index)d;
+'''
+
     #############################################
     # public interface
     #############################################
@@ -69,6 +79,34 @@ class ValueObjects(addin.Addin):
 
         log.Log.instance().logMessage(' done generating ValueObjects.')
 
+    def foldedHash32(self, name):
+        """Return the hash of the given property name, as computed at run time
+        by ObjectHandler::foldedHash32()."""
+        h = 2166136261L
+        for c in name.upper():
+            h ^= ord(c)
+            h = (h * 16777619L) & 0xffffffffL
+        return h
+
+    def generatePropertyCases(self, func):
+        """Generate the cases of the switch which maps a property name, in any
+        case, to its position.  Names with the same hash share a case."""
+        properties = [ ('ObjectId', 0), ('ClassName', 1) ]
+        for param in func.parameterList().properties():
+            properties.append((param.name(), param.propertyIndex()))
+        cases = {}
+        for name, index in properties:
+            cases.setdefault(self.foldedHash32(name), []).append(
+                ValueObjects.PROPERTY_TEST % {
+                    'index' : index,
+                    'nameUpper' : name.upper() })
+        ret = ''
+        for h in sorted(cases.keys()):
+            ret += ValueObjects.PROPERTY_CASE % {
+                'hash' : h,
+                'tests' : ''.join(cases[h]) }
+        return ret
+
     def generateHeaderInline(self, func):
         """Generate class definition source for prototype of given constructor function."""
         if func.processorName():
@@ -91,6 +129,7 @@ class ValueObjects(addin.Addin):
             'constructorParList' : func.parameterList().generate(self.constructorDeclaration_),
             'functionName' : func.name(),
             'propertyDeclaration' : func.parameterList().generate(self.propertyDeclaration_),
+            'propertyCases' : self.generatePropertyCases(func),
             'propertyGet' : func.parameterList().generate(self.propertyGet_),
             'propertySet' : func.parameterList().generate(self.propertySet_),
             'propertyInsert' : func.parameterList().generate(self.propertyInsert_),
@@ -152,6 +191,7 @@ class ValueObjects(addin.Addin):
             'constructorParList' : func.parameterList().generate(self.constructorDeclaration_),
             'functionName' : func.name(),
             'propertyDeclaration' : func.parameterList().generate(self.propertyDeclaration_),
+            'propertyCases' : self.generatePropertyCases(func),
             'propertyGet' : func.parameterList().generate(self.propertyGet_),
             'propertySet' : func.parameterList().generate(self.propertySet_),
             'populateObjectIDs' : func.parameterList().generate(self.populateObjectIDs_) })
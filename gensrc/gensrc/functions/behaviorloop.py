@@ -45,12 +45,17 @@ class BehaviorLoop(object):
             functionSignature = '(' + environment.config().namespaceObjects() + '::' + self.functionSignature_ + ')'
         else:
             functionSignature = ''
+        if self.func_.threadSafe():
+            loopFunction = 'parallelLoop'
+        else:
+            loopFunction = 'loop'
         addin.bufferLoop().set({
             'inputList' : self.func_.parameterList().generate(addin.loopInputs()),
             'inputParam' : addin.loopName(self.loopParamRef_),
             'functionCodeName' : self.functionCodeName_,
             'functionName' : self.functionName_,
             'functionSignature' : functionSignature,
+            'loopFunction' : loopFunction,
             'inputType' : addin.loopReturnType().apply(self.loopParamRef_),
             'returnType' : addin.loopReturnType().apply(self.func_.returnValue()) })
         return addin.bufferLoop().text()
@@ -67,6 +67,11 @@ class Constructor(function.Function):
         """Return the name of the Processor class which implements post
         serialization logic for objects of this class."""
         return self.processorName_
+
+    def refresh(self):
+        """Return True if objects of this class can be updated in place
+        by Object::refresh() rather than recreated."""
+        return self.refresh_
         
     #############################################
     # serializer interface
@@ -78,6 +83,7 @@ class Constructor(function.Function):
         serializer.serializeProperty(self, common.LIBRARY_FUNCTION)
         serializer.serializeAttributeBoolean(self, common.CONST)
         serializer.serializeProperty(self, common.PROCESSOR_NAME, "")
+        serializer.serializeBoolean(self, common.REFRESH)
 
     def postSerialize(self):
         """Perform post serialization initialization."""
@@ -78,3 +78,46 @@ but the return value is not a vector."""
         self.value_ = BehaviorReturnNonVectorException.BEHAVIOR_RETURN_NON_VECTOR_ERROR % {
             'functionName' : functionName }
 
+class BehaviorBatchLoopException(FunctionException):
+    """Batch variant requested for a function which loops."""
+
+    BEHAVIOR_BATCH_LOOP_ERROR = """
+Error processing function %(functionName)s -
+Function has been configured to generate a batch variant,
+but it also loops on parameter "%(loopParameterName)s".
+Batch variants are not supported for looping functions."""
+
+    def __init__(self, functionName, loopParameterName):
+        """Initialize the BehaviorBatchLoopException object."""
+        self.value_ = BehaviorBatchLoopException.BEHAVIOR_BATCH_LOOP_ERROR % {
+            'functionName' : functionName,
+            'loopParameterName' : loopParameterName }
+
+class BehaviorBatchReturnException(FunctionException):
+    """Batch function return value is not a scalar."""
+
+    BEHAVIOR_BATCH_RETURN_ERROR = """
+Error processing function %(functionName)s -
+Function has been configured to generate a batch variant,
+but the return value is not a scalar."""
+
+    def __init__(self, functionName):
+        """Initialize the BehaviorBatchReturnException object."""
+        self.value_ = BehaviorBatchReturnException.BEHAVIOR_BATCH_RETURN_ERROR % {
+            'functionName' : functionName }
+
+class BehaviorBatchObjectException(FunctionException):
+    """Batch variant cannot retrieve objects of the given type."""
+
+    BEHAVIOR_BATCH_OBJECT_ERROR = """
+Error processing function %(functionName)s -
+Function has been configured to generate a batch variant,
+but there is no rule for retrieving a batch of objects of type "%(typeName)s"
+on platform %(platformName)s."""
+
+    def __init__(self, functionName, typeName, platformName):
+        """Initialize the BehaviorBatchObjectException object."""
+        self.value_ = BehaviorBatchObjectException.BEHAVIOR_BATCH_OBJECT_ERROR % {
+            'functionName' : functionName,
+            'typeName' : typeName,
+            'platformName' : platformName }
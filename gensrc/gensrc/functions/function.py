@@ -41,6 +41,8 @@ class Function(serializable.Serializable):
 
     groupName_ = 'Functions'
     loopParameter_ = None
+    batch_ = False
+    threadSafe_ = False
     enumeration_ = None
     generateVOs_ = False
     validatePermanent_ = ''
@@ -73,6 +75,23 @@ class Function(serializable.Serializable):
     def loopParameter(self):
         return self.loopParameter_
 
+    def batch(self):
+        """Return True if a batch variant of the function is to be generated.
+
+        Only Member functions support batch variants.  The batch variant
+        takes a vector of object IDs in place of the single ID and returns
+        a vector of results, one for each object.  The remaining inputs are
+        converted, and the objects retrieved, once for the whole batch."""
+        return self.batch_
+
+    def threadSafe(self):
+        """Return True if the function may be invoked concurrently.
+
+        Looping functions which are thread safe process the elements of
+        their input in parallel, see ObjectHandler::evaluateLoop().  The
+        attribute has no effect on functions which do not loop."""
+        return self.threadSafe_
+
     def returnValue(self):
         return self.returnValue_
 
@@ -127,3 +146,4 @@ class Function(serializable.Serializable):
         serializer.serializeBoolean(self, common.DOCUMENTATION_ONLY)
         serializer.serializeAttributeBoolean(self, common.DEPENDENCY_TRIGGER, True)
         serializer.serializeAttributeBoolean(self, 'visible', True)
+        serializer.serializeAttributeBoolean(self, common.THREAD_SAFE, False)
@@ -27,6 +27,7 @@ from gensrc.serialization import serializable
 from gensrc.functions import function
 from gensrc.functions import behavior
 from gensrc.functions import behaviorloop
+from gensrc.functions import exceptions
 from gensrc.parameters import parameterlist
 from gensrc.parameters import parameter
 from gensrc.configuration import environment
@@ -53,6 +54,11 @@ class Member(function.Function):
     def objectId(self):
         return self.objectId_
 
+    def objectIdParameter(self):
+        """Return the parameter holding the ID of the object on which the
+        function is invoked."""
+        return self.parameterList_.parameters()[0]
+
     #############################################
     # serializer interface
     #############################################
@@ -66,6 +72,7 @@ class Member(function.Function):
         serializer.serializeAttribute(self, common.LOOP_PARAMETER)
         serializer.serializeObject(self, parameter.ReturnValue)
         serializer.serializeAttributeBoolean(self, common.CONST, True)
+        serializer.serializeAttributeBoolean(self, common.BATCH, False)
 
     def postSerialize(self):
         """Perform post serialization initialization."""
@@ -85,3 +92,9 @@ class Member(function.Function):
             self.behavior_ = behaviorloop.BehaviorMemberLoop(self)
         else:
             self.behavior_ = behavior.BehaviorMember(self)
+
+        if self.batch_:
+            if self.loopParameter_:
+                raise exceptions.BehaviorBatchLoopException(self.name_, self.loopParameter_)
+            if self.returnValue_.tensorRank() != common.SCALAR:
+                raise exceptions.BehaviorBatchReturnException(self.name_)
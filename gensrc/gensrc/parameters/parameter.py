@@ -38,6 +38,7 @@ class Value(serializable.Serializable):
     loop_ = ''
     vectorIterator_ = ''
     lastParameter_ = False
+    propertyIndex_ = None
     ignore_ = False
     default_ = ''
     errorValue_ = ''
@@ -99,6 +100,11 @@ class Value(serializable.Serializable):
         in the list for the given function."""
         return self.lastParameter_
 
+    def propertyIndex(self):
+        """Return the position of this parameter among the system properties
+        of the corresponding ValueObject, or None if it is not a property."""
+        return self.propertyIndex_
+
     def errorValue(self):
         """Return the value, if any, to be substituted for this parameter
         if the original value is erroneous."""
@@ -109,6 +115,11 @@ class Value(serializable.Serializable):
         in the list for the given function."""
         self.lastParameter_ = val
 
+    def setPropertyIndex(self, val):
+        """Set the position of this parameter among the system properties
+        of the corresponding ValueObject."""
+        self.propertyIndex_ = val
+
     def setLoop(self, val):
         """Set the boolean value indicating whether this parameter is configured
         as the loop parameter for the function."""
@@ -39,14 +39,20 @@ class ParameterList(serializable.Serializable):
     # public interface
     #############################################
 
-    def generate(self, ruleGroup):
-        """Generate source code relating to a list of function parameters."""
+    def generate(self, ruleGroup, skipFirst = False):
+        """Generate source code relating to a list of function parameters.
+
+        If skipFirst is True then the first parameter of a Member function,
+        the object ID, is omitted even if the RuleGroup does not check for
+        it.  This is used for batch variants, which retrieve the objects
+        separately."""
         codeItems = []
         firstItem = True
+        self.setPropertyIndexes()
         for param in self.parameters_:
             if firstItem:
                 firstItem = False
-                if ruleGroup.checkSkipFirst() and self.skipFirst_: continue
+                if (skipFirst or ruleGroup.checkSkipFirst()) and self.skipFirst_: continue
             ruleResult = ruleGroup.apply(param)
             if ruleResult:
                 codeItems.append(ruleResult)
@@ -56,6 +62,31 @@ class ParameterList(serializable.Serializable):
             code = ruleGroup.wrapText() % code
         return code
 
+    def setPropertyIndexes(self):
+        """Number the parameters which are stored as system properties of
+        the ValueObject.  Positions 0 and 1 are the object ID and the class
+        name, the remaining properties follow in the order of the list,
+        excluding parameters with the "ignore" flag set to true."""
+        index = 2
+        for param in self.parameters_:
+            if self.skipFirst_ and param is self.parameters_[0]:
+                param.setPropertyIndex(0)
+            elif param.ignore():
+                param.setPropertyIndex(None)
+            else:
+                param.setPropertyIndex(index)
+                index += 1
+
+    def properties(self):
+        """Return the parameters which are stored as system properties of
+        the ValueObject, excluding the object ID."""
+        self.setPropertyIndexes()
+        ret = []
+        for param in self.parameters_:
+            if param.propertyIndex():
+                ret.append(param)
+        return ret
+
     def prepend(self, param):
         """Prepend a parameter to the list."""
         if self.parameterCount_ == 0:
@@ -23,6 +23,7 @@
 ADDIN_INCLUDES = 'addinIncludes'
 ALIAS = 'alias'
 ANY = 'any'
+BATCH = 'batch'
 BEGIN = 'begin'
 BEGIN_END = 'beginAndEnd'
 BOOL = 'bool'
@@ -85,7 +86,9 @@ OBJECT_REFERENCE = 'objectReference'
 OTHER = 'other'
 PAD_LAST_PARAM = 'padLastParamDesc'
 PROCESSOR_NAME = 'processorName'
+PROPERTY_INDEX = 'propertyIndex'
 REFERENCE = 'reference'
+REFRESH = 'refresh'
 ROOT_DIRECTORY = 'rootDirectory'
 SCALAR = 'scalar'
 SERIALIZATION_INCLUDES = 'serializationIncludes'
@@ -93,6 +96,7 @@ STRING = 'string'
 STUB = 'stub'
 SUPER_TYPE = 'superType'
 TENSOR_RANK = 'tensorRank'
+THREAD_SAFE = 'threadSafe'
 TRUE = 'true'
 TYPE = 'type'
 UNDERLYING_CLASS = 'underlyingClass'